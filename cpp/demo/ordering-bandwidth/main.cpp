@@ -0,0 +1,221 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/ordering.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+
+// Time a kernel (seconds per call, maximum over the ranks)
+double time_kernel(MPI_Comm comm, int repeats, const std::function<void()>& f)
+{
+  f();
+  MPI_Barrier(comm);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  double t = std::chrono::duration<double>(t1 - t0).count() / repeats;
+  double tmax = 0;
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return tmax;
+}
+
+// Create the graph of the 7-point stencil on an n x n x n grid of
+// points, and the point coordinates. The points are numbered in a
+// random order, as from an unstructured mesh generator.
+std::pair<graph::AdjacencyList<std::int32_t>, std::vector<double>>
+create_grid(std::int32_t n)
+{
+  const std::int32_t N = n * n * n;
+  std::vector<std::int32_t> p(N);
+  std::iota(p.begin(), p.end(), 0);
+  std::shuffle(p.begin(), p.end(), std::mt19937(0));
+
+  std::vector<std::vector<std::int32_t>> edges(N);
+  std::vector<double> x(3 * N);
+  for (std::int32_t k = 0; k < n; ++k)
+  {
+    for (std::int32_t j = 0; j < n; ++j)
+    {
+      for (std::int32_t i = 0; i < n; ++i)
+      {
+        const std::int32_t v = p[(k * n + j) * n + i];
+        x[3 * v + 0] = i;
+        x[3 * v + 1] = j;
+        x[3 * v + 2] = k;
+        const std::array<std::array<std::int32_t, 3>, 6> nbrs
+            = {{{i - 1, j, k},
+                {i + 1, j, k},
+                {i, j - 1, k},
+                {i, j + 1, k},
+                {i, j, k - 1},
+                {i, j, k + 1}}};
+        for (auto [a, b, c] : nbrs)
+        {
+          if (a >= 0 and a < n and b >= 0 and b < n and c >= 0 and c < n)
+            edges[v].push_back(p[(c * n + b) * n + a]);
+        }
+      }
+    }
+  }
+
+  return {graph::AdjacencyList<std::int32_t>(edges), std::move(x)};
+}
+
+/// This program measures how the numbering of the degrees-of-freedom
+/// affects the performance of sparse matrix kernels. The points of a
+/// structured grid are numbered randomly and then re-numbered by the
+/// graph orderings (reverse Cuthill-McKee and Gibbs-Poole-Stockmeyer)
+/// and by the Hilbert space-filling curve ordering. For each ordering
+/// the matrix bandwidth, the time to compute the ordering, the time
+/// and effective memory bandwidth of the matrix-vector product
+/// (MatrixCSR::mult) and the time to assemble the matrix from two-point
+/// 'element' matrices (MatrixCSR::add) are reported. Usage:
+/// demo_ordering-bandwidth [n], where each process owns an independent
+/// n^3 grid.
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const std::int32_t n = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int repeats = 10;
+
+    auto [graph, x] = create_grid(n);
+    const std::int32_t N = graph.num_nodes();
+    auto map = std::make_shared<common::IndexMap>(comm, N);
+
+    // Orderings to compare, as functions returning the new index of
+    // each point
+    using ordering_fn = std::function<std::vector<std::int32_t>()>;
+    std::vector<std::pair<std::string, ordering_fn>> orderings
+        = {{"Random",
+            [N]()
+            {
+              std::vector<std::int32_t> r(N);
+              std::iota(r.begin(), r.end(), 0);
+              return r;
+            }},
+           {"Reverse Cuthill-McKee",
+            [&graph]() { return graph::reorder_rcm(graph); }},
+           {"Gibbs-Poole-Stockmeyer",
+            [&graph]() { return graph::reorder_gps(graph); }},
+           {"Hilbert curve",
+            [&x]() { return graph::reorder_hilbert(x, 3); }}};
+
+    std::int64_t nnz = 0;
+    std::vector<std::array<double, 5>> results;
+    for (auto& [name, compute_ordering] : orderings)
+    {
+      std::vector<std::int32_t> perm;
+      const double t_order
+          = time_kernel(comm, 1, [&]() { perm = compute_ordering(); });
+
+      // Largest distance of a matrix entry from the diagonal
+      std::int32_t bw = 0;
+      for (std::int32_t v = 0; v < N; ++v)
+        for (std::int32_t w : graph.links(v))
+          bw = std::max(bw, std::abs(perm[v] - perm[w]));
+      MPI_Allreduce(MPI_IN_PLACE, &bw, 1, MPI_INT32_T, MPI_MAX, comm);
+
+      la::SparsityPattern sp(comm, {map, map}, {1, 1});
+      for (std::int32_t v = 0; v < N; ++v)
+      {
+        std::vector<std::int32_t> cols = {perm[v]};
+        for (std::int32_t w : graph.links(v))
+          cols.push_back(perm[w]);
+        sp.insert(std::span(&perm[v], 1), cols);
+      }
+      sp.assemble();
+      la::MatrixCSR<double> A(sp);
+
+      // Assemble the graph Laplacian from the edges, each contributing
+      // a 2 x 2 'element' matrix
+      const std::array<double, 4> Ae = {1.0, -1.0, -1.0, 1.0};
+      const double t_assemble = time_kernel(
+          comm, repeats,
+          [&]()
+          {
+            A.set(0.0);
+            for (std::int32_t v = 0; v < N; ++v)
+            {
+              for (std::int32_t w : graph.links(v))
+              {
+                if (w > v)
+                {
+                  const std::array<std::int32_t, 2> dofs
+                      = {perm[v], perm[w]};
+                  A.add(Ae, dofs, dofs);
+                }
+              }
+            }
+          });
+      A.finalize();
+
+      la::Vector<double> u(map, 1), y(map, 1);
+      std::span<double> _u = u.mutable_array();
+      for (std::int32_t v = 0; v < N; ++v)
+        _u[perm[v]] = x[3 * v] + 0.1 * x[3 * v + 1];
+      const double t_mult
+          = time_kernel(comm, repeats, [&]() { A.mult(u, y); });
+
+      // Matrix values and column indices, and the vectors u and y
+      std::int64_t nnz_local = A.row_ptr()[N];
+      std::int64_t bytes_local
+          = nnz_local * (sizeof(double) + sizeof(std::int32_t))
+            + 2 * N * sizeof(double);
+      std::int64_t bytes = 0;
+      MPI_Allreduce(&bytes_local, &bytes, 1, MPI_INT64_T, MPI_SUM, comm);
+      MPI_Allreduce(&nnz_local, &nnz, 1, MPI_INT64_T, MPI_SUM, comm);
+
+      results.push_back({double(bw), t_order, t_mult, bytes / t_mult * 1e-9,
+                         t_assemble});
+    }
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      std::cout << "Rows: " << map->size_global() << ", non-zeros: " << nnz
+                << std::endl;
+      std::cout << std::left << std::setw(26) << "Ordering" << std::setw(11)
+                << "Bandwidth" << std::setw(12) << "Order (ms)"
+                << std::setw(12) << "SpMV (ms)" << std::setw(14)
+                << "SpMV (GB/s)" << "Assembly (ms)" << std::endl;
+      for (std::size_t i = 0; i < orderings.size(); ++i)
+      {
+        auto [bw, t_order, t_mult, gbs, t_assemble] = results[i];
+        std::cout << std::left << std::setw(26) << orderings[i].first
+                  << std::setw(11) << bw << std::setw(12) << 1e3 * t_order
+                  << std::setw(12) << 1e3 * t_mult << std::setw(14) << gbs
+                  << 1e3 * t_assemble << std::endl;
+      }
+    }
+  }
+
+  MPI_Finalize();
+
+  return 0;
+}
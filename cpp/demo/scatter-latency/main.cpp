@@ -0,0 +1,114 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mpi.h>
+#include <vector>
+
+using namespace dolfinx;
+
+// Time a kernel (seconds per call, maximum over the ranks)
+double time_kernel(MPI_Comm comm, int repeats, const std::function<void()>& f)
+{
+  f();
+  MPI_Barrier(comm);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  double t = std::chrono::duration<double>(t1 - t0).count() / repeats;
+  double tmax = 0;
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return tmax;
+}
+
+/// This program measures the latency of a forward ghost scatter
+/// (la::Vector::scatter_fwd) as a function of the number of neighbours,
+/// for each communication backend of common::Scatterer, for persistent
+/// neighbourhood requests and for intra-node shared memory, and reports
+/// the backend selected by common::Scatterer::autotune. Usage:
+/// demo_scatter-latency [m [repeats]], where m is the number of ghosts
+/// per neighbour.
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const int rank = dolfinx::MPI::rank(comm);
+    const int size = dolfinx::MPI::size(comm);
+    const int m = argc > 1 ? std::atoi(argv[1]) : 8;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const std::int32_t size_local = std::max(64, 2 * m);
+
+    if (rank == 0)
+    {
+      std::cout << "Scatter latency (us)" << std::endl;
+      std::cout << std::left << std::setw(12) << "Neighbours"
+                << std::setw(12) << "Neighbour" << std::setw(12) << "P2P"
+                << std::setw(12) << "RMA" << std::setw(12) << "Persistent"
+                << std::setw(12) << "Shared" << "Autotune" << std::endl;
+    }
+
+    // Ghost m indices from each of the next k ranks (cyclic)
+    for (int k = 0; k < size; k = std::max(2 * k, k + 1))
+    {
+      std::vector<std::int64_t> ghosts;
+      std::vector<int> owners;
+      for (int j = 1; j <= k; ++j)
+      {
+        const int owner = (rank + j) % size;
+        for (int i = 0; i < m; ++i)
+        {
+          ghosts.push_back(std::int64_t(owner) * size_local + i);
+          owners.push_back(owner);
+        }
+      }
+
+      auto map = std::make_shared<common::IndexMap>(comm, size_local, ghosts,
+                                                    owners);
+      using type = common::Scatterer::type;
+      std::vector<la::Vector<double>> x;
+      x.reserve(5);
+      for (type t : {type::neighbor, type::p2p, type::rma, type::neighbor})
+        x.emplace_back(map, 1, t);
+      x.back().set_persistent_requests(true);
+      x.emplace_back(map, 1, type::neighbor, true);
+
+      std::vector<double> times;
+      for (auto& v : x)
+      {
+        v.set(1.0);
+        times.push_back(
+            time_kernel(comm, repeats, [&v]() { v.scatter_fwd(); }));
+      }
+
+      const type best = common::Scatterer::autotune(*map, 1);
+      if (rank == 0)
+      {
+        std::cout << std::left << std::setw(12) << k;
+        for (double t : times)
+          std::cout << std::setw(12) << 1e6 * t;
+        std::cout << (best == type::neighbor ? "neighbour"
+                      : best == type::p2p    ? "p2p"
+                                             : "rma")
+                  << std::endl;
+      }
+    }
+  }
+
+  MPI_Finalize();
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/la/petsc.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mpi.h>
+#include <petscmat.h>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+
+// Time a kernel (seconds per call, maximum over the ranks)
+double time_kernel(MPI_Comm comm, int repeats, const std::function<void()>& f)
+{
+  f();
+  MPI_Barrier(comm);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  double t = std::chrono::duration<double>(t1 - t0).count() / repeats;
+  double tmax = 0;
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return tmax;
+}
+
+// Create the 7-point Laplacian on an n x n x (n * size) grid of
+// points, distributed in slabs of n planes with the neighbouring planes
+// as ghosts
+la::MatrixCSR<PetscScalar> create_laplacian(MPI_Comm comm, std::int64_t n)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  const std::int64_t plane = n * n;
+  const std::int64_t offset = rank * n * plane;
+
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  if (rank > 0)
+  {
+    for (std::int64_t i = 0; i < plane; ++i)
+      ghosts.push_back(offset - plane + i);
+    owners.insert(owners.end(), plane, rank - 1);
+  }
+  if (rank < size - 1)
+  {
+    for (std::int64_t i = 0; i < plane; ++i)
+      ghosts.push_back(offset + n * plane + i);
+    owners.insert(owners.end(), plane, rank + 1);
+  }
+  auto map = std::make_shared<common::IndexMap>(comm, n * plane, ghosts,
+                                                owners);
+
+  // Local index of a global point index (owned or ghost)
+  auto local = [&](std::int64_t g) -> std::int32_t
+  {
+    if (g >= offset and g < offset + n * plane)
+      return g - offset;
+    else if (g < offset)
+      return n * plane + (g - offset + plane);
+    else
+      return n * plane + (rank > 0 ? plane : 0) + (g - offset - n * plane);
+  };
+
+  // Global indices of the stencil of an owned point
+  const std::int64_t nz = n * size;
+  auto stencil = [&](std::int64_t g)
+  {
+    const std::int64_t i = g % n, j = (g / n) % n, k = g / plane;
+    std::vector<std::int64_t> s = {g};
+    if (i > 0)
+      s.push_back(g - 1);
+    if (i < n - 1)
+      s.push_back(g + 1);
+    if (j > 0)
+      s.push_back(g - n);
+    if (j < n - 1)
+      s.push_back(g + n);
+    if (k > 0)
+      s.push_back(g - plane);
+    if (k < nz - 1)
+      s.push_back(g + plane);
+    return s;
+  };
+
+  la::SparsityPattern sp(comm, {map, map}, {1, 1});
+  for (std::int64_t g = offset; g < offset + n * plane; ++g)
+  {
+    std::vector<std::int32_t> cols;
+    for (std::int64_t c : stencil(g))
+      cols.push_back(local(c));
+    const std::int32_t row = local(g);
+    sp.insert(std::span(&row, 1), cols);
+  }
+  sp.assemble();
+
+  la::MatrixCSR<PetscScalar> A(sp);
+  for (std::int64_t g = offset; g < offset + n * plane; ++g)
+  {
+    const std::int32_t row = local(g);
+    for (std::int64_t c : stencil(g))
+    {
+      const std::int32_t col = local(c);
+      const PetscScalar v = c == g ? 6.0 : -1.0;
+      A.set(std::span(&v, 1), std::span(&row, 1), std::span(&col, 1));
+    }
+  }
+  A.finalize();
+  return A;
+}
+
+/// This program compares the distributed matrix-vector product of
+/// la::MatrixCSR (MatrixCSR::mult), with one or more threads, with
+/// PETSc MatMult on a MATMPIAIJ matrix with the same sparsity (created
+/// by la::petsc::MatrixCSRWrapper), and reports the time per product
+/// and the effective memory bandwidth. Usage: demo_spmv-petsc [n
+/// [threads]], where each process owns n^3 rows of a 7-point Laplacian.
+int main(int argc, char* argv[])
+{
+  PetscInitialize(&argc, &argv, nullptr, nullptr);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const std::int64_t n = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int max_threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    const int repeats = 20;
+
+    la::MatrixCSR<PetscScalar> A = create_laplacian(comm, n);
+    auto map = A.index_maps()[0];
+    la::Vector<PetscScalar> x(map, 1), y(map, 1), z(map, 1);
+    std::span<PetscScalar> _x = x.mutable_array();
+    for (std::size_t i = 0; i < _x.size(); ++i)
+      _x[i] = 1.0 + 1e-3 * (i % 17);
+
+    la::petsc::MatrixCSRWrapper W(A);
+    Vec _xp = la::petsc::create_vector_wrap(x);
+    Vec _yp = la::petsc::create_vector_wrap(z);
+
+    // Matrix values and column indices, and the vectors x and y
+    const std::int32_t num_rows = A.num_owned_rows();
+    const std::int64_t nnz = A.row_ptr()[num_rows];
+    std::int64_t bytes_local
+        = nnz * (sizeof(PetscScalar) + sizeof(std::int32_t))
+          + 2 * num_rows * sizeof(PetscScalar);
+    std::int64_t bytes = 0;
+    MPI_Allreduce(&bytes_local, &bytes, 1, MPI_INT64_T, MPI_SUM, comm);
+
+    std::vector<std::pair<std::string, double>> results;
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+      results.emplace_back(
+          "MatrixCSR::mult (" + std::to_string(num_threads) + " threads)",
+          time_kernel(comm, repeats,
+                      [&]() { A.mult(x, y, num_threads); }));
+    }
+    results.emplace_back(
+        "PETSc MatMult",
+        time_kernel(comm, repeats, [&]() { MatMult(W.mat(), _xp, _yp); }));
+
+    // Check that the products agree
+    double diff = 0;
+    for (std::int32_t i = 0; i < num_rows; ++i)
+      diff = std::max(diff, std::abs(y.array()[i] - z.array()[i]));
+    MPI_Allreduce(MPI_IN_PLACE, &diff, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      std::cout << "Rows: " << map->size_global() << ", max difference "
+                << diff << std::endl;
+      std::cout << std::left << std::setw(32) << "Product" << std::setw(14)
+                << "Time (ms)" << "Bandwidth (GB/s)" << std::endl;
+      for (auto& [name, t] : results)
+      {
+        std::cout << std::left << std::setw(32) << name << std::setw(14)
+                  << 1e3 * t << bytes / t * 1e-9 << std::endl;
+      }
+    }
+
+    VecDestroy(&_xp);
+    VecDestroy(&_yp);
+  }
+
+  PetscFinalize();
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdlib>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+using namespace dolfinx;
+
+// Time a kernel (seconds per call, maximum over the ranks)
+double time_kernel(MPI_Comm comm, int repeats, const std::function<void()>& f)
+{
+  f();
+  MPI_Barrier(comm);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  double t = std::chrono::duration<double>(t1 - t0).count() / repeats;
+  double tmax = 0;
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return tmax;
+}
+
+/// This program measures the memory bandwidth of the vector kernels in
+/// a conjugate gradient iteration, comparing one pass per operation
+/// with the fused kernels. Usage: demo_vector-bandwidth [n [threads]],
+/// where n is the vector size per process.
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const std::int32_t n = argc > 1 ? std::atoi(argv[1]) : 4000000;
+    const int num_threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    const int repeats = 20;
+
+    auto map = std::make_shared<common::IndexMap>(comm, n);
+    la::Vector<double> x(map, 1), p(map, 1), q(map, 1), r(map, 1);
+    std::vector<la::Vector<double>> basis(4, la::Vector<double>(map, 1));
+    for (auto v : {&x, &p, &q, &r})
+      v->set(1.0);
+    for (auto& v : basis)
+      v.set(0.5);
+    const double alpha = 1e-8;
+
+    // Each kernel: name, time and number of vectors read/written
+    std::vector<std::tuple<std::string, double, int>> results;
+
+    // CG update, one pass per operation: x += alpha p, r -= alpha q,
+    // (r, r)
+    results.emplace_back(
+        "CG update (separate)",
+        time_kernel(comm, repeats,
+                    [&]()
+                    {
+                      std::span<double> _x = x.mutable_array();
+                      std::span<double> _r = r.mutable_array();
+                      std::transform(_x.begin(), _x.end(),
+                                     p.array().begin(), _x.begin(),
+                                     [alpha](auto x, auto p)
+                                     { return x + alpha * p; });
+                      std::transform(_r.begin(), _r.end(),
+                                     q.array().begin(), _r.begin(),
+                                     [alpha](auto r, auto q)
+                                     { return r - alpha * q; });
+                      [[maybe_unused]] double rr = la::inner_product(r, r);
+                    }),
+        7);
+
+    // Fused CG update: axpy and axpy_dot
+    results.emplace_back(
+        "CG update (fused)",
+        time_kernel(comm, repeats,
+                    [&]()
+                    {
+                      la::axpy(x, alpha, p, num_threads);
+                      [[maybe_unused]] double rr
+                          = la::axpy_dot(r, -alpha, q, r, num_threads);
+                    }),
+        6);
+
+    // Search direction update p = r + beta p
+    results.emplace_back("waxpby",
+                         time_kernel(comm, repeats,
+                                     [&]() {
+                                       la::waxpby(p, 1.0, r, 1e-3, p,
+                                                  num_threads);
+                                     }),
+                         3);
+
+    // Multi-axpy with four vectors, versus four axpy
+    const std::vector<double> coeffs(basis.size(), alpha);
+    std::vector<const la::Vector<double>*> basis_ptr;
+    for (auto& v : basis)
+      basis_ptr.push_back(&v);
+    results.emplace_back("4 x axpy",
+                         time_kernel(comm, repeats,
+                                     [&]()
+                                     {
+                                       for (auto& v : basis)
+                                         la::axpy(x, alpha, v, num_threads);
+                                     }),
+                         12);
+    results.emplace_back(
+        "maxpy (4 vectors)",
+        time_kernel(
+            comm, repeats,
+            [&]()
+            {
+              la::maxpy(x, std::span<const double>(coeffs),
+                        std::span<const la::Vector<double>* const>(basis_ptr),
+                        num_threads);
+            }),
+        6);
+
+    // Norms of four vectors, separate and combined
+    results.emplace_back("4 x norm",
+                         time_kernel(comm, repeats,
+                                     [&]()
+                                     {
+                                       for (auto& v : basis)
+                                         la::norm(v);
+                                     }),
+                         4);
+    results.emplace_back(
+        "norms (4 vectors)",
+        time_kernel(comm, repeats,
+                    [&]()
+                    {
+                      la::norms(std::span<const la::Vector<double>* const>(
+                          basis_ptr));
+                    }),
+        4);
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      const double size = dolfinx::MPI::size(comm);
+      std::cout << std::left << std::setw(24) << "Kernel" << std::setw(14)
+                << "Time (ms)" << "Bandwidth (GB/s)" << std::endl;
+      for (auto& [name, t, num_vectors] : results)
+      {
+        const double bytes = size * n * num_vectors * sizeof(double);
+        std::cout << std::left << std::setw(24) << name << std::setw(14)
+                  << 1e3 * t << bytes / t * 1e-9 << std::endl;
+      }
+    }
+  }
+
+  MPI_Finalize();
+
+  return 0;
+}
@@ -5,8 +5,10 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "IndexMap.h"
+#include "Timer.h"
 #include "sort.h"
 #include <algorithm>
+#include <bit>
 #include <functional>
 #include <numeric>
 
@@ -15,19 +17,87 @@ using namespace dolfinx::common;
 
 namespace
 {
+/// Compute the sorted set of unique ranks in `owners`. If there are
+/// more owners than ranks in `comm`, the ranks are marked in an array
+/// of length equal to the communicator size, which avoids sorting a
+/// (possibly very long) list of owners.
+std::vector<int> unique_ranks(MPI_Comm comm,
+                              const std::span<const int>& owners)
+{
+  const int size = dolfinx::MPI::size(comm);
+  if (owners.size() > static_cast<std::size_t>(size))
+  {
+    std::vector<std::int8_t> marker(size, false);
+    for (int r : owners)
+      marker[r] = true;
+    std::vector<int> ranks;
+    for (int r = 0; r < size; ++r)
+      if (marker[r])
+        ranks.push_back(r);
+    return ranks;
+  }
+  else
+  {
+    std::vector<int> ranks(owners.begin(), owners.end());
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    return ranks;
+  }
+}
+
 std::array<std::vector<int>, 2>
 build_src_dest(MPI_Comm comm, const std::span<const int>& owners)
 {
-  std::vector<int> src(owners.begin(), owners.end());
-  std::sort(src.begin(), src.end());
-  src.erase(std::unique(src.begin(), src.end()), src.end());
-  src.shrink_to_fit();
+  common::Timer timer("IndexMap: compute src and dest ranks");
 
+  std::vector<int> src = unique_ranks(comm, owners);
   std::vector<int> dest = dolfinx::MPI::compute_graph_edges_nbx(comm, src);
   std::sort(dest.begin(), dest.end());
 
   return {std::move(src), std::move(dest)};
 }
+
+/// Hash function for global indices, using Fibonacci hashing. The
+/// (well-mixed) high bits of the product are used as the table slot.
+/// @param[in] key The global index
+/// @param[in] shift 64 minus the log2 of the table size
+std::size_t hash_index(std::int64_t key, int shift)
+{
+  return (static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> shift;
+}
+
+/// Build an open-addressing hash table from ghost global index to
+/// ghost position. The table size is a power of two, with load factor
+/// at most 1/2.
+/// @param[in] ghosts The ghost global indices
+/// @param[out] keys The global index in each slot (-1 for empty slots)
+/// @param[out] pos The ghost position in each slot
+void build_ghost_hash_table(const std::span<const std::int64_t>& ghosts,
+                            std::vector<std::int64_t>& keys,
+                            std::vector<std::int32_t>& pos)
+{
+  if (ghosts.empty())
+    return;
+
+  const std::size_t capacity = std::bit_ceil(2 * ghosts.size());
+  const int shift = 64 - std::countr_zero(capacity);
+  keys.assign(capacity, -1);
+  pos.resize(capacity);
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+  {
+    // Find the first empty slot, keeping the first position of a
+    // repeated index
+    std::size_t slot = hash_index(ghosts[i], shift);
+    while (keys[slot] != -1 and keys[slot] != ghosts[i])
+      slot = (slot + 1) & (capacity - 1);
+
+    if (keys[slot] == -1)
+    {
+      keys[slot] = ghosts[i];
+      pos[slot] = i;
+    }
+  }
+}
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -356,6 +426,34 @@ IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size,
   MPI_Wait(&request, MPI_STATUS_IGNORE);
 }
 //-----------------------------------------------------------------------------
+IndexMap::IndexMap(IndexMap&& map)
+    : _local_range(map._local_range), _size_global(map._size_global),
+      _comm(std::move(map._comm)), _ghosts(std::move(map._ghosts)),
+      _owners(std::move(map._owners)), _src(std::move(map._src)),
+      _dest(std::move(map._dest)), _overlapping(map._overlapping),
+      _ghost_table(std::exchange(map._ghost_table,
+                                 std::make_unique<GhostHashTable>()))
+{
+}
+//-----------------------------------------------------------------------------
+IndexMap& IndexMap::operator=(IndexMap&& map)
+{
+  if (this != &map)
+  {
+    _local_range = map._local_range;
+    _size_global = map._size_global;
+    _comm = std::move(map._comm);
+    _ghosts = std::move(map._ghosts);
+    _owners = std::move(map._owners);
+    _src = std::move(map._src);
+    _dest = std::move(map._dest);
+    _overlapping = map._overlapping;
+    _ghost_table
+        = std::exchange(map._ghost_table, std::make_unique<GhostHashTable>());
+  }
+  return *this;
+}
+//-----------------------------------------------------------------------------
 std::array<std::int64_t, 2> IndexMap::local_range() const noexcept
 {
   return _local_range;
@@ -399,25 +497,33 @@ void IndexMap::global_to_local(const std::span<const std::int64_t>& global,
 {
   const std::int32_t local_size = _local_range[1] - _local_range[0];
 
-  std::vector<std::pair<std::int64_t, std::int32_t>> global_local_ghosts(
-      _ghosts.size());
-  for (std::size_t i = 0; i < _ghosts.size(); ++i)
-    global_local_ghosts[i] = {_ghosts[i], i + local_size};
-  std::map<std::int64_t, std::int32_t> global_to_local(
-      global_local_ghosts.begin(), global_local_ghosts.end());
+  // Build the ghost hash table on first use
+  GhostHashTable& table = *_ghost_table;
+  std::call_once(table.built,
+                 [this, &table]()
+                 { build_ghost_hash_table(_ghosts, table.keys, table.pos); });
 
-  std::transform(global.begin(), global.end(), local.begin(),
-                 [range = _local_range,
-                  &global_to_local](std::int64_t index) -> std::int32_t
-                 {
-                   if (index >= range[0] and index < range[1])
-                     return index - range[0];
-                   else
-                   {
-                     auto it = global_to_local.find(index);
-                     return it != global_to_local.end() ? it->second : -1;
-                   }
-                 });
+  const std::size_t capacity = table.keys.size();
+  const int shift = capacity > 0 ? 64 - std::countr_zero(capacity) : 0;
+  std::transform(
+      global.begin(), global.end(), local.begin(),
+      [range = _local_range, local_size, capacity, shift, &keys = table.keys,
+       &pos = table.pos](std::int64_t index) -> std::int32_t
+      {
+        if (index >= range[0] and index < range[1])
+          return index - range[0];
+        else if (capacity > 0 and index >= 0)
+        {
+          std::size_t slot = hash_index(index, shift);
+          while (keys[slot] != -1)
+          {
+            if (keys[slot] == index)
+              return local_size + pos[slot];
+            slot = (slot + 1) & (capacity - 1);
+          }
+        }
+        return -1;
+      });
 }
 //-----------------------------------------------------------------------------
 std::vector<std::int64_t> IndexMap::global_indices() const
@@ -605,12 +711,9 @@ graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
 {
   const std::int64_t offset = _local_range[0];
 
-  // Build lists of src and dest ranks
-  std::vector<int> src = _owners;
-  std::sort(src.begin(), src.end());
-  src.erase(std::unique(src.begin(), src.end()), src.end());
-  auto dest = dolfinx::MPI::compute_graph_edges_nbx(_comm.comm(), src);
-  std::sort(dest.begin(), dest.end());
+  // Lists of src and dest ranks
+  const std::vector<int>& src = _src;
+  const std::vector<int>& dest = _dest;
 
   // Array (local idx, ghosting rank) pairs for owned indices
   std::vector<std::pair<std::int32_t, int>> idx_to_rank;
@@ -853,8 +956,14 @@ std::vector<std::int32_t> IndexMap::shared_indices() const
     }
   }
 
-  auto dest = dolfinx::MPI::compute_graph_edges_nbx(_comm.comm(), src);
-  std::sort(dest.begin(), dest.end());
+  // The src ranks are the unique ghost owners, i.e. the same as _src,
+  // so the stored dest ranks can be used
+  if (src != _src)
+  {
+    throw std::runtime_error(
+        "IndexMap src ranks are not the owners of the ghost indices.");
+  }
+  const std::vector<int>& dest = _dest;
 
   // Create ghost -> owner comm
   MPI_Comm comm;
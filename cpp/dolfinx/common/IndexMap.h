@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
 #include <memory>
+#include <mutex>
 #include <span>
 #include <utility>
 #include <vector>
@@ -120,13 +121,13 @@ public:
   IndexMap(const IndexMap& map) = delete;
 
   /// Move constructor
-  IndexMap(IndexMap&& map) = default;
+  IndexMap(IndexMap&& map);
 
   /// Destructor
   ~IndexMap() = default;
 
   /// Move assignment
-  IndexMap& operator=(IndexMap&& map) = default;
+  IndexMap& operator=(IndexMap&& map);
 
   // Copy assignment
   IndexMap& operator=(const IndexMap& map) = delete;
@@ -157,7 +158,11 @@ public:
   void local_to_global(const std::span<const std::int32_t>& local,
                        const std::span<std::int64_t>& global) const;
 
-  /// @brief Compute local indices for array of global indices
+  /// @brief Compute local indices for array of global indices.
+  ///
+  /// Ghost indices are found using a hash table that is built when the
+  /// map is created. This function is thread-safe.
+  ///
   /// @param[in] global Global indices
   /// @param[out] local The local of the corresponding global index in
   /// 'global'. Returns -1 if the local index does not exist on this
@@ -254,5 +259,17 @@ private:
 
   // True if map has overlaps (ghosts)
   bool _overlapping;
+
+  // Open-addressing hash table (linear probing) from ghost global
+  // index to ghost position, used by global_to_local. Empty slots have
+  // key -1. The table is built on first use.
+  struct GhostHashTable
+  {
+    std::once_flag built;
+    std::vector<std::int64_t> keys;
+    std::vector<std::int32_t> pos;
+  };
+  std::unique_ptr<GhostHashTable> _ghost_table
+      = std::make_unique<GhostHashTable>();
 };
 } // namespace dolfinx::common
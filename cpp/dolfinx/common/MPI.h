@@ -31,7 +31,8 @@ namespace dolfinx::MPI
 enum class tag : int
 {
   consensus_pcx,
-  consensus_pex
+  consensus_pex,
+  neighbor_p2p
 };
 
 /// A duplicate MPI communicator and manage lifetime of the
@@ -256,6 +257,35 @@ std::vector<T> distribute_data(MPI_Comm comm,
                                const std::span<const std::int64_t>& indices,
                                const std::span<const T>& x, int shape1);
 
+/// @brief Create persistent requests for a neighbourhood all-to-all
+/// exchange with fixed buffers, sizes and displacements.
+///
+/// If the MPI implementation supports MPI-4, a single persistent
+/// neighbourhood collective request (`MPI_Neighbor_alltoallv_init`) is
+/// created. Otherwise persistent point-to-point requests are created,
+/// one receive per in-edge followed by one send per out-edge. The
+/// requests are started with `MPI_Startall` and completed with
+/// `MPI_Waitall`, and must be freed by the caller with
+/// `MPI_Request_free`. The buffers and the size and displacement arrays
+/// must not be destroyed before the requests are freed.
+///
+/// @note Collective over the neighbourhood if MPI-4 is supported
+/// @param[in] send_buffer Data to send
+/// @param[in] send_sizes Number of values to send to each out-edge
+/// @param[in] send_disp Displacement in `send_buffer` for each out-edge
+/// @param[in] recv_buffer Buffer for the received data
+/// @param[in] recv_sizes Number of values received from each in-edge
+/// @param[in] recv_disp Displacement in `recv_buffer` for each in-edge
+/// @param[in] comm Neighbourhood communicator, created with
+/// `MPI_Dist_graph_create_adjacent`
+/// @return The persistent requests
+template <typename T>
+std::vector<MPI_Request>
+neighbor_alltoallv_init(const T* send_buffer, const int* send_sizes,
+                        const int* send_disp, T* recv_buffer,
+                        const int* recv_sizes, const int* recv_disp,
+                        MPI_Comm comm);
+
 template <typename T>
 struct dependent_false : std::false_type
 {
@@ -659,5 +689,46 @@ std::vector<T> distribute_data(MPI_Comm comm,
                                     rank_offset);
 }
 //---------------------------------------------------------------------------
+template <typename T>
+std::vector<MPI_Request>
+neighbor_alltoallv_init(const T* send_buffer, const int* send_sizes,
+                        const int* send_disp, T* recv_buffer,
+                        const int* recv_sizes, const int* recv_disp,
+                        MPI_Comm comm)
+{
+#if MPI_VERSION >= 4
+  std::vector<MPI_Request> requests(1);
+  MPI_Neighbor_alltoallv_init(send_buffer, send_sizes, send_disp,
+                              dolfinx::MPI::mpi_type<T>(), recv_buffer,
+                              recv_sizes, recv_disp,
+                              dolfinx::MPI::mpi_type<T>(), comm,
+                              MPI_INFO_NULL, &requests.front());
+  return requests;
+#else
+  int indegree(-1), outdegree(-2), weighted(-1);
+  MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
+  std::vector<int> src(indegree), dest(outdegree);
+  MPI_Dist_graph_neighbors(comm, indegree, src.data(), MPI_UNWEIGHTED,
+                           outdegree, dest.data(), MPI_UNWEIGHTED);
+
+  // Receives are posted (started) before sends
+  std::vector<MPI_Request> requests(indegree + outdegree);
+  const int tag = static_cast<int>(MPI::tag::neighbor_p2p);
+  for (int i = 0; i < indegree; ++i)
+  {
+    MPI_Recv_init(recv_buffer + recv_disp[i], recv_sizes[i],
+                  dolfinx::MPI::mpi_type<T>(), src[i], tag, comm,
+                  &requests[i]);
+  }
+  for (int i = 0; i < outdegree; ++i)
+  {
+    MPI_Send_init(send_buffer + send_disp[i], send_sizes[i],
+                  dolfinx::MPI::mpi_type<T>(), dest[i], tag, comm,
+                  &requests[indegree + i]);
+  }
+  return requests;
+#endif
+}
+//---------------------------------------------------------------------------
 
 } // namespace dolfinx::MPI
@@ -8,15 +8,77 @@
 #include "IndexMap.h"
 #include "sort.h"
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <mpi.h>
 #include <numeric>
 
 using namespace dolfinx;
 using namespace dolfinx::common;
 
+namespace
+{
+//-----------------------------------------------------------------------------
+// Create a group with the given ranks (in comm)
+MPI_Group create_group(MPI_Comm comm, const std::vector<int>& ranks)
+{
+  MPI_Group group, subgroup;
+  MPI_Comm_group(comm, &group);
+  MPI_Group_incl(group, ranks.size(), ranks.data(), &subgroup);
+  MPI_Group_free(&group);
+  return subgroup;
+}
+//-----------------------------------------------------------------------------
+// Compute the contiguous runs (start, length) of an index array. An
+// empty array is returned if the mean run length is short, in which
+// case copying by run has no advantage over indexed access.
+std::vector<std::array<std::int32_t, 2>>
+compute_runs(const std::vector<std::int32_t>& indices)
+{
+  std::vector<std::array<std::int32_t, 2>> runs;
+  for (std::int32_t idx : indices)
+  {
+    if (!runs.empty() and idx == runs.back()[0] + runs.back()[1])
+      ++runs.back()[1];
+    else
+      runs.push_back({idx, 1});
+  }
+
+  constexpr std::size_t min_mean_run_length = 4;
+  if (runs.size() * min_mean_run_length > indices.size())
+    return {};
+  else
+    return runs;
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+Scatterer::Window::~Window()
+{
+  if (win != MPI_WIN_NULL)
+    MPI_Win_free(&win);
+  for (MPI_Group* group : {&exposure, &access})
+  {
+    if (*group != MPI_GROUP_NULL)
+      MPI_Group_free(group);
+  }
+}
+//-----------------------------------------------------------------------------
+Scatterer::SharedMemory::~SharedMemory()
+{
+  if (win != MPI_WIN_NULL)
+  {
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+  }
+  if (comm != MPI_COMM_NULL)
+    MPI_Comm_free(&comm);
+}
 //-----------------------------------------------------------------------------
-Scatterer::Scatterer(const IndexMap& map, int bs)
-    : _bs(bs), _comm0(MPI_COMM_NULL), _comm1(MPI_COMM_NULL)
+Scatterer::Scatterer(const IndexMap& map, int bs, type type,
+                     bool shared_memory)
+    : _bs(bs), _type(type), _comm0(MPI_COMM_NULL), _comm1(MPI_COMM_NULL)
 {
   if (map.overlapped())
   {
@@ -24,6 +86,8 @@ Scatterer::Scatterer(const IndexMap& map, int bs)
     // ghost an owned index) ranks
     const std::vector<int>& src_ranks = map.src();
     const std::vector<int>& dest_ranks = map.dest();
+    _src = src_ranks;
+    _dest = dest_ranks;
 
     // Check that src and dest ranks are unique and sorted
     assert(std::is_sorted(src_ranks.begin(), src_ranks.end()));
@@ -141,27 +205,229 @@ Scatterer::Scatterer(const IndexMap& map, int bs)
     for (std::size_t i = 0; i < perm.size(); i++)
       for (int j = 0; j < _bs; j++)
         _remote_inds[i * _bs + j] = perm[i] * _bs + j;
+
+    _local_runs = compute_runs(_local_inds);
+    _remote_runs = compute_runs(_remote_inds);
+
+    if (_type == type::rma)
+    {
+      // Create a receive window for each direction. The data sent to
+      // a neighbour is put at the displacement in its receive buffer
+      // that it has reserved for this rank, which is communicated
+      // here.
+      auto create_window
+          = [](MPI_Comm comm, std::size_t num_values,
+               const std::vector<int>& origins, const std::vector<int>& targets,
+               const std::vector<int>& displs, MPI_Comm displs_comm)
+      {
+        auto w = std::make_shared<Window>();
+        MPI_Win_allocate(num_values * max_window_value_size, 1, MPI_INFO_NULL,
+                         comm, &w->base, &w->win);
+        w->exposure = create_group(comm, origins);
+        w->access = create_group(comm, targets);
+        w->target_disp.resize(targets.size());
+        w->target_disp.reserve(1);
+        std::vector<int> send_displs(displs.begin(),
+                                     std::prev(displs.end()));
+        send_displs.reserve(1);
+        MPI_Neighbor_alltoall(send_displs.data(), 1, MPI_INT,
+                              w->target_disp.data(), 1, MPI_INT, displs_comm);
+        return w;
+      };
+
+      // Forward: owners put into the ghost window. Each rank sends the
+      // displacement reserved for an owner to the owner (on _comm1).
+      _win_fwd = create_window(_comm0.comm(), _remote_inds.size(), _src,
+                               _dest, _displs_remote, _comm1.comm());
+
+      // Reverse: ghosting ranks put into the owned window
+      _win_rev = create_window(_comm1.comm(), _local_inds.size(), _dest,
+                               _src, _displs_local, _comm0.comm());
+    }
+
+    if (shared_memory)
+    {
+      auto shm = std::make_shared<SharedMemory>();
+      MPI_Comm_split_type(map.comm(), MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                          &shm->comm);
+
+      // Rank on the node communicator of each neighbour (MPI_UNDEFINED
+      // if on another node)
+      auto node_ranks = [&map, comm = shm->comm](const std::vector<int>& r)
+      {
+        MPI_Group group, node_group;
+        MPI_Comm_group(map.comm(), &group);
+        MPI_Comm_group(comm, &node_group);
+        std::vector<int> node_r(r.size());
+        MPI_Group_translate_ranks(group, r.size(), r.data(), node_group,
+                                  node_r.data());
+        MPI_Group_free(&group);
+        MPI_Group_free(&node_group);
+        return node_r;
+      };
+      const std::vector<int> src_node = node_ranks(_src);
+      const std::vector<int> dest_node = node_ranks(_dest);
+
+      // Allocate two send buffers in the shared window
+      shm->buffer_bytes = _local_inds.size() * max_window_value_size;
+      MPI_Win_allocate_shared(2 * shm->buffer_bytes, 1, MPI_INFO_NULL,
+                              shm->comm, &shm->base, &shm->win);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, shm->win);
+
+      // Send the position of the data for each destination rank in the
+      // send buffer to the destination
+      std::vector<int> send_displs(_displs_local.begin(),
+                                   std::prev(_displs_local.end()));
+      std::vector<int> recv_displs(_src.size());
+      send_displs.reserve(1);
+      recv_displs.reserve(1);
+      MPI_Neighbor_alltoall(send_displs.data(), 1, MPI_INT,
+                            recv_displs.data(), 1, MPI_INT, _comm0.comm());
+
+      shm->send_sizes = _sizes_local;
+      for (std::size_t j = 0; j < _dest.size(); ++j)
+      {
+        if (dest_node[j] != MPI_UNDEFINED)
+        {
+          shm->dest.push_back(j);
+          shm->send_sizes[j] = 0;
+        }
+      }
+
+      shm->recv_sizes = _sizes_remote;
+      for (std::size_t i = 0; i < _src.size(); ++i)
+      {
+        if (src_node[i] != MPI_UNDEFINED)
+        {
+          MPI_Aint size;
+          int disp_unit;
+          std::byte* ptr;
+          MPI_Win_shared_query(shm->win, src_node[i], &size, &disp_unit,
+                               &ptr);
+          shm->src.push_back(i);
+          shm->src_base.push_back(ptr);
+          shm->src_buffer_bytes.push_back(size / 2);
+          shm->src_offset.push_back(recv_displs[i]);
+          shm->recv_sizes[i] = 0;
+        }
+      }
+
+      _shm = shm;
+    }
   }
 }
 //-----------------------------------------------------------------------------
-void Scatterer::scatter_fwd_end(MPI_Request& request) const
+Scatterer::type Scatterer::autotune(const IndexMap& map, int bs, int repeats)
 {
-  // Return early if there are no incoming or outgoing edges
-  if (_sizes_local.empty() and _sizes_remote.empty())
-    return;
+  constexpr std::array types = {type::neighbor, type::p2p, type::rma};
+  std::array<double, types.size()> times;
+  for (std::size_t i = 0; i < types.size(); ++i)
+  {
+    Scatterer scatterer(map, bs, types[i]);
+    std::vector<double> local_buffer(scatterer.local_buffer_size(), 1);
+    std::vector<double> remote_buffer(scatterer.remote_buffer_size(), 1);
+    std::vector<MPI_Request> requests = scatterer.create_request_vector();
+    auto scatter = [&]()
+    {
+      scatterer.scatter_fwd_begin(std::span<const double>(local_buffer),
+                                  std::span<double>(remote_buffer),
+                                  std::span<MPI_Request>(requests));
+      scatterer.scatter_fwd_end(std::span<MPI_Request>(requests));
+      scatterer.scatter_rev_begin(std::span<const double>(remote_buffer),
+                                  std::span<double>(local_buffer),
+                                  std::span<MPI_Request>(requests));
+      scatterer.scatter_rev_end(std::span<MPI_Request>(requests));
+    };
 
-  // Wait for communication to complete
-  MPI_Wait(&request, MPI_STATUS_IGNORE);
+    // Warm up, then time
+    scatter();
+    MPI_Barrier(map.comm());
+    const double t0 = MPI_Wtime();
+    for (int r = 0; r < repeats; ++r)
+      scatter();
+    times[i] = MPI_Wtime() - t0;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, times.data(), times.size(), MPI_DOUBLE, MPI_MAX,
+                map.comm());
+  auto it = std::min_element(times.begin(), times.end());
+  return types[std::distance(times.begin(), it)];
+}
+//-----------------------------------------------------------------------------
+std::vector<MPI_Request> Scatterer::create_request_vector() const
+{
+  switch (_type)
+  {
+  case type::neighbor:
+    return std::vector<MPI_Request>(1, MPI_REQUEST_NULL);
+  case type::p2p:
+    return std::vector<MPI_Request>(_src.size() + _dest.size(),
+                                    MPI_REQUEST_NULL);
+  default:
+    return {};
+  }
 }
 //-----------------------------------------------------------------------------
-void Scatterer::scatter_rev_end(MPI_Request& request) const
+void Scatterer::scatter_end(std::span<MPI_Request> requests, Window* win) const
 {
   // Return early if there are no incoming or outgoing edges
   if (_sizes_local.empty() and _sizes_remote.empty())
     return;
 
   // Wait for communication to complete
-  MPI_Wait(&request, MPI_STATUS_IGNORE);
+  if (_type == type::rma)
+  {
+    assert(win);
+    MPI_Win_complete(win->win);
+    MPI_Win_wait(win->win);
+    if (win->recv_bytes > 0)
+      std::memcpy(win->recv_buffer, win->base, win->recv_bytes);
+  }
+  else
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+//-----------------------------------------------------------------------------
+void Scatterer::shared_fwd_end() const
+{
+  SharedMemory& shm = *_shm;
+  MPI_Barrier(shm.comm);
+  MPI_Win_sync(shm.win);
+
+  const std::size_t size = shm.value_size;
+  for (std::size_t k = 0; k < shm.src.size(); ++k)
+  {
+    const int i = shm.src[k];
+    const std::byte* buffer
+        = shm.src_base[k] + shm.parity * shm.src_buffer_bytes[k];
+    std::memcpy(shm.recv_buffer + _displs_remote[i] * size,
+                buffer + shm.src_offset[k] * size, _sizes_remote[i] * size);
+  }
+
+  shm.parity = 1 - shm.parity;
+}
+//-----------------------------------------------------------------------------
+void Scatterer::scatter_fwd_end(std::span<MPI_Request> requests) const
+{
+  scatter_end(requests, _win_fwd.get());
+  if (_shm)
+    shared_fwd_end();
+}
+//-----------------------------------------------------------------------------
+void Scatterer::scatter_rev_end(std::span<MPI_Request> requests) const
+{
+  scatter_end(requests, _win_rev.get());
+}
+//-----------------------------------------------------------------------------
+void Scatterer::scatter_start(std::span<MPI_Request> requests) const
+{
+  if (!requests.empty())
+    MPI_Startall(requests.size(), requests.data());
+}
+//-----------------------------------------------------------------------------
+void Scatterer::scatter_wait(std::span<MPI_Request> requests) const
+{
+  if (!requests.empty())
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
 }
 //-----------------------------------------------------------------------------
 std::int32_t Scatterer::local_buffer_size() const noexcept
@@ -186,3 +452,7 @@ const std::vector<std::int32_t>& Scatterer::remote_indices() const noexcept
 //-----------------------------------------------------------------------------
 int Scatterer::bs() const noexcept { return _bs; }
 //-----------------------------------------------------------------------------
+Scatterer::type Scatterer::comm_type() const noexcept { return _type; }
+//-----------------------------------------------------------------------------
+bool Scatterer::shared_memory() const noexcept { return _shm != nullptr; }
+//-----------------------------------------------------------------------------
@@ -8,8 +8,12 @@
 
 #include "MPI.h"
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
 #include <mpi.h>
 #include <span>
+#include <stdexcept>
 #include <vector>
 
 using namespace dolfinx;
@@ -21,18 +25,73 @@ class IndexMap;
 /// @brief A Scatterer supports the MPI scattering and gathering of data
 /// that is associated with a common::IndexMap.
 ///
-/// Scatter and gather operations uses MPI neighbourhood collectives.
-/// The implementation is designed is for sparse communication patterns,
-/// as it typical of patterns based on and IndexMap.
+/// The communication backend is selected when the scatterer is
+/// created, see Scatterer::type. The default uses MPI neighbourhood
+/// collectives. The implementation is designed is for sparse
+/// communication patterns, as it typical of patterns based on and
+/// IndexMap.
+///
+/// Optionally, forward scatters between ranks on the same
+/// (shared-memory) node bypass MPI messages: the owning rank copies the
+/// data into a shared-memory window, from which the ghosting ranks read
+/// it directly after a node barrier. Data for ranks on other nodes is
+/// communicated using the selected backend.
 class Scatterer
 {
 public:
+  /// @brief Communication backend used to move data.
+  ///
+  /// All backends are non-blocking and give the same results. Their
+  /// relative performance depends on the MPI implementation, the
+  /// network and the communication pattern; see Scatterer::autotune.
+  ///
+  /// @note With Scatterer::type::rma, data is put into windows owned by
+  /// the scatterer and copied to the receive buffer when the scatter is
+  /// completed. At most one forward and one reverse scatter can then be
+  /// in progress at a time for a scatterer.
+  enum class type
+  {
+    neighbor, ///< Neighbourhood collective (`MPI_Ineighbor_alltoallv`)
+    p2p,      ///< Point-to-point (`MPI_Isend`/`MPI_Irecv`)
+    rma ///< One-sided `MPI_Put` into receive windows, synchronised
+        ///< with the neighbourhood (post-start-complete-wait)
+  };
+
   /// @brief Create a scatterer
   /// @param[in] map The index map that describes the parallel layout of
   /// data
   /// @param[in] bs The block size of data associated with each index in
   /// `map` that will be scattered/gathered
-  Scatterer(const IndexMap& map, int bs);
+  /// @param[in] type The communication backend
+  /// @param[in] shared_memory If true, forward scatters to ranks on the
+  /// same node use a shared-memory window instead of MPI messages. All
+  /// ranks on a node must then take part in each forward scatter, and
+  /// at most one forward scatter can be in progress at a time for the
+  /// scatterer.
+  /// @note Collective MPI operation
+  Scatterer(const IndexMap& map, int bs, type type = type::neighbor,
+            bool shared_memory = false);
+
+  /// @brief Find the fastest communication backend for an index map.
+  ///
+  /// A scatterer is created for each backend and a number of forward
+  /// and reverse scatters of `double` data are timed. The backend with
+  /// the smallest maximum time over all ranks is returned, so that the
+  /// result is the same on all ranks.
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] map The index map
+  /// @param[in] bs The block size
+  /// @param[in] repeats Number of forward/reverse scatters to time for
+  /// each backend
+  /// @return The fastest backend
+  static type autotune(const IndexMap& map, int bs, int repeats = 20);
+
+  /// @brief Create a vector of MPI requests of the size required by
+  /// the communication backend of this scatterer.
+  /// @return Request handles to pass to the non-blocking scatter
+  /// functions
+  std::vector<MPI_Request> create_request_vector() const;
 
   /// @brief Start a non-blocking send of owned data to ranks that ghost
   /// the data.
@@ -50,21 +109,27 @@ public:
   /// Scatterer::remote_indices. The buffer must not be
   /// accessed or changed until after a call to
   /// Scatterer::scatter_fwd_end.
-  /// @param request The MPI request handle for tracking the status of
-  /// the non-blocking communication
+  /// @param requests The MPI request handles for tracking the status
+  /// of the non-blocking communication, created by
+  /// Scatterer::create_request_vector
   template <typename T>
   void scatter_fwd_begin(const std::span<const T>& send_buffer,
                          const std::span<T>& recv_buffer,
-                         MPI_Request& request) const
+                         std::span<MPI_Request> requests) const
   {
-    // Return early if there are no incoming or outgoing edges
-    if (_sizes_local.empty() and _sizes_remote.empty())
-      return;
-
-    MPI_Ineighbor_alltoallv(
-        send_buffer.data(), _sizes_local.data(), _displs_local.data(),
-        MPI::mpi_type<T>(), recv_buffer.data(), _sizes_remote.data(),
-        _displs_remote.data(), MPI::mpi_type<T>(), _comm0.comm(), &request);
+    if (_shm)
+    {
+      shared_fwd_begin(send_buffer, recv_buffer);
+      scatter_begin(send_buffer, recv_buffer, requests, _comm0.comm(), _dest,
+                    _shm->send_sizes, _displs_local, _src, _shm->recv_sizes,
+                    _displs_remote, _win_fwd.get());
+    }
+    else
+    {
+      scatter_begin(send_buffer, recv_buffer, requests, _comm0.comm(), _dest,
+                    _sizes_local, _displs_local, _src, _sizes_remote,
+                    _displs_remote, _win_fwd.get());
+    }
   }
 
   /// @brief Complete a non-blocking send from the local owner to
@@ -73,9 +138,9 @@ public:
   /// This function completes the communication started by
   /// Scatterer::scatter_fwd_begin.
   ///
-  /// @param[in] request The MPI request handle for tracking the status
-  /// of the send
-  void scatter_fwd_end(MPI_Request& request) const;
+  /// @param[in] requests The MPI request handles for tracking the
+  /// status of the send
+  void scatter_fwd_end(std::span<MPI_Request> requests) const;
 
   /// @brief Scatter data associated with owned indices to ghosting
   /// ranks.
@@ -93,17 +158,19 @@ public:
   /// @param[in] pack_fn Function to pack data from `local_data` into
   /// the send buffer. It is passed as an argument to support
   /// CUDA/device-aware MPI.
-  /// @param[in] request The MPI request handle for tracking the status
-  /// of the send
+  /// @param[in] requests The MPI request handles for tracking the
+  /// status of the send
   template <typename T, typename Functor>
   void scatter_fwd_begin(const std::span<const T>& local_data,
                          std::span<T> local_buffer, std::span<T> remote_buffer,
-                         Functor pack_fn, MPI_Request& request) const
+                         Functor pack_fn,
+                         std::span<MPI_Request> requests) const
   {
     assert(local_buffer.size() == _local_inds.size());
     assert(remote_buffer.size() == _remote_inds.size());
     pack_fn(local_data, _local_inds, local_buffer);
-    scatter_fwd_begin(std::span<const T>(local_buffer), remote_buffer, request);
+    scatter_fwd_begin(std::span<const T>(local_buffer), remote_buffer,
+                      requests);
   }
 
   /// @brief Complete a non-blocking send from the local owner to
@@ -123,16 +190,16 @@ public:
   /// @param[in] unpack_fn Function to unpack the received buffer into
   /// `remote_data`. It is passed as an argument to support
   /// CUDA/device-aware MPI.
-  /// @param[in] request The MPI request handle for tracking the status
-  /// of the send
+  /// @param[in] requests The MPI request handles for tracking the
+  /// status of the send
   template <typename T, typename Functor>
   void scatter_fwd_end(const std::span<const T>& remote_buffer,
                        std::span<T> remote_data, Functor unpack_fn,
-                       MPI_Request& request) const
+                       std::span<MPI_Request> requests) const
   {
     assert(remote_buffer.size() == _remote_inds.size());
     assert(remote_data.size() == _remote_inds.size());
-    scatter_fwd_end(request);
+    scatter_fwd_end(requests);
     unpack_fn(remote_buffer, _remote_inds, remote_data,
               [](T /*a*/, T b) { return b; });
   }
@@ -152,25 +219,16 @@ public:
   void scatter_fwd(const std::span<const T>& local_data,
                    std::span<T> remote_data) const
   {
-    MPI_Request request;
+    std::vector<MPI_Request> requests = create_request_vector();
     std::vector<T> local_buffer(local_buffer_size(), 0);
     std::vector<T> remote_buffer(remote_buffer_size(), 0);
-    auto pack_fn = [](const auto& in, const auto& idx, auto& out)
-    {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[i] = in[idx[i]];
-    };
-    scatter_fwd_begin(local_data, std::span<T>(local_buffer),
-                      std::span<T>(remote_buffer), pack_fn, request);
-
-    auto unpack_fn = [](const auto& in, const auto& idx, auto& out, auto op)
-    {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[idx[i]] = op(out[idx[i]], in[i]);
-    };
-
-    scatter_fwd_end(std::span<const T>(remote_buffer), remote_data, unpack_fn,
-                    request);
+    pack_local(local_data, std::span<T>(local_buffer));
+    scatter_fwd_begin(std::span<const T>(local_buffer),
+                      std::span<T>(remote_buffer),
+                      std::span<MPI_Request>(requests));
+    scatter_fwd_end(std::span<MPI_Request>(requests));
+    unpack_remote(std::span<const T>(remote_buffer), remote_data,
+                  [](T /*a*/, T b) { return b; });
   }
 
   /// @brief Start a non-blocking send of ghost data to ranks that own
@@ -195,22 +253,17 @@ public:
   ///
   /// The buffer must not be accessed or changed until after a call to
   /// Scatterer::scatter_fwd_end.
-  /// @param request The MPI request handle for tracking the status of
-  /// the non-blocking communication
+  /// @param requests The MPI request handles for tracking the status
+  /// of the non-blocking communication, created by
+  /// Scatterer::create_request_vector
   template <typename T>
   void scatter_rev_begin(const std::span<const T>& send_buffer,
                          const std::span<T>& recv_buffer,
-                         MPI_Request& request) const
+                         std::span<MPI_Request> requests) const
   {
-    // Return early if there are no incoming or outgoing edges
-    if (_sizes_local.empty() and _sizes_remote.empty())
-      return;
-
-    // Send and receive data
-    MPI_Ineighbor_alltoallv(
-        send_buffer.data(), _sizes_remote.data(), _displs_remote.data(),
-        MPI::mpi_type<T>(), recv_buffer.data(), _sizes_local.data(),
-        _displs_local.data(), MPI::mpi_type<T>(), _comm1.comm(), &request);
+    scatter_begin(send_buffer, recv_buffer, requests, _comm1.comm(), _src,
+                  _sizes_remote, _displs_remote, _dest, _sizes_local,
+                  _displs_local, _win_rev.get());
   }
 
   /// @brief End the reverse scatter communication.
@@ -219,9 +272,9 @@ public:
   /// The buffers passed to Scatterer::scatter_rev_begin must not be
   /// modified until after the function has been called.
   ///
-  /// @param[in] request The handle used when calling
+  /// @param[in] requests The handles used when calling
   /// Scatterer::scatter_rev_begin
-  void scatter_rev_end(MPI_Request& request) const;
+  void scatter_rev_end(std::span<MPI_Request> requests) const;
 
   /// @brief Scatter data associated with ghost indices to owning ranks.
   ///
@@ -247,17 +300,19 @@ public:
   /// @param[in] pack_fn Function to pack data from `local_data` into
   /// the send buffer. It is passed as an argument to support
   /// CUDA/device-aware MPI.
-  /// @param request The MPI request handle for tracking the status of
-  /// the non-blocking communication
+  /// @param requests The MPI request handles for tracking the status
+  /// of the non-blocking communication
   template <typename T, typename Functor>
   void scatter_rev_begin(const std::span<const T>& remote_data,
                          std::span<T> remote_buffer, std::span<T> local_buffer,
-                         Functor pack_fn, MPI_Request& request) const
+                         Functor pack_fn,
+                         std::span<MPI_Request> requests) const
   {
     assert(local_buffer.size() == _local_inds.size());
     assert(remote_buffer.size() == _remote_inds.size());
     pack_fn(remote_data, _remote_inds, remote_buffer);
-    scatter_rev_begin(std::span<const T>(remote_buffer), local_buffer, request);
+    scatter_rev_begin(std::span<const T>(remote_buffer), local_buffer,
+                      requests);
   }
 
   /// @brief End the reverse scatter communication, and unpack the received
@@ -277,18 +332,18 @@ public:
   /// CUDA/device-aware MPI.
   /// @param[in] op The reduction operation when accumulating received
   /// values. To add the received values use `std::plus<T>()`.
-  /// @param[in] request The handle used when calling
+  /// @param[in] requests The handles used when calling
   /// Scatterer::scatter_rev_begin
   template <typename T, typename Functor, typename BinaryOp>
   void scatter_rev_end(const std::span<const T>& local_buffer,
                        std::span<T> local_data, Functor unpack_fn, BinaryOp op,
-                       MPI_Request& request)
+                       std::span<MPI_Request> requests)
   {
     assert(local_buffer.size() == _local_inds.size());
     if (_local_inds.size() > 0)
       assert(*std::max_element(_local_inds.begin(), _local_inds.end())
              < std::int32_t(local_data.size()));
-    scatter_rev_end(request);
+    scatter_rev_end(requests);
     unpack_fn(local_buffer, _local_inds, local_data, op);
   }
 
@@ -298,25 +353,168 @@ public:
   void scatter_rev(std::span<T> local_data,
                    const std::span<const T>& remote_data, BinaryOp op)
   {
+    std::vector<MPI_Request> requests = create_request_vector();
     std::vector<T> local_buffer(local_buffer_size(), 0);
     std::vector<T> remote_buffer(remote_buffer_size(), 0);
-    auto pack_fn = [](const auto& in, const auto& idx, auto& out)
+    pack_remote(remote_data, std::span<T>(remote_buffer));
+    scatter_rev_begin(std::span<const T>(remote_buffer),
+                      std::span<T>(local_buffer),
+                      std::span<MPI_Request>(requests));
+    scatter_rev_end(std::span<MPI_Request>(requests));
+    unpack_local(std::span<const T>(local_buffer), local_data, op);
+  }
+
+  /// @brief Pack data associated with owned indices into a send buffer
+  /// for a forward scatter.
+  ///
+  /// This is equivalent to `buffer[i] = local_data[local_indices()[i]]`.
+  /// Contiguous runs of indices, which are detected when the scatterer
+  /// is created, are copied as blocks.
+  ///
+  /// @param[in] local_data Data associated with owned indices (blocked)
+  /// @param[out] buffer The send buffer, of size
+  /// Scatterer::local_buffer_size
+  template <typename T>
+  void pack_local(std::span<const T> local_data, std::span<T> buffer) const
+  {
+    assert(buffer.size() == _local_inds.size());
+    pack(_local_runs, _local_inds, local_data, buffer);
+  }
+
+  /// @brief Pack data associated with ghost indices into a send buffer
+  /// for a reverse scatter.
+  ///
+  /// This is equivalent to `buffer[i] = remote_data[remote_indices()[i]]`.
+  ///
+  /// @param[in] remote_data Data associated with ghost indices (blocked)
+  /// @param[out] buffer The send buffer, of size
+  /// Scatterer::remote_buffer_size
+  template <typename T>
+  void pack_remote(std::span<const T> remote_data, std::span<T> buffer) const
+  {
+    assert(buffer.size() == _remote_inds.size());
+    pack(_remote_runs, _remote_inds, remote_data, buffer);
+  }
+
+  /// @brief Unpack the receive buffer of a reverse scatter into data
+  /// associated with owned indices.
+  ///
+  /// This is equivalent to `local_data[local_indices()[i]] =
+  /// op(local_data[local_indices()[i]], buffer[i])`.
+  ///
+  /// @param[in] buffer The receive buffer
+  /// @param[in,out] local_data Data associated with owned indices
+  /// @param[in] op The reduction operation
+  template <typename T, typename BinaryOp>
+  void unpack_local(std::span<const T> buffer, std::span<T> local_data,
+                    BinaryOp op) const
+  {
+    assert(buffer.size() == _local_inds.size());
+    unpack(_local_runs, _local_inds, buffer, local_data, op);
+  }
+
+  /// @brief Unpack the receive buffer of a forward scatter into data
+  /// associated with ghost indices.
+  ///
+  /// This is equivalent to `remote_data[remote_indices()[i]] =
+  /// op(remote_data[remote_indices()[i]], buffer[i])`.
+  ///
+  /// @param[in] buffer The receive buffer
+  /// @param[in,out] remote_data Data associated with ghost indices
+  /// @param[in] op The reduction operation. To insert the received
+  /// values use `[](auto a, auto b) { return b; }`.
+  template <typename T, typename BinaryOp>
+  void unpack_remote(std::span<const T> buffer, std::span<T> remote_data,
+                     BinaryOp op) const
+  {
+    assert(buffer.size() == _remote_inds.size());
+    unpack(_remote_runs, _remote_inds, buffer, remote_data, op);
+  }
+
+  /// @brief Create persistent MPI requests for forward scatters
+  /// between two fixed buffers.
+  ///
+  /// The requests are created once and are then restarted for each
+  /// scatter with Scatterer::scatter_start and completed with
+  /// Scatterer::scatter_wait, avoiding the setup cost of a non-blocking
+  /// neighbourhood collective on every exchange. The caller owns the
+  /// requests and must free them with `MPI_Request_free`. Persistent
+  /// requests are not supported by the Scatterer::type::rma backend or
+  /// with shared-memory scatters.
+  ///
+  /// @note Collective MPI operation if MPI-4 is supported
+  /// @param[in] send_buffer Buffer for the packed owned data, ordered as
+  /// Scatterer::local_indices. It must not be destroyed before the
+  /// requests are freed.
+  /// @param[in] recv_buffer Buffer for the received ghost data, ordered
+  /// as Scatterer::remote_indices. It must not be destroyed before the
+  /// requests are freed.
+  /// @return The persistent requests
+  template <typename T>
+  std::vector<MPI_Request>
+  scatter_fwd_init(const std::span<const T>& send_buffer,
+                   const std::span<T>& recv_buffer) const
+  {
+    assert(send_buffer.size() == _local_inds.size());
+    assert(recv_buffer.size() == _remote_inds.size());
+    if (_type == type::rma or _shm)
     {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[i] = in[idx[i]];
-    };
-    auto unpack_fn = [](const auto& in, const auto& idx, auto& out, auto op)
+      throw std::runtime_error("Persistent requests not supported for RMA "
+                               "or shared-memory scatters.");
+    }
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return {};
+
+    return dolfinx::MPI::neighbor_alltoallv_init(
+        send_buffer.data(), _sizes_local.data(), _displs_local.data(),
+        recv_buffer.data(), _sizes_remote.data(), _displs_remote.data(),
+        _comm0.comm());
+  }
+
+  /// @brief Create persistent MPI requests for reverse scatters
+  /// between two fixed buffers.
+  ///
+  /// See Scatterer::scatter_fwd_init.
+  ///
+  /// @note Collective MPI operation if MPI-4 is supported
+  /// @param[in] send_buffer Buffer for the packed ghost data, ordered as
+  /// Scatterer::remote_indices. It must not be destroyed before the
+  /// requests are freed.
+  /// @param[in] recv_buffer Buffer for the received owned data, ordered
+  /// as Scatterer::local_indices. It must not be destroyed before the
+  /// requests are freed.
+  /// @return The persistent requests
+  template <typename T>
+  std::vector<MPI_Request>
+  scatter_rev_init(const std::span<const T>& send_buffer,
+                   const std::span<T>& recv_buffer) const
+  {
+    assert(send_buffer.size() == _remote_inds.size());
+    assert(recv_buffer.size() == _local_inds.size());
+    if (_type == type::rma or _shm)
     {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[idx[i]] = op(out[idx[i]], in[i]);
-    };
-    MPI_Request request;
-    scatter_rev_begin(remote_data, std::span<T>(remote_buffer),
-                      std::span<T>(local_buffer), pack_fn, request);
-    scatter_rev_end(std::span<const T>(local_buffer), local_data, unpack_fn, op,
-                    request);
+      throw std::runtime_error("Persistent requests not supported for RMA "
+                               "or shared-memory scatters.");
+    }
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return {};
+
+    return dolfinx::MPI::neighbor_alltoallv_init(
+        send_buffer.data(), _sizes_remote.data(), _displs_remote.data(),
+        recv_buffer.data(), _sizes_local.data(), _displs_local.data(),
+        _comm1.comm());
   }
 
+  /// @brief Start a scatter using persistent requests created by
+  /// Scatterer::scatter_fwd_init or Scatterer::scatter_rev_init.
+  /// @param[in,out] requests The persistent requests
+  void scatter_start(std::span<MPI_Request> requests) const;
+
+  /// @brief Complete a scatter started with Scatterer::scatter_start.
+  /// The requests remain allocated and can be restarted.
+  /// @param[in,out] requests The persistent requests
+  void scatter_wait(std::span<MPI_Request> requests) const;
+
   /// @brief Size of buffer for local data (owned and shared) used in
   /// forward and reverse communication
   /// @return The required buffer size
@@ -341,10 +539,247 @@ public:
   /// @return The block size
   int bs() const noexcept;
 
+  /// @brief The communication backend
+  type comm_type() const noexcept;
+
+  /// @brief Check if forward scatters to ranks on the same node use
+  /// shared memory
+  /// @return True if shared memory is used
+  bool shared_memory() const noexcept;
+
 private:
+  // Largest value type size (bytes) supported by the RMA backend and
+  // shared-memory scatters. Windows are allocated for values of this
+  // size.
+  static constexpr std::size_t max_window_value_size = 16;
+
+  // One-sided communication data for one scatter direction. The window
+  // has the same layout as the receive buffer.
+  struct Window
+  {
+    Window() = default;
+    Window(const Window&) = delete;
+    Window& operator=(const Window&) = delete;
+    ~Window();
+
+    // Window and its memory
+    MPI_Win win = MPI_WIN_NULL;
+    std::byte* base = nullptr;
+
+    // Ranks that put into this window (exposure), and ranks that this
+    // rank puts into (access)
+    MPI_Group exposure = MPI_GROUP_NULL, access = MPI_GROUP_NULL;
+
+    // Offset (number of values) in the target window for each target
+    std::vector<int> target_disp;
+
+    // Receive buffer of the scatter in progress, and its size in bytes
+    std::byte* recv_buffer = nullptr;
+    std::size_t recv_bytes = 0;
+  };
+
+  // Start a non-blocking exchange in one direction: send_sizes[i] values
+  // from send_buffer to rank dest[i] and receive recv_sizes[i] values
+  // into recv_buffer from rank src[i]
+  template <typename T>
+  void scatter_begin(std::span<const T> send_buffer, std::span<T> recv_buffer,
+                     std::span<MPI_Request> requests, MPI_Comm comm,
+                     const std::vector<int>& dest,
+                     const std::vector<int>& send_sizes,
+                     const std::vector<int>& send_displs,
+                     const std::vector<int>& src,
+                     const std::vector<int>& recv_sizes,
+                     const std::vector<int>& recv_displs, Window* win) const
+  {
+    // Return early if there are no incoming or outgoing edges
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return;
+
+    const int tag = static_cast<int>(MPI::tag::neighbor_p2p);
+    switch (_type)
+    {
+    case type::neighbor:
+      assert(requests.size() == 1);
+      MPI_Ineighbor_alltoallv(send_buffer.data(), send_sizes.data(),
+                              send_displs.data(), MPI::mpi_type<T>(),
+                              recv_buffer.data(), recv_sizes.data(),
+                              recv_displs.data(), MPI::mpi_type<T>(), comm,
+                              requests.data());
+      break;
+    case type::p2p:
+      assert(requests.size() == src.size() + dest.size());
+      for (std::size_t i = 0; i < src.size(); ++i)
+      {
+        if (recv_sizes[i] > 0)
+        {
+          MPI_Irecv(recv_buffer.data() + recv_displs[i], recv_sizes[i],
+                    MPI::mpi_type<T>(), src[i], tag, comm, &requests[i]);
+        }
+      }
+      for (std::size_t i = 0; i < dest.size(); ++i)
+      {
+        if (send_sizes[i] > 0)
+        {
+          MPI_Isend(send_buffer.data() + send_displs[i], send_sizes[i],
+                    MPI::mpi_type<T>(), dest[i], tag, comm,
+                    &requests[src.size() + i]);
+        }
+      }
+      break;
+    case type::rma:
+    {
+      if (sizeof(T) > max_window_value_size)
+      {
+        throw std::runtime_error(
+            "Value type is too large for the RMA scatter backend");
+      }
+      assert(win);
+      win->recv_buffer = reinterpret_cast<std::byte*>(recv_buffer.data());
+      win->recv_bytes = recv_buffer.size_bytes();
+      MPI_Win_post(win->exposure, 0, win->win);
+      MPI_Win_start(win->access, 0, win->win);
+      for (std::size_t i = 0; i < dest.size(); ++i)
+      {
+        if (send_sizes[i] > 0)
+        {
+          MPI_Put(send_buffer.data() + send_displs[i], send_sizes[i],
+                  MPI::mpi_type<T>(), dest[i],
+                  MPI_Aint(win->target_disp[i]) * sizeof(T), send_sizes[i],
+                  MPI::mpi_type<T>(), win->win);
+        }
+      }
+      break;
+    }
+    }
+  }
+
+  // Complete an exchange started by Scatterer::scatter_begin
+  void scatter_end(std::span<MPI_Request> requests, Window* win) const;
+
+  // Gather data[indices[i]] into buffer, using contiguous runs of
+  // indices if available
+  template <typename T>
+  static void pack(const std::vector<std::array<std::int32_t, 2>>& runs,
+                   const std::vector<std::int32_t>& indices,
+                   std::span<const T> data, std::span<T> buffer)
+  {
+    if (runs.empty())
+    {
+      for (std::size_t i = 0; i < indices.size(); ++i)
+        buffer[i] = data[indices[i]];
+    }
+    else
+    {
+      T* b = buffer.data();
+      for (auto [start, size] : runs)
+        b = std::copy_n(std::next(data.data(), start), size, b);
+    }
+  }
+
+  // Reduce buffer[i] into data[indices[i]], using contiguous runs of
+  // indices if available
+  template <typename T, typename BinaryOp>
+  static void unpack(const std::vector<std::array<std::int32_t, 2>>& runs,
+                     const std::vector<std::int32_t>& indices,
+                     std::span<const T> buffer, std::span<T> data,
+                     BinaryOp op)
+  {
+    if (runs.empty())
+    {
+      for (std::size_t i = 0; i < indices.size(); ++i)
+        data[indices[i]] = op(data[indices[i]], buffer[i]);
+    }
+    else
+    {
+      const T* b = buffer.data();
+      for (auto [start, size] : runs)
+      {
+        T* d = std::next(data.data(), start);
+        for (std::int32_t i = 0; i < size; ++i)
+          d[i] = op(d[i], b[i]);
+        b += size;
+      }
+    }
+  }
+
+  // Intra-node data for forward scatters. Each rank copies the data it
+  // sends to ranks on the same node into its part of a shared window,
+  // which is double buffered so that a single node barrier per scatter
+  // is sufficient.
+  struct SharedMemory
+  {
+    SharedMemory() = default;
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    ~SharedMemory();
+
+    // Node communicator, and the shared window with its memory for
+    // this rank
+    MPI_Comm comm = MPI_COMM_NULL;
+    MPI_Win win = MPI_WIN_NULL;
+    std::byte* base = nullptr;
+
+    // Size (bytes) of each of the two buffers of this rank
+    std::size_t buffer_bytes = 0;
+
+    // Positions in _dest of the destination ranks on this node
+    std::vector<int> dest;
+
+    // Positions in _src of the source ranks on this node, with the
+    // memory and buffer size of their window, and the offset (number
+    // of values) of the data for this rank in their buffer
+    std::vector<int> src;
+    std::vector<const std::byte*> src_base;
+    std::vector<std::size_t> src_buffer_bytes;
+    std::vector<int> src_offset;
+
+    // Sizes of data sent and received with MPI (zero for ranks on this
+    // node)
+    std::vector<int> send_sizes, recv_sizes;
+
+    // Buffer in use (0 or 1), receive buffer of the scatter in
+    // progress and the size of its values
+    int parity = 0;
+    std::byte* recv_buffer = nullptr;
+    std::size_t value_size = 0;
+  };
+
+  // Copy data for ranks on this node into the shared window
+  template <typename T>
+  void shared_fwd_begin(std::span<const T> send_buffer,
+                        std::span<T> recv_buffer) const
+  {
+    if (sizeof(T) > max_window_value_size)
+    {
+      throw std::runtime_error(
+          "Value type is too large for shared-memory scatters");
+    }
+    SharedMemory& shm = *_shm;
+    T* buffer = reinterpret_cast<T*>(shm.base + shm.parity * shm.buffer_bytes);
+    for (int j : shm.dest)
+    {
+      std::copy_n(std::next(send_buffer.begin(), _displs_local[j]),
+                  _sizes_local[j], std::next(buffer, _displs_local[j]));
+    }
+    MPI_Win_sync(shm.win);
+    shm.recv_buffer = reinterpret_cast<std::byte*>(recv_buffer.data());
+    shm.value_size = sizeof(T);
+  }
+
+  // Wait for ranks on this node and read their data from the shared
+  // window
+  void shared_fwd_end() const;
+
   // Block size
   int _bs;
 
+  // Communication backend
+  type _type;
+
+  // Ranks that own ghosts of this rank (src), and ranks that ghost
+  // indices owned by this rank (dest)
+  std::vector<int> _src, _dest;
+
   // Communicator where the source ranks own the indices in the callers
   // halo, and the destination ranks 'ghost' indices owned by the
   // caller. I.e.,
@@ -378,5 +813,17 @@ private:
 
   // Displacements of local data for mpi scatter and gather
   std::vector<int> _displs_local;
+
+  // Contiguous runs (start, length) of _local_inds and _remote_inds.
+  // Empty if the runs are too short on average to be worthwhile, in
+  // which case the indices are used directly.
+  std::vector<std::array<std::int32_t, 2>> _local_runs, _remote_runs;
+
+  // Receive windows for the forward (ghost data) and reverse (owned
+  // data) scatters, when using the RMA backend
+  std::shared_ptr<Window> _win_fwd, _win_rev;
+
+  // Shared-memory data for forward scatters on a node (optional)
+  std::shared_ptr<SharedMemory> _shm;
 };
 } // namespace dolfinx::common
@@ -8,8 +8,12 @@
 
 #include <algorithm>
 #include <boost/functional/hash.hpp>
+#include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <exception>
 #include <mpi.h>
+#include <numeric>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -112,4 +116,77 @@ std::size_t hash_global(MPI_Comm comm, const T& x)
   return global_hash;
 }
 
+/// @brief Call `f(i0, i1)` for contiguous blocks `[i0, i1)` of `[0,
+/// n)`, one block per thread.
+///
+/// If `num_threads <= 1`, `f(0, n)` is called on the calling thread.
+/// Otherwise, an exception thrown by `f` on any thread is rethrown on
+/// the calling thread after all threads have finished (the exception
+/// from the lowest block if more than one thread throws).
+/// @param[in] n The size of the range
+/// @param[in] num_threads The number of threads
+/// @param[in] f The function to call for each block
+template <typename F>
+void apply_blocks(std::int64_t n, int num_threads, F&& f)
+{
+  if (num_threads <= 1)
+    f(0, n);
+  else
+  {
+    std::vector<std::exception_ptr> errors(num_threads);
+    {
+      std::vector<std::jthread> threads;
+      for (int i = 0; i < num_threads; ++i)
+      {
+        auto range = dolfinx::MPI::local_range(i, n, num_threads);
+        threads.emplace_back(
+            [&errors, &f, i, range]()
+            {
+              try
+              {
+                f(range[0], range[1]);
+              }
+              catch (...)
+              {
+                errors[i] = std::current_exception();
+              }
+            });
+      }
+    }
+
+    for (auto& e : errors)
+    {
+      if (e)
+        std::rethrow_exception(e);
+    }
+  }
+}
+
+/// @brief Sum of `f(i0, i1)` over contiguous blocks `[i0, i1)` of `[0,
+/// n)`, one block per thread.
+///
+/// If `num_threads <= 1`, `f(0, n)` is called on the calling thread.
+/// Exceptions thrown by `f` are passed to the calling thread as for
+/// common::apply_blocks.
+/// @param[in] n The size of the range
+/// @param[in] num_threads The number of threads
+/// @param[in] f The function to call for each block
+/// @return The sum of the values returned by `f`
+template <typename T, typename F>
+T reduce_blocks(std::int64_t n, int num_threads, F&& f)
+{
+  if (num_threads <= 1)
+    return f(0, n);
+
+  // Block i of [0, num_threads) is the thread index
+  std::vector<T> partial(num_threads, 0);
+  apply_blocks(num_threads, num_threads,
+               [&partial, &f, n, num_threads](std::int64_t i0, std::int64_t)
+               {
+                 auto range = dolfinx::MPI::local_range(i0, n, num_threads);
+                 partial[i0] = f(range[0], range[1]);
+               });
+  return std::accumulate(partial.begin(), partial.end(), T(0));
+}
+
 } // namespace dolfinx::common
@@ -7,6 +7,7 @@
 #include "CoordinateElement.h"
 #include <basix/finite-element.h>
 #include <cmath>
+#include <numeric>
 #include <dolfinx/common/math.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <xtensor/xadapt.hpp>
@@ -16,6 +17,161 @@
 using namespace dolfinx;
 using namespace dolfinx::fem;
 
+namespace
+{
+/// Compute the inverse of a small square matrix with fixed size
+/// (row-major storage)
+template <std::size_t n>
+void inv(const std::array<double, n * n>& A, std::array<double, n * n>& B)
+{
+  if constexpr (n == 1)
+    B[0] = 1.0 / A[0];
+  else if constexpr (n == 2)
+  {
+    const double idet = 1.0 / math::det(A.data(), {2, 2});
+    B = {idet * A[3], -idet * A[1], -idet * A[2], idet * A[0]};
+  }
+  else if constexpr (n == 3)
+  {
+    using math::difference_of_products;
+    const double w0 = difference_of_products(A[4], A[5], A[7], A[8]);
+    const double w1 = difference_of_products(A[3], A[5], A[6], A[8]);
+    const double w2 = difference_of_products(A[3], A[4], A[6], A[7]);
+    const double idet
+        = 1.0 / std::fma(A[2], w2, difference_of_products(A[0], A[1], w1, w0));
+    B[0] = w0 * idet;
+    B[3] = -w1 * idet;
+    B[6] = w2 * idet;
+    B[1] = difference_of_products(A[2], A[1], A[8], A[7]) * idet;
+    B[2] = difference_of_products(A[1], A[2], A[4], A[5]) * idet;
+    B[4] = difference_of_products(A[0], A[2], A[6], A[8]) * idet;
+    B[5] = difference_of_products(A[3], A[0], A[5], A[2]) * idet;
+    B[7] = difference_of_products(A[6], A[0], A[7], A[1]) * idet;
+    B[8] = difference_of_products(A[0], A[3], A[1], A[4]) * idet;
+  }
+}
+
+/// Compute the (pseudo-)inverse K, shape (tdim, gdim), of the Jacobian
+/// J, shape (gdim, tdim). Storage is row-major.
+template <std::size_t gdim, std::size_t tdim>
+void compute_jacobian_inverse(const std::array<double, gdim * tdim>& J,
+                              std::array<double, tdim * gdim>& K)
+{
+  if constexpr (gdim == tdim)
+    inv<tdim>(J, K);
+  else
+  {
+    // K = (J^T J)^{-1} J^T
+    std::array<double, tdim * tdim> JTJ{}, JTJinv;
+    for (std::size_t i = 0; i < tdim; ++i)
+      for (std::size_t j = 0; j < tdim; ++j)
+        for (std::size_t k = 0; k < gdim; ++k)
+          JTJ[i * tdim + j] += J[k * tdim + i] * J[k * tdim + j];
+    inv<tdim>(JTJ, JTJinv);
+    K.fill(0);
+    for (std::size_t i = 0; i < tdim; ++i)
+      for (std::size_t j = 0; j < gdim; ++j)
+        for (std::size_t k = 0; k < tdim; ++k)
+          K[i * gdim + j] += JTJinv[i * tdim + k] * J[j * tdim + k];
+  }
+}
+
+/// Batched Newton solve for the non-affine pull-back, with the
+/// dimensions known at compile time
+template <std::size_t gdim, std::size_t tdim>
+void pull_back_nonaffine_batched(const basix::FiniteElement& element,
+                                 std::span<double> X,
+                                 std::span<const double> x,
+                                 std::span<const double> cell_geometry,
+                                 std::span<const std::int32_t> cells,
+                                 double tol, int maxit)
+{
+  const std::size_t num_points = cells.size();
+  const std::size_t num_xnodes = element.dim();
+  const double tol2 = tol * tol;
+
+  // Points that have not yet converged, and their current reference
+  // coordinates
+  std::vector<std::int32_t> active(num_points);
+  std::iota(active.begin(), active.end(), 0);
+  std::vector<double> Xk(num_points * tdim, 0.0);
+  std::vector<double> Xk_next;
+
+  for (int k = 0; k < maxit and !active.empty(); ++k)
+  {
+    // Tabulate basis and first derivatives at all active points
+    const std::size_t num_active = active.size();
+    auto [tab, shape] = element.tabulate(
+        1, std::span<const double>(Xk.data(), num_active * tdim),
+        {num_active, tdim});
+    assert(shape[2] == num_xnodes);
+
+    std::size_t num_next = 0;
+    Xk_next.resize(num_active * tdim);
+    for (std::size_t q = 0; q < num_active; ++q)
+    {
+      const std::int32_t p = active[q];
+      const double* g = cell_geometry.data() + cells[p] * num_xnodes * gdim;
+
+      // x_k = phi * cell_geometry and J = cell_geometry^T * dphi^T
+      std::array<double, gdim> xk{};
+      std::array<double, gdim * tdim> J{};
+      for (std::size_t n = 0; n < num_xnodes; ++n)
+      {
+        const double phi = tab[q * num_xnodes + n];
+        std::array<double, tdim> dphi;
+        for (std::size_t l = 0; l < tdim; ++l)
+          dphi[l] = tab[((l + 1) * num_active + q) * num_xnodes + n];
+        for (std::size_t j = 0; j < gdim; ++j)
+        {
+          xk[j] += g[n * gdim + j] * phi;
+          for (std::size_t l = 0; l < tdim; ++l)
+            J[j * tdim + l] += g[n * gdim + j] * dphi[l];
+        }
+      }
+
+      std::array<double, tdim * gdim> K;
+      compute_jacobian_inverse<gdim, tdim>(J, K);
+
+      // dX = K * (x_p - x_k), X_k += dX
+      std::array<double, gdim> r;
+      for (std::size_t j = 0; j < gdim; ++j)
+        r[j] = x[p * gdim + j] - xk[j];
+      double dX2 = 0;
+      std::array<double, tdim> X1;
+      for (std::size_t i = 0; i < tdim; ++i)
+      {
+        double dX = 0;
+        for (std::size_t j = 0; j < gdim; ++j)
+          dX += K[i * gdim + j] * r[j];
+        X1[i] = Xk[q * tdim + i] + dX;
+        dX2 += dX * dX;
+      }
+
+      if (dX2 < tol2)
+        std::copy(X1.begin(), X1.end(), std::next(X.begin(), p * tdim));
+      else
+      {
+        // Keep point in the batch (compacted in place)
+        active[num_next] = p;
+        std::copy(X1.begin(), X1.end(),
+                  std::next(Xk_next.begin(), num_next * tdim));
+        ++num_next;
+      }
+    }
+
+    active.resize(num_next);
+    std::swap(Xk, Xk_next);
+  }
+
+  if (!active.empty())
+  {
+    throw std::runtime_error(
+        "Newton method failed to converge for non-affine geometry");
+  }
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 CoordinateElement::CoordinateElement(
     std::shared_ptr<const basix::FiniteElement> element)
@@ -184,6 +340,50 @@ void CoordinateElement::pull_back_nonaffine(
   }
 }
 //-----------------------------------------------------------------------------
+void CoordinateElement::pull_back_nonaffine(
+    std::span<double> X, std::span<const double> x,
+    std::span<const double> cell_geometry, std::span<const std::int32_t> cells,
+    std::size_t gdim, double tol, int maxit) const
+{
+  assert(_element);
+  const std::size_t tdim = mesh::cell_dim(this->cell_shape());
+  assert(X.size() == cells.size() * tdim);
+  assert(x.size() == cells.size() * gdim);
+  if (cells.empty())
+    return;
+
+  const basix::FiniteElement& e = *_element;
+  switch (gdim * 10 + tdim)
+  {
+  case 11:
+    pull_back_nonaffine_batched<1, 1>(e, X, x, cell_geometry, cells, tol,
+                                      maxit);
+    break;
+  case 21:
+    pull_back_nonaffine_batched<2, 1>(e, X, x, cell_geometry, cells, tol,
+                                      maxit);
+    break;
+  case 22:
+    pull_back_nonaffine_batched<2, 2>(e, X, x, cell_geometry, cells, tol,
+                                      maxit);
+    break;
+  case 31:
+    pull_back_nonaffine_batched<3, 1>(e, X, x, cell_geometry, cells, tol,
+                                      maxit);
+    break;
+  case 32:
+    pull_back_nonaffine_batched<3, 2>(e, X, x, cell_geometry, cells, tol,
+                                      maxit);
+    break;
+  case 33:
+    pull_back_nonaffine_batched<3, 3>(e, X, x, cell_geometry, cells, tol,
+                                      maxit);
+    break;
+  default:
+    throw std::runtime_error("Unsupported geometric/topological dimension.");
+  }
+}
+//-----------------------------------------------------------------------------
 void CoordinateElement::permute_dofs(const std::span<std::int32_t>& dofs,
                                      std::uint32_t cell_perm) const
 {
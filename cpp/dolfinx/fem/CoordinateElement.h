@@ -191,6 +191,35 @@ public:
                            const xt::xtensor<double, 2>& cell_geometry,
                            double tol = 1.0e-8, int maxit = 10) const;
 
+  /// @brief Compute reference coordinates X for a batch of physical
+  /// points x, each in a (possibly different) cell, for a non-affine
+  /// map.
+  ///
+  /// The Newton iterations for all points are advanced together, with
+  /// the basis evaluated for all unconverged points with one call to
+  /// tabulate per iteration. The Jacobian and its inverse are computed
+  /// with fixed-size arrays. Points that have converged are removed
+  /// from the batch.
+  ///
+  /// @param[out] X The reference coordinates (shape=(num_points,
+  /// tdim), row-major)
+  /// @param[in] x The physical coordinates (shape=(num_points, gdim),
+  /// row-major)
+  /// @param[in] cell_geometry The node coordinates of the cells
+  /// (shape=(num_cells, num geometry nodes, gdim), row-major)
+  /// @param[in] cells The position of the cell containing each point
+  /// in `cell_geometry` (size=num_points)
+  /// @param[in] gdim The geometric dimension
+  /// @param[in] tol Tolerance for termination of Newton method.
+  /// @param[in] maxit Maximum number of Newton iterations
+  /// @note If convergence is not achieved within maxit for all points,
+  /// the function throws a run-time error.
+  void pull_back_nonaffine(std::span<double> X, std::span<const double> x,
+                           std::span<const double> cell_geometry,
+                           std::span<const std::int32_t> cells,
+                           std::size_t gdim, double tol = 1.0e-8,
+                           int maxit = 10) const;
+
   /// Permutes a list of DOF numbers on a cell
   void permute_dofs(const std::span<std::int32_t>& dofs,
                     std::uint32_t cell_perm) const;
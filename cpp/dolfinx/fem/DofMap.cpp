@@ -124,7 +124,9 @@ fem::DofMap build_collapsed_dofmap(const DofMap& dofmap_view,
   // Create new dofmap and return
   return DofMap(
       std::move(element_dof_layout), index_map, 1,
-      graph::regular_adjacency_list(std::move(dofmap), cell_dimension), 1);
+      graph::regular_adjacency_list(std::move(dofmap), cell_dimension,
+                                    cells->num_nodes()),
+      1);
 }
 
 } // namespace
@@ -135,9 +137,16 @@ fem::transpose_dofmap(const graph::AdjacencyList<std::int32_t>& dofmap,
                       std::int32_t num_cells)
 {
   // Count number of cell contributions to each global index
-  const std::int32_t max_index = *std::max_element(
-      dofmap.array().begin(),
-      std::next(dofmap.array().begin(), dofmap.offsets()[num_cells]));
+  std::span<const std::int32_t> cell_dofs;
+  if (num_cells > 0)
+  {
+    auto dofs = dofmap.links(num_cells - 1);
+    cell_dofs = std::span(dofmap.array().data(), dofs.data() + dofs.size());
+  }
+  const std::int32_t max_index
+      = cell_dofs.empty()
+            ? -1
+            : *std::max_element(cell_dofs.begin(), cell_dofs.end());
 
   std::vector<int> num_local_contributions(max_index + 1, 0);
   for (int c = 0; c < num_cells; ++c)
@@ -214,7 +223,9 @@ DofMap DofMap::extract_sub_dofmap(const std::vector<int>& component) const
       = _element_dof_layout.sub_layout(component);
   return DofMap(
       std::move(sub_element_dof_layout), this->index_map, this->index_map_bs(),
-      graph::regular_adjacency_list(std::move(dofmap), dofs_per_cell), 1);
+      graph::regular_adjacency_list(std::move(dofmap), dofs_per_cell,
+                                    num_cells),
+      1);
 }
 //-----------------------------------------------------------------------------
 std::pair<DofMap, std::vector<std::int32_t>> DofMap::collapse(
@@ -12,6 +12,8 @@
 #include <basix/polyset.h>
 #include <dolfinx/common/log.h>
 #include <functional>
+#include <iterator>
+#include <mutex>
 #include <numeric>
 #include <ufcx.h>
 #include <utility>
@@ -261,7 +263,8 @@ FiniteElement::FiniteElement(const ufcx_finite_element& e)
 }
 //-----------------------------------------------------------------------------
 FiniteElement::FiniteElement(const basix::FiniteElement& element, int bs)
-    : _space_dim(bs * element.dim()), _value_shape(element.value_shape()),
+    : _cell_shape(mesh::cell_type_from_basix_type(element.cell_type())),
+      _space_dim(bs * element.dim()), _value_shape(element.value_shape()),
       _bs(bs)
 {
   if (_value_shape.empty() and bs > 1)
@@ -611,3 +614,115 @@ FiniteElement::get_dof_permutation_function(bool inverse,
   }
 }
 //-----------------------------------------------------------------------------
+std::shared_ptr<const FiniteElement::DofTransformationTable>
+FiniteElement::dof_transformation_table(
+    const std::span<const std::uint32_t>& signatures, bool inverse,
+    bool transpose, bool to_transpose) const
+{
+  assert(_element);
+  const int key = 4 * to_transpose + 2 * transpose + inverse;
+
+  std::scoped_lock lock(*_dof_transformation_mutex);
+  std::shared_ptr<const DofTransformationTable> table
+      = _dof_transformation_tables[key];
+
+  // Find signatures that are not yet in the table
+  std::vector<std::uint32_t> missing;
+  if (table)
+  {
+    std::copy_if(signatures.begin(), signatures.end(),
+                 std::back_inserter(missing),
+                 [&table](auto s) { return !table->index.contains(s); });
+    if (missing.empty())
+      return table;
+  }
+  else
+    missing.assign(signatures.begin(), signatures.end());
+
+  // Copy the existing table (tables that have been handed out are
+  // never modified) and extend it
+  auto new_table = table ? std::make_shared<DofTransformationTable>(*table)
+                         : std::make_shared<DofTransformationTable>();
+  if (!table)
+  {
+    // DOFs associated with edges and faces are the only DOFs that can
+    // be transformed
+    const std::vector<std::vector<std::vector<int>>>& entity_dofs
+        = _element->entity_dofs();
+    const int tdim = mesh::cell_dim(_cell_shape);
+    for (int d = 1; d < tdim; ++d)
+      for (auto& dofs : entity_dofs[d])
+        new_table->dofs.insert(new_table->dofs.end(), dofs.begin(), dofs.end());
+    std::sort(new_table->dofs.begin(), new_table->dofs.end());
+  }
+
+  // Compute the transformation matrix for each signature by applying
+  // the transformation to the identity (with block size equal to the
+  // number of DOFs)
+  const std::vector<int>& dofs = new_table->dofs;
+  const std::size_t n = _space_dim;
+  const std::size_t m = dofs.size();
+  std::vector<double> A(n * n);
+  std::vector<double> Am(m * m);
+  for (std::uint32_t s : missing)
+  {
+    std::fill(A.begin(), A.end(), 0.0);
+    for (std::size_t i = 0; i < n; ++i)
+      A[i * n + i] = 1.0;
+
+    std::span<double> data(A);
+    switch (key)
+    {
+    case 0:
+      apply_dof_transformation(data, s, n);
+      break;
+    case 1:
+      apply_inverse_dof_transformation(data, s, n);
+      break;
+    case 2:
+      apply_transpose_dof_transformation(data, s, n);
+      break;
+    case 3:
+      apply_inverse_transpose_dof_transformation(data, s, n);
+      break;
+    case 4:
+      apply_dof_transformation_to_transpose(data, s, n);
+      break;
+    case 5:
+      apply_inverse_dof_transformation_to_transpose(data, s, n);
+      break;
+    case 6:
+      apply_transpose_dof_transformation_to_transpose(data, s, n);
+      break;
+    case 7:
+      apply_inverse_transpose_dof_transformation_to_transpose(data, s, n);
+      break;
+    }
+
+    // Extract block for transformable DOFs and check for identity
+    bool identity = true;
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      for (std::size_t j = 0; j < m; ++j)
+      {
+        Am[i * m + j] = A[dofs[i] * n + dofs[j]];
+        if (Am[i * m + j] != (i == j ? 1.0 : 0.0))
+          identity = false;
+      }
+    }
+
+    if (identity)
+      new_table->index.insert({s, -1});
+    else
+    {
+      const std::int32_t pos = new_table->matrices.size() / (m * m);
+      new_table->index.insert({s, pos});
+      new_table->matrices.insert(new_table->matrices.end(), Am.begin(),
+                                 Am.end());
+    }
+  }
+
+  _dof_transformation_tables[key] = new_table;
+  return new_table;
+}
+//-----------------------------------------------------------------------------
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <array>
 #include <basix/finite-element.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <span>
+#include <unordered_map>
 #include <vector>
 #include <xtensor/xtensor.hpp>
 
@@ -485,6 +488,133 @@ public:
     }
   }
 
+  /// @brief Return a function that applies DOF transformations using
+  /// precomputed matrices.
+  ///
+  /// For each cell permutation signature in `signatures`, the DOF
+  /// transformation is computed once and stored as a small dense
+  /// matrix acting on the DOFs associated with edges and faces. The
+  /// matrices are cached on the element and reused by later calls.
+  /// Applying the transformation on a cell is then a table lookup and
+  /// a small dense matrix product. Signatures for which the
+  /// transformation is the identity are skipped.
+  ///
+  /// The returned function has the same arguments and behaviour as
+  /// the function returned by FiniteElement::get_dof_transformation_function
+  /// (if `to_transpose` is false) or
+  /// FiniteElement::get_dof_transformation_to_transpose_function (if
+  /// `to_transpose` is true). It can be applied only to cells whose
+  /// permutation signature appears in `signatures`.
+  ///
+  /// @note Precomputation is not supported for mixed and blocked
+  /// elements, in which case the non-precomputed function is returned.
+  ///
+  /// @param[in] signatures The distinct cell permutation signatures of
+  /// the cells that the function will be applied to (see
+  /// mesh::Topology::get_cell_permutation_signatures)
+  /// @param[in] inverse Indicates whether the inverse transformations
+  /// should be returned
+  /// @param[in] transpose Indicates whether the transpose
+  /// transformations should be returned
+  /// @param[in] to_transpose Indicates whether the transformation is
+  /// applied to transposed data
+  template <typename T>
+  std::function<void(const std::span<T>&, const std::span<const std::uint32_t>&,
+                     std::int32_t, int)>
+  get_precomputed_dof_transformation_function(
+      const std::span<const std::uint32_t>& signatures, bool inverse = false,
+      bool transpose = false, bool to_transpose = false) const
+  {
+    if (!needs_dof_transformations())
+    {
+      // If no permutation needed, return function that does nothing
+      return [](const std::span<T>&, const std::span<const std::uint32_t>&,
+                std::int32_t, int)
+      {
+        // Do nothing
+      };
+    }
+
+    if (!_sub_elements.empty())
+    {
+      if (to_transpose)
+      {
+        return get_dof_transformation_to_transpose_function<T>(inverse,
+                                                               transpose);
+      }
+      else
+        return get_dof_transformation_function<T>(inverse, transpose);
+    }
+
+    // The returned functions use a work array for each thread, so that
+    // they can be called concurrently
+    std::shared_ptr<const DofTransformationTable> table
+        = dof_transformation_table(signatures, inverse, transpose,
+                                   to_transpose);
+    if (to_transpose)
+    {
+      // data has shape (block_size, num_dofs), and data <- data N
+      return [table](const std::span<T>& data,
+                     const std::span<const std::uint32_t>& cell_info,
+                     std::int32_t cell, int block_size)
+      {
+        const double* N = table->matrix(cell_info[cell]);
+        if (!N)
+          return;
+
+        const std::vector<int>& dofs = table->dofs;
+        const std::size_t m = dofs.size();
+        const std::size_t ndofs = data.size() / block_size;
+        static thread_local std::vector<T> work;
+        work.resize(m);
+        for (int b = 0; b < block_size; ++b)
+        {
+          T* row = data.data() + b * ndofs;
+          for (std::size_t j = 0; j < m; ++j)
+            work[j] = row[dofs[j]];
+          for (std::size_t i = 0; i < m; ++i)
+          {
+            T r = 0;
+            for (std::size_t j = 0; j < m; ++j)
+              r += work[j] * static_cast<T>(N[j * m + i]);
+            row[dofs[i]] = r;
+          }
+        }
+      };
+    }
+    else
+    {
+      // data has shape (num_dofs, block_size), and data <- M data
+      return [table](const std::span<T>& data,
+                     const std::span<const std::uint32_t>& cell_info,
+                     std::int32_t cell, int block_size)
+      {
+        const double* M = table->matrix(cell_info[cell]);
+        if (!M)
+          return;
+
+        const std::vector<int>& dofs = table->dofs;
+        const std::size_t m = dofs.size();
+        static thread_local std::vector<T> work;
+        work.resize(m * block_size);
+        for (std::size_t j = 0; j < m; ++j)
+          for (int b = 0; b < block_size; ++b)
+            work[j * block_size + b] = data[dofs[j] * block_size + b];
+        for (std::size_t i = 0; i < m; ++i)
+        {
+          T* row = data.data() + dofs[i] * block_size;
+          std::fill_n(row, block_size, T(0));
+          for (std::size_t j = 0; j < m; ++j)
+          {
+            const T Mij = static_cast<T>(M[i * m + j]);
+            for (int b = 0; b < block_size; ++b)
+              row[b] += Mij * work[j * block_size + b];
+          }
+        }
+      };
+    }
+  }
+
   /// Apply DOF transformation to some data
   ///
   /// @param[in,out] data The data to be transformed. This data is flattened
@@ -648,6 +778,44 @@ public:
                                bool scalar_element = false) const;
 
 private:
+  // Dense DOF transformation matrices for a set of cell permutation
+  // signatures. The matrices act on the DOFs associated with edges and
+  // faces only (the transformation is the identity on all other DOFs).
+  struct DofTransformationTable
+  {
+    // Pointer to the (row-major) matrix for a signature, or nullptr if
+    // the transformation is the identity
+    const double* matrix(std::uint32_t cell_permutation) const
+    {
+      auto it = index.find(cell_permutation);
+      if (it == index.end())
+      {
+        throw std::runtime_error(
+            "Cell permutation is not in the DOF transformation table.");
+      }
+      return it->second < 0
+                 ? nullptr
+                 : matrices.data() + it->second * dofs.size() * dofs.size();
+    }
+
+    // DOFs that the matrices act on
+    std::vector<int> dofs;
+
+    // Position of the matrix for each signature in `matrices` (-1 for
+    // identity transformations)
+    std::unordered_map<std::uint32_t, std::int32_t> index;
+
+    // Matrices, each of shape (dofs.size(), dofs.size())
+    std::vector<double> matrices;
+  };
+
+  // Get the (cached) DOF transformation table containing the
+  // (distinct) signatures
+  std::shared_ptr<const DofTransformationTable>
+  dof_transformation_table(const std::span<const std::uint32_t>& signatures,
+                           bool inverse, bool transpose,
+                           bool to_transpose) const;
+
   std::string _signature, _family;
 
   mesh::CellType _cell_shape;
@@ -670,5 +838,14 @@ private:
 
   // Basix Element (nullptr for mixed elements)
   std::unique_ptr<basix::FiniteElement> _element;
+
+  // Cached DOF transformation tables, indexed by 4 * to_transpose + 2
+  // * transpose + inverse
+  mutable std::array<std::shared_ptr<const DofTransformationTable>, 8>
+      _dof_transformation_tables;
+
+  // Mutex for updating the cached DOF transformation tables
+  std::unique_ptr<std::mutex> _dof_transformation_mutex
+      = std::make_unique<std::mutex>();
 };
 } // namespace dolfinx::fem
@@ -324,6 +324,28 @@ public:
   /// @return True if cell permutation data is required
   bool needs_facet_permutations() const { return _needs_facet_permutations; }
 
+  /// @brief Get bool indicating whether the assemblers use precomputed
+  /// DOF transformations for this form.
+  ///
+  /// See FiniteElement::get_precomputed_dof_transformation_function.
+  /// @return True if precomputed DOF transformations are used
+  bool precompute_dof_transformations() const
+  {
+    return _precompute_dof_transformations;
+  }
+
+  /// @brief Set whether the assemblers use precomputed DOF
+  /// transformations for this form (default false).
+  ///
+  /// Precomputed transformations store a dense matrix on the element
+  /// for each cell permutation signature of the mesh. This can be
+  /// faster for high degree elements.
+  /// @param[in] precompute True to use precomputed transformations
+  void set_precompute_dof_transformations(bool precompute)
+  {
+    _precompute_dof_transformations = precompute;
+  }
+
   /// Offset for each coefficient expansion array on a cell. Used to
   /// pack data for multiple coefficients in a flat array. The last
   /// entry is the size required to store all coefficients.
@@ -663,5 +685,8 @@ private:
 
   // True if permutation data needs to be passed into these integrals
   bool _needs_facet_permutations;
+
+  // True if the assemblers use precomputed DOF transformations
+  bool _precompute_dof_transformations = false;
 };
 } // namespace dolfinx::fem
@@ -403,7 +403,33 @@ public:
     std::vector<double> detJ(x.shape(0));
     xt::xtensor<double, 4> phi(cmap.tabulate_shape(1, 1));
 
+    // For non-affine maps, pull back all points in one batch
+    std::vector<double> X_batch;
+    if (!cmap.is_affine())
+    {
+      std::vector<double> x_batch, geometry_batch;
+      std::vector<std::int32_t> cells_batch;
+      for (std::size_t p = 0; p < cells.size(); ++p)
+      {
+        if (cells[p] < 0)
+          continue;
+        for (std::int32_t dof : x_dofmap.links(cells[p]))
+        {
+          geometry_batch.insert(geometry_batch.end(),
+                                std::next(x_g.begin(), 3 * dof),
+                                std::next(x_g.begin(), 3 * dof + gdim));
+        }
+        for (std::size_t j = 0; j < gdim; ++j)
+          x_batch.push_back(x(p, j));
+        cells_batch.push_back(cells_batch.size());
+      }
+      X_batch.resize(cells_batch.size() * tdim);
+      cmap.pull_back_nonaffine(X_batch, x_batch, geometry_batch, cells_batch,
+                               gdim);
+    }
+
     xt::xtensor<double, 2> _Xp({1, tdim});
+    std::size_t q = 0;
     for (std::size_t p = 0; p < cells.size(); ++p)
     {
       const int cell_index = cells[p];
@@ -436,7 +462,7 @@ public:
       }
       else
       {
-        cmap.pull_back_nonaffine(_Xp, xp, coordinate_dofs);
+        std::copy_n(std::next(X_batch.begin(), q * tdim), tdim, _Xp.begin());
         cmap.tabulate(1, _Xp, phi);
         dphi = xt::view(phi, xt::range(1, tdim + 1), 0, xt::all(), 0);
         CoordinateElement::compute_jacobian(dphi, coordinate_dofs, _J);
@@ -446,6 +472,7 @@ public:
 
       for (std::size_t j = 0; j < X.shape(1); ++j)
         X(p, j) = _Xp(0, j);
+      ++q;
     }
 
     // Prepare basis function data structures
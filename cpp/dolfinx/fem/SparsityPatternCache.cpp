@@ -0,0 +1,68 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "SparsityPatternCache.h"
+#include <algorithm>
+#include <dolfinx/common/log.h>
+
+using namespace dolfinx;
+using namespace dolfinx::fem;
+
+//-----------------------------------------------------------------------------
+std::int64_t
+SparsityPatternCache::hash(std::span<const std::int32_t> entities)
+{
+  // 64-bit FNV-1a
+  std::uint64_t h = 14695981039346656037ull;
+  for (std::int32_t e : entities)
+  {
+    h ^= static_cast<std::uint32_t>(e);
+    h *= 1099511628211ull;
+  }
+
+  return static_cast<std::int64_t>(h);
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const la::SparsityPattern>
+SparsityPatternCache::find(
+    MPI_Comm comm, const Key& key,
+    std::span<const std::span<const std::int32_t>> entities)
+{
+  // Remove entries whose DofMaps have been destroyed
+  std::erase_if(_entries,
+                [](auto& e)
+                {
+                  return e.first.dofmaps[0].expired()
+                         or e.first.dofmaps[1].expired();
+                });
+
+  auto it = std::find_if(_entries.begin(), _entries.end(),
+                         [&key, entities](auto& e)
+                         { return e.first.matches(key, entities); });
+
+  // The pattern must be rebuilt (collectively) if it is missing on any
+  // rank
+  int found = it != _entries.end();
+  MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, comm);
+  if (found)
+  {
+    LOG(INFO) << "Reusing cached sparsity pattern";
+    return it->second;
+  }
+  else
+    return nullptr;
+}
+//-----------------------------------------------------------------------------
+void SparsityPatternCache::insert(
+    Key&& key, std::shared_ptr<const la::SparsityPattern> pattern)
+{
+  const std::vector<std::span<const std::int32_t>> entities(
+      key.entities.begin(), key.entities.end());
+  std::erase_if(_entries, [&key, &entities](auto& e)
+                { return e.first.matches(key, entities); });
+  _entries.emplace_back(std::move(key), pattern);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,194 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "Form.h"
+#include "FunctionSpace.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/la/SparsityPattern.h>
+#include <memory>
+#include <mpi.h>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// @brief Cache of assembled sparsity patterns for bilinear forms.
+///
+/// A pattern is shared by all forms that have the same test and trial
+/// DofMaps (the same objects, not equal copies) and the same
+/// integration domains. The domains are compared by integral type,
+/// subdomain id and integration entities. A hash of the entities is
+/// compared first, and the cache holds a copy of the entities so that
+/// a hash collision is not treated as a match. Patterns are
+/// returned as shared pointers, so a pattern remains valid while it is
+/// in use even if the cache is cleared. Entries whose DofMaps have been
+/// destroyed are removed on the next lookup.
+///
+/// @note The cache is not thread-safe.
+class SparsityPatternCache
+{
+public:
+  /// Create an empty cache
+  SparsityPatternCache() = default;
+
+  /// Copy constructor
+  SparsityPatternCache(const SparsityPatternCache& cache) = default;
+
+  /// Move constructor
+  SparsityPatternCache(SparsityPatternCache&& cache) = default;
+
+  /// Destructor
+  ~SparsityPatternCache() = default;
+
+  /// Copy assignment
+  SparsityPatternCache& operator=(const SparsityPatternCache& cache) = default;
+
+  /// Move assignment
+  SparsityPatternCache& operator=(SparsityPatternCache&& cache) = default;
+
+  /// @brief Get the assembled sparsity pattern for a bilinear form.
+  ///
+  /// If the cache holds a pattern for the spaces and integration
+  /// domains of `a` on all ranks, it is returned. Otherwise a pattern
+  /// is created, assembled and added to the cache.
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] a A bilinear form
+  /// @return The assembled sparsity pattern for `a`
+  template <typename T>
+  std::shared_ptr<const la::SparsityPattern> get(const Form<T>& a)
+  {
+    if (a.rank() != 2)
+    {
+      throw std::runtime_error(
+          "Cannot get sparsity pattern. Form is not a bilinear form");
+    }
+
+    Key key;
+    std::vector<std::span<const std::int32_t>> entities;
+    for (int i = 0; i < 2; ++i)
+    {
+      assert(a.function_spaces().at(i));
+      key.dofmaps[i] = a.function_spaces()[i]->dofmap();
+    }
+
+    for (auto type : a.integral_types())
+    {
+      for (int id : a.integral_ids(type))
+      {
+        std::span<const std::int32_t> e;
+        switch (type)
+        {
+        case IntegralType::cell:
+          e = a.cell_domains(id);
+          break;
+        case IntegralType::interior_facet:
+          e = a.interior_facet_domains(id);
+          break;
+        case IntegralType::exterior_facet:
+          e = a.exterior_facet_domains(id);
+          break;
+        default:
+          throw std::runtime_error("Unsupported integral type");
+        }
+        key.domains.push_back({static_cast<std::int64_t>(type), id,
+                               static_cast<std::int64_t>(e.size()),
+                               hash(e)});
+        entities.push_back(e);
+      }
+    }
+
+    assert(a.mesh());
+    MPI_Comm comm = a.mesh()->comm();
+    if (std::shared_ptr pattern = find(comm, key, entities); pattern)
+      return pattern;
+
+    // Store a copy of the entities with a new entry
+    for (auto e : entities)
+      key.entities.emplace_back(e.begin(), e.end());
+    auto pattern = std::make_shared<la::SparsityPattern>(
+        fem::create_sparsity_pattern(a));
+    pattern->assemble();
+    insert(std::move(key), pattern);
+    return pattern;
+  }
+
+  /// @brief Number of patterns in the cache
+  /// @note Entries with destroyed DofMaps are included until the next
+  /// lookup
+  std::size_t size() const { return _entries.size(); }
+
+  /// Remove all patterns from the cache
+  void clear() { _entries.clear(); }
+
+private:
+  // Key that identifies a sparsity pattern
+  struct Key
+  {
+    // Test and trial DofMaps
+    std::array<std::weak_ptr<const DofMap>, 2> dofmaps;
+
+    // (integral type, subdomain id, number of entities, hash of
+    // entities) for each integration domain
+    std::vector<std::array<std::int64_t, 4>> domains;
+
+    // Integration entities for each integration domain
+    std::vector<std::vector<std::int32_t>> entities;
+
+    // Check if the key has the same (live) DofMaps and domains as
+    // another key with integration entities `other_entities`. The
+    // entities are compared in place, and only if the hashes match.
+    bool
+    matches(const Key& other,
+            std::span<const std::span<const std::int32_t>> other_entities)
+        const
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        if (dofmaps[i].expired() or dofmaps[i].owner_before(other.dofmaps[i])
+            or other.dofmaps[i].owner_before(dofmaps[i]))
+        {
+          return false;
+        }
+      }
+      if (domains != other.domains)
+        return false;
+      assert(entities.size() == other_entities.size());
+      return std::equal(
+          entities.begin(), entities.end(), other_entities.begin(),
+          [](auto& e0, auto e1)
+          { return std::equal(e0.begin(), e0.end(), e1.begin()); });
+    }
+  };
+
+  // Hash a list of integration entities
+  static std::int64_t hash(std::span<const std::int32_t> entities);
+
+  // Find the pattern for a key (without stored entities) and its
+  // integration entities. Returns nullptr if the pattern is not in the
+  // cache on all ranks of comm. Removes expired entries.
+  std::shared_ptr<const la::SparsityPattern>
+  find(MPI_Comm comm, const Key& key,
+       std::span<const std::span<const std::int32_t>> entities);
+
+  // Add a pattern to the cache, replacing any entry with the same key
+  void insert(Key&& key, std::shared_ptr<const la::SparsityPattern> pattern);
+
+  // Cached patterns
+  std::vector<std::pair<Key, std::shared_ptr<const la::SparsityPattern>>>
+      _entries;
+};
+
+} // namespace dolfinx::fem
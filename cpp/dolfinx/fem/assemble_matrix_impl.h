@@ -411,26 +411,36 @@ void assemble_matrix(
       = a.function_spaces().at(0)->element();
   std::shared_ptr<const fem::FiniteElement> element1
       = a.function_spaces().at(1)->element();
-  const std::function<void(const std::span<T>&,
-                           const std::span<const std::uint32_t>&, std::int32_t,
-                           int)>& dof_transform
-      = element0->get_dof_transformation_function<T>();
-  const std::function<void(const std::span<T>&,
-                           const std::span<const std::uint32_t>&, std::int32_t,
-                           int)>& dof_transform_to_transpose
-      = element1->get_dof_transformation_to_transpose_function<T>();
-
   const bool needs_transformation_data
       = element0->needs_dof_transformations()
         or element1->needs_dof_transformations()
         or a.needs_facet_permutations();
-  std::span<const std::uint32_t> cell_info;
+  std::span<const std::uint32_t> cell_info, signatures;
   if (needs_transformation_data)
   {
     mesh->topology_mutable().create_entity_permutations();
     cell_info = std::span(mesh->topology().get_cell_permutation_info());
+    signatures
+        = std::span(mesh->topology().get_cell_permutation_signatures());
   }
 
+  const std::function<void(const std::span<T>&,
+                           const std::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      dof_transform
+      = a.precompute_dof_transformations()
+            ? element0->get_precomputed_dof_transformation_function<T>(
+                signatures)
+            : element0->get_dof_transformation_function<T>();
+  const std::function<void(const std::span<T>&,
+                           const std::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      dof_transform_to_transpose
+      = a.precompute_dof_transformations()
+            ? element1->get_precomputed_dof_transformation_function<T>(
+                signatures, false, false, true)
+            : element1->get_dof_transformation_to_transpose_function<T>();
+
   for (int i : a.integral_ids(IntegralType::cell))
   {
     const auto& fn = a.kernel(IntegralType::cell, i);
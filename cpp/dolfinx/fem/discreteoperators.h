@@ -9,12 +9,17 @@
 #include "DofMap.h"
 #include "FiniteElement.h"
 #include "FunctionSpace.h"
+#include <algorithm>
 #include <array>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Timer.h>
 #include <dolfinx/common/math.h>
 #include <dolfinx/common/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <memory>
+#include <numeric>
 #include <span>
 #include <vector>
 #include <xtensor/xadapt.hpp>
@@ -25,32 +30,24 @@
 namespace dolfinx::fem
 {
 
-/// @brief Assemble a discrete gradient operator.
-///
-/// The discrete gradient operator \f$A\f$ interpolates the gradient of
-/// a Lagrange finite element function in \f$V_0 \subset H^1\f$ into a
-/// Nédélec (first kind) space \f$V_1 \subset H({\rm curl})\f$, i.e.
-/// \f$\nabla V_0 \rightarrow V_1\f$. If \f$u_0\f$ is the
-/// degree-of-freedom vector associated with \f$V_0\f$, the hen
-/// \f$u_1=Au_0\f$ where \f$u_1\f$ is the degrees-of-freedom vector for
-/// interpolating function in the \f$H({\rm curl})\f$ space. An example
-/// of where discrete gradient operators are used is the creation of
-/// algebraic multigrid solvers for \f$H({\rm curl})\f$  and
-/// \f$H({\rm div})\f$ problems.
-///
-/// @note The sparsity pattern for a discrete operator can be
-/// initialised using sparsitybuild::cells. The space `V1` should be
-/// used for the rows of the sparsity pattern, `V0` for the columns.
+namespace impl
+{
+/// @brief Create a function that computes the discrete gradient
+/// element matrix for each cell in a list of cells.
 ///
-/// @warning This function relies on the user supplying appropriate
-/// input and output spaces. See parameter descriptions.
+/// The spaces are checked, and the data that is common to all cells is
+/// computed, when the function is created. The returned function only
+/// reads this data, so it can be called concurrently on different
+/// lists of cells.
 ///
 /// @param[in] V0 A Lagrange space to interpolate the gradient from
 /// @param[in] V1 A Nédélec (first kind) space to interpolate into
-/// @param[in] mat_set A functor that sets values in a matrix
-template <typename T, typename U>
-void discrete_gradient(const FunctionSpace& V0, const FunctionSpace& V1,
-                       U&& mat_set)
+/// @return Function `kernel(cells, cell_fn)` that calls `cell_fn(cell,
+/// Ae)` for each cell in `cells`, where `Ae` is the row-major element
+/// matrix with shape `(num dofs V1, num dofs V0)`
+template <typename T>
+auto discrete_gradient_kernel(const FunctionSpace& V0,
+                              const FunctionSpace& V1)
 {
   // Get mesh
   std::shared_ptr<const mesh::Mesh> mesh = V1.mesh();
@@ -97,14 +94,8 @@ void discrete_gradient(const FunctionSpace& V0, const FunctionSpace& V1,
 
   // Generate cell permutations
   mesh->topology_mutable().create_entity_permutations();
-  const std::vector<std::uint32_t>& cell_info
-      = mesh->topology().get_cell_permutation_info();
-
-  // Create element kernel function
-  std::shared_ptr<const DofMap> dofmap0 = V0.dofmap();
-  assert(dofmap0);
-  std::shared_ptr<const DofMap> dofmap1 = V1.dofmap();
-  assert(dofmap1);
+  std::span<const std::uint32_t> cell_info(
+      mesh->topology().get_cell_permutation_info());
 
   // Build the element interpolation matrix
   std::vector<T> A(e1->space_dimension() * ndofs0);
@@ -114,40 +105,37 @@ void discrete_gradient(const FunctionSpace& V0, const FunctionSpace& V1,
     math::dot(Pi, dphi_reshaped, _A);
   }
 
-  // Insert local interpolation matrix for each cell
-  auto cell_map = mesh->topology().index_map(tdim);
-  assert(cell_map);
-  std::int32_t num_cells = cell_map->size_local();
-  std::vector<T> Ae(A.size());
-  for (std::int32_t c = 0; c < num_cells; ++c)
+  // Compute local interpolation matrix for each cell
+  return [A = std::move(A), apply_inverse_dof_transform, cell_info,
+          ndofs0](std::span<const std::int32_t> cells, auto&& cell_fn)
   {
-    std::copy(A.cbegin(), A.cend(), Ae.begin());
-    apply_inverse_dof_transform(Ae, cell_info, c, ndofs0);
-    mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), Ae);
-  }
+    std::vector<T> Ae(A.size());
+    for (std::int32_t c : cells)
+    {
+      std::copy(A.cbegin(), A.cend(), Ae.begin());
+      apply_inverse_dof_transform(Ae, cell_info, c, ndofs0);
+      cell_fn(c, std::span<const T>(Ae));
+    }
+  };
 }
 
-/// @brief Assemble an interpolation operator matrix
+/// @brief Create a function that computes the interpolation operator
+/// element matrix for each cell in a list of cells.
 ///
-/// The interpolation operator \f$A\f$ interpolates a function in the
-/// space \f$V_0\f$ into a space \f$V_1\f$. If \f$u_0\f$ is the
-/// degree-of-freedom vector associated with \f$V_0\f$, then the
-/// degree-of-freedom vector \f$u_1\f$ for the interpolated function in
-/// \f$V_1\f$ is given by \f$u_1=Au_0\f$.
-///
-/// @note The sparsity pattern for a discrete operator can be
-/// initialised using sparsitybuild::cells. The space `V1` should be
-/// used for the rows of the sparsity pattern, `V0` for the columns.
+/// The data that is common to all cells is computed when the function
+/// is created. The returned function only reads this data, so it can
+/// be called concurrently on different lists of cells.
 ///
 /// @param[in] V0 The space to interpolate from
 /// @param[in] V1 The space to interpolate to
-/// @param[in] mat_set A functor that sets values in a matrix
-template <typename T, typename U>
-void interpolation_matrix(const FunctionSpace& V0, const FunctionSpace& V1,
-                          U&& mat_set)
+/// @return Function `kernel(cells, cell_fn)` that calls `cell_fn(cell,
+/// Ae)` for each cell in `cells`, where `Ae` is the row-major element
+/// matrix with shape `(num dofs V1, num dofs V0)`
+template <typename T>
+auto interpolation_kernel(const FunctionSpace& V0, const FunctionSpace& V1)
 {
   // Get mesh
-  auto mesh = V0.mesh();
+  std::shared_ptr<const mesh::Mesh> mesh = V0.mesh();
   assert(mesh);
 
   // Mesh dims
@@ -168,10 +156,6 @@ void interpolation_matrix(const FunctionSpace& V0, const FunctionSpace& V1,
     cell_info = std::span(mesh->topology().get_cell_permutation_info());
   }
 
-  // Get dofmaps
-  auto dofmap0 = V0.dofmap();
-  auto dofmap1 = V1.dofmap();
-
   // Get block sizes and dof transformation operators
   const int bs0 = element0->block_size();
   const int bs1 = element1->block_size();
@@ -186,19 +170,13 @@ void interpolation_matrix(const FunctionSpace& V0, const FunctionSpace& V1,
   const std::size_t dim0 = space_dim0 / bs0;
   const std::size_t value_size_ref0 = element0->reference_value_size() / bs0;
   const std::size_t value_size0 = element0->value_size() / bs0;
-  const std::size_t value_size1 = element1->value_size() / bs1;
-
-  // Get geometry data
-  const CoordinateElement& cmap = mesh->geometry().cmap();
-  const graph::AdjacencyList<std::int32_t>& x_dofmap
-      = mesh->geometry().dofmap();
-  const std::size_t num_dofs_g = cmap.dim();
-  std::span<const double> x_g = mesh->geometry().x();
+  const std::size_t value_size1 = element1->value_size();
 
   // Evaluate coordinate map basis at reference interpolation points
+  const CoordinateElement& cmap0 = mesh->geometry().cmap();
   const xt::xtensor<double, 2> X = element1->interpolation_points();
-  xt::xtensor<double, 4> phi(cmap.tabulate_shape(1, X.shape(0)));
-  cmap.tabulate(1, X, phi);
+  xt::xtensor<double, 4> phi(cmap0.tabulate_shape(1, X.shape(0)));
+  cmap0.tabulate(1, X, phi);
   const xt::xtensor<double, 2> dphi
       = xt::view(phi, xt::range(1, tdim + 1), 0, xt::all(), 0);
 
@@ -212,16 +190,10 @@ void interpolation_matrix(const FunctionSpace& V0, const FunctionSpace& V1,
   auto inds = xt::isclose(basis_derivatives_reference0, 0.0, rtol, atol);
   xt::filtration(basis_derivatives_reference0, inds) = 0.0;
 
-  // Create working arrays
-  xt::xtensor<double, 3> basis_reference0({X.shape(0), dim0, value_size_ref0});
-  xt::xtensor<double, 3> J({X.shape(0), gdim, tdim});
-  xt::xtensor<double, 3> K({X.shape(0), tdim, gdim});
-  std::vector<double> detJ(X.shape(0));
-
   // Get the interpolation operator (matrix) `Pi` that maps a function
   // evaluated at the interpolation points to the element degrees of
   // freedom, i.e. dofs = Pi f_x
-  const xt::xtensor<double, 2>& Pi_1 = element1->interpolation_operator();
+  const xt::xtensor<double, 2> Pi_1 = element1->interpolation_operator();
   bool interpolation_ident = element1->interpolation_ident();
 
   namespace stdex = std::experimental;
@@ -231,114 +203,412 @@ void interpolation_matrix(const FunctionSpace& V0, const FunctionSpace& V1,
   using K_t = stdex::mdspan<const double, stdex::dextents<std::size_t, 2>>;
   auto push_forward_fn0
       = element0->basix_element().map_fn<u_t, U_t, J_t, K_t>();
+  auto pull_back_fn1 = element1->basix_element().map_fn<u_t, U_t, K_t, J_t>();
 
-  // Basis values of Lagrange space unrolled for block size
-  // (num_quadrature_points, Lagrange dof, value_size)
-  xt::xtensor<double, 3> basis_values = xt::zeros<double>(
-      {X.shape(0), bs0 * dim0, (std::size_t)element1->value_size()});
-  xt::xtensor<double, 3> mapped_values(
-      {X.shape(0), bs0 * dim0, (std::size_t)element1->value_size()});
+  return [=](std::span<const std::int32_t> cells, auto&& cell_fn)
+  {
+    // Get geometry data
+    const CoordinateElement& cmap = mesh->geometry().cmap();
+    const graph::AdjacencyList<std::int32_t>& x_dofmap
+        = mesh->geometry().dofmap();
+    const std::size_t num_dofs_g = cmap.dim();
+    std::span<const double> x_g = mesh->geometry().x();
+
+    // Create working arrays
+    xt::xtensor<double, 3> basis_reference0(
+        {X.shape(0), dim0, value_size_ref0});
+    xt::xtensor<double, 3> J({X.shape(0), gdim, tdim});
+    xt::xtensor<double, 3> K({X.shape(0), tdim, gdim});
+    std::vector<double> detJ(X.shape(0));
+
+    // Basis values of Lagrange space unrolled for block size
+    // (num_quadrature_points, Lagrange dof, value_size)
+    xt::xtensor<double, 3> basis_values
+        = xt::zeros<double>({X.shape(0), bs0 * dim0, value_size1});
+    xt::xtensor<double, 3> mapped_values(
+        {X.shape(0), bs0 * dim0, value_size1});
+
+    xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, 3});
+    xt::xtensor<double, 3> basis0({X.shape(0), dim0, value_size0});
+    std::vector<T> A(space_dim0 * space_dim1);
+    std::vector<T> local1(space_dim1);
+
+    std::vector<std::size_t> shape = {X.shape(0), value_size1, space_dim0};
+    auto _A = xt::adapt(A, shape);
+
+    // Iterate over cells and interpolate on each cell
+    auto _coordinate_dofs
+        = xt::view(coordinate_dofs, xt::all(), xt::xrange(0, gdim));
+    for (std::int32_t c : cells)
+    {
+      // Get cell geometry (coordinate dofs)
+      auto x_dofs = x_dofmap.links(c);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        common::impl::copy_N<3>(std::next(x_g.begin(), 3 * x_dofs[i]),
+                                std::next(coordinate_dofs.begin(), 3 * i));
+      }
 
-  auto pull_back_fn1 = element1->basix_element().map_fn<u_t, U_t, K_t, J_t>();
+      // Compute Jacobians and reference points for current cell
+      J.fill(0);
+      for (std::size_t p = 0; p < X.shape(0); ++p)
+      {
+        auto _J = xt::view(J, p, xt::all(), xt::all());
+        cmap.compute_jacobian(dphi, _coordinate_dofs, _J);
+        cmap.compute_jacobian_inverse(_J,
+                                      xt::view(K, p, xt::all(), xt::all()));
+        detJ[p] = cmap.compute_jacobian_determinant(_J);
+      }
 
-  xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, 3});
-  xt::xtensor<double, 3> basis0({X.shape(0), dim0, value_size0});
-  std::vector<T> A(space_dim0 * space_dim1);
-  std::vector<T> local1(space_dim1);
+      // Get evaluated basis on reference, apply DOF transformations,
+      // and push forward to physical element
+      basis_reference0 = xt::view(basis_derivatives_reference0, 0,
+                                  xt::all(), xt::all(), xt::all());
+      for (std::size_t p = 0; p < X.shape(0); ++p)
+      {
+        apply_dof_transformation0(
+            std::span(basis_reference0.data() + p * dim0 * value_size_ref0,
+                      dim0 * value_size_ref0),
+            cell_info, c, value_size_ref0);
+      }
 
-  std::vector<std::size_t> shape
-      = {X.shape(0), (std::size_t)element1->value_size(), space_dim0};
-  auto _A = xt::adapt(A, shape);
+      for (std::size_t i = 0; i < basis0.shape(0); ++i)
+      {
+        u_t _u(basis0.data() + i * basis0.shape(1) * basis0.shape(2),
+               basis0.shape(1), basis0.shape(2));
+        U_t _U(basis_reference0.data()
+                   + i * basis_reference0.shape(1)
+                         * basis_reference0.shape(2),
+               basis_reference0.shape(1), basis_reference0.shape(2));
+        K_t _K(K.data() + i * K.shape(1) * K.shape(2), K.shape(1),
+               K.shape(2));
+        J_t _J(J.data() + i * J.shape(1) * J.shape(2), J.shape(1),
+               J.shape(2));
+        push_forward_fn0(_u, _U, _J, detJ[i], _K);
+      }
 
-  // Iterate over mesh and interpolate on each cell
-  auto cell_map = mesh->topology().index_map(tdim);
-  assert(cell_map);
-  std::int32_t num_cells = cell_map->size_local();
-  auto _coordinate_dofs
-      = xt::view(coordinate_dofs, xt::all(), xt::xrange(0, gdim));
-  for (std::int32_t c = 0; c < num_cells; ++c)
-  {
-    // Get cell geometry (coordinate dofs)
-    auto x_dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      common::impl::copy_N<3>(std::next(x_g.begin(), 3 * x_dofs[i]),
-                              std::next(coordinate_dofs.begin(), 3 * i));
-    }
+      // Unroll basis function for input space for block size
+      for (std::size_t p = 0; p < X.shape(0); ++p)
+        for (std::size_t i = 0; i < dim0; ++i)
+          for (std::size_t j = 0; j < value_size0; ++j)
+            for (int k = 0; k < bs0; ++k)
+              basis_values(p, i * bs0 + k, j * bs0 + k) = basis0(p, i, j);
 
-    // Compute Jacobians and reference points for current cell
-    J.fill(0);
-    for (std::size_t p = 0; p < X.shape(0); ++p)
-    {
-      auto _J = xt::view(J, p, xt::all(), xt::all());
-      cmap.compute_jacobian(dphi, _coordinate_dofs, _J);
-      cmap.compute_jacobian_inverse(_J, xt::view(K, p, xt::all(), xt::all()));
-      detJ[p] = cmap.compute_jacobian_determinant(_J);
-    }
+      // Pull back the physical values to the reference of output space
+      for (std::size_t p = 0; p < basis_values.shape(0); ++p)
+      {
+        U_t _u(basis_values.data()
+                   + p * basis_values.shape(1) * basis_values.shape(2),
+               basis_values.shape(1), basis_values.shape(2));
+        u_t _U(mapped_values.data()
+                   + p * mapped_values.shape(1) * mapped_values.shape(2),
+               mapped_values.shape(1), mapped_values.shape(2));
+        K_t _K(K.data() + p * K.shape(1) * K.shape(2), K.shape(1),
+               K.shape(2));
+        J_t _J(J.data() + p * J.shape(1) * J.shape(2), J.shape(1),
+               J.shape(2));
+        pull_back_fn1(_U, _u, _K, 1.0 / detJ[p], _J);
+      }
 
-    // Get evaluated basis on reference, apply DOF transformations, and
-    // push forward to physical element
-    basis_reference0 = xt::view(basis_derivatives_reference0, 0, xt::all(),
-                                xt::all(), xt::all());
-    for (std::size_t p = 0; p < X.shape(0); ++p)
-    {
-      apply_dof_transformation0(
-          std::span(basis_reference0.data() + p * dim0 * value_size_ref0,
-                    dim0 * value_size_ref0),
-          cell_info, c, value_size_ref0);
-    }
+      // Apply interpolation matrix to basis values of V0 at the
+      // interpolation points of V1
+      if (interpolation_ident)
+        _A.assign(xt::transpose(mapped_values, {0, 2, 1}));
+      else
+      {
+        for (std::size_t i = 0; i < mapped_values.shape(1); ++i)
+        {
+          auto _mapped_values
+              = xt::view(mapped_values, xt::all(), i, xt::all());
+          impl::interpolation_apply(Pi_1, _mapped_values, local1, bs1);
+          for (std::size_t j = 0; j < local1.size(); j++)
+            A[space_dim0 * j + i] = local1[j];
+        }
+      }
 
-    for (std::size_t i = 0; i < basis0.shape(0); ++i)
-    {
-      u_t _u(basis0.data() + i * basis0.shape(1) * basis0.shape(2),
-             basis0.shape(1), basis0.shape(2));
-      U_t _U(basis_reference0.data()
-                 + i * basis_reference0.shape(1) * basis_reference0.shape(2),
-             basis_reference0.shape(1), basis_reference0.shape(2));
-      K_t _K(K.data() + i * K.shape(1) * K.shape(2), K.shape(1), K.shape(2));
-      J_t _J(J.data() + i * J.shape(1) * J.shape(2), J.shape(1), J.shape(2));
-      push_forward_fn0(_u, _U, _J, detJ[i], _K);
+      apply_inverse_dof_transform1(A, cell_info, c, space_dim0);
+      cell_fn(c, std::span<const T>(A));
     }
+  };
+}
 
-    // Unroll basis function for input space for block size
-    for (std::size_t p = 0; p < X.shape(0); ++p)
-      for (std::size_t i = 0; i < dim0; ++i)
-        for (std::size_t j = 0; j < value_size0; ++j)
-          for (int k = 0; k < bs0; ++k)
-            basis_values(p, i * bs0 + k, j * bs0 + k) = basis0(p, i, j);
+/// @brief Build a discrete operator directly into a CSR matrix.
+///
+/// Each owned row of the operator is computed from a single cell, so
+/// rows associated with dofs on entities that are shared by cells are
+/// computed and inserted only once. Since the rows are disjoint, the
+/// cells can be processed concurrently without synchronisation.
+/// Entries that are exactly zero are not stored.
+///
+/// @param[in] V0 The space for the columns
+/// @param[in] V1 The space for the rows
+/// @param[in] kernel Function `kernel(cells, cell_fn)` that computes
+/// the element matrix on each cell in `cells` and passes it to
+/// `cell_fn(cell, Ae)`. It is called concurrently from `num_threads`
+/// threads, and must only read shared data.
+/// @param[in] num_threads Number of threads to compute the element
+/// matrices with
+/// @return The operator matrix
+template <typename T, typename Kernel>
+la::MatrixCSR<T> create_operator_csr(const FunctionSpace& V0,
+                                     const FunctionSpace& V1, Kernel&& kernel,
+                                     int num_threads)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = V1.mesh();
+  assert(mesh);
+  if (V0.mesh() != mesh)
+    throw std::runtime_error("Function spaces must share the same mesh.");
 
-    // Pull back the physical values to the reference of output space
-    for (std::size_t p = 0; p < basis_values.shape(0); ++p)
-    {
-      U_t _u(basis_values.data()
-                 + p * basis_values.shape(1) * basis_values.shape(2),
-             basis_values.shape(1), basis_values.shape(2));
-      u_t _U(mapped_values.data()
-                 + p * mapped_values.shape(1) * mapped_values.shape(2),
-             mapped_values.shape(1), mapped_values.shape(2));
-      K_t _K(K.data() + p * K.shape(1) * K.shape(2), K.shape(1), K.shape(2));
-      J_t _J(J.data() + p * J.shape(1) * J.shape(2), J.shape(1), J.shape(2));
-      pull_back_fn1(_U, _u, _K, 1.0 / detJ[p], _J);
-    }
+  std::shared_ptr<const DofMap> dofmap0 = V0.dofmap();
+  assert(dofmap0);
+  std::shared_ptr<const DofMap> dofmap1 = V1.dofmap();
+  assert(dofmap1);
+  if (dofmap0->index_map_bs() != 1 or dofmap1->index_map_bs() != 1)
+    throw std::runtime_error("Block size not yet supported");
 
-    // Apply interpolation matrix to basis values of V0 at the
-    // interpolation points of V1
-    if (interpolation_ident)
-      _A.assign(xt::transpose(mapped_values, {0, 2, 1}));
-    else
+  const int tdim = mesh->topology().dim();
+  auto cell_map = mesh->topology().index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_cells_owned = cell_map->size_local();
+  const std::int32_t num_cells = num_cells_owned + cell_map->num_ghosts();
+
+  std::shared_ptr<const common::IndexMap> map0 = dofmap0->index_map;
+  std::shared_ptr<const common::IndexMap> map1 = dofmap1->index_map;
+  const std::int32_t num_owned_rows = map1->size_local();
+
+  // Select the cell that computes each owned row. Owned cells take
+  // precedence (the last cell wins, as for repeated insertion), with
+  // ghost cells used only for rows that are not in an owned cell.
+  std::vector<std::int32_t> row_cell(num_owned_rows, -1);
+  for (std::int32_t c = 0; c < num_cells_owned; ++c)
+  {
+    for (std::int32_t r : dofmap1->cell_dofs(c))
+      if (r < num_owned_rows)
+        row_cell[r] = c;
+  }
+  for (std::int32_t c = num_cells_owned; c < num_cells; ++c)
+  {
+    for (std::int32_t r : dofmap1->cell_dofs(c))
+      if (r < num_owned_rows and row_cell[r] < 0)
+        row_cell[r] = c;
+  }
+
+  // Compute row pointers. Ghost rows are empty.
+  std::vector<std::int32_t> row_ptr(
+      map1->size_local() + map1->num_ghosts() + 1, 0);
+  for (std::int32_t r = 0; r < num_owned_rows; ++r)
+  {
+    if (std::int32_t c = row_cell[r]; c >= 0)
+      row_ptr[r + 1] = dofmap0->cell_dofs(c).size();
+  }
+  std::partial_sum(row_ptr.begin(), row_ptr.end(), row_ptr.begin());
+
+  // List of cells that compute at least one row
+  std::vector<std::int32_t> cells(row_cell);
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+  if (!cells.empty() and cells.front() < 0)
+    cells.erase(cells.begin());
+
+  // Compute element matrices for a range of cells and insert the rows
+  // that each cell is responsible for
+  std::vector<std::int32_t> cols(row_ptr.back());
+  std::vector<T> data(row_ptr.back());
+  auto compute = [&](std::span<const std::int32_t> cells)
+  {
+    std::vector<std::int32_t> perm;
+    kernel(cells,
+           [&](std::int32_t c, std::span<const T> Ae)
+           {
+             std::span<const std::int32_t> dofs0 = dofmap0->cell_dofs(c);
+             std::span<const std::int32_t> dofs1 = dofmap1->cell_dofs(c);
+
+             // Sort columns
+             perm.resize(dofs0.size());
+             std::iota(perm.begin(), perm.end(), 0);
+             std::sort(perm.begin(), perm.end(),
+                       [&dofs0](auto a, auto b)
+                       { return dofs0[a] < dofs0[b]; });
+
+             for (std::size_t i = 0; i < dofs1.size(); ++i)
+             {
+               const std::int32_t r = dofs1[i];
+               if (r < num_owned_rows and row_cell[r] == c)
+               {
+                 const std::size_t offset = row_ptr[r];
+                 for (std::size_t j = 0; j < perm.size(); ++j)
+                 {
+                   cols[offset + j] = dofs0[perm[j]];
+                   data[offset + j] = Ae[i * dofs0.size() + perm[j]];
+                 }
+               }
+             }
+           });
+  };
+
+  common::apply_blocks(cells.size(), num_threads,
+                       [&](std::int64_t c0, std::int64_t c1)
+                       {
+                         compute(std::span(cells.data() + c0,
+                                           cells.data() + c1));
+                       });
+
+  // Remove zero entries
+  {
+    std::int32_t pos = 0;
+    std::int32_t begin = row_ptr.front();
+    for (std::size_t r = 0; r < row_ptr.size() - 1; ++r)
     {
-      for (std::size_t i = 0; i < mapped_values.shape(1); ++i)
+      const std::int32_t end = row_ptr[r + 1];
+      for (std::int32_t j = begin; j < end; ++j)
       {
-        auto _mapped_values = xt::view(mapped_values, xt::all(), i, xt::all());
-        impl::interpolation_apply(Pi_1, _mapped_values, local1, bs1);
-        for (std::size_t j = 0; j < local1.size(); j++)
-          A[space_dim0 * j + i] = local1[j];
+        if (data[j] != T(0))
+        {
+          cols[pos] = cols[j];
+          data[pos] = data[j];
+          ++pos;
+        }
       }
+      begin = end;
+      row_ptr[r + 1] = pos;
     }
-
-    apply_inverse_dof_transform1(A, cell_info, c, space_dim0);
-    mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), A);
+    cols.resize(pos);
+    data.resize(pos);
   }
+
+  la::MatrixCSR<T> A({map1, map0}, {1, 1}, std::move(cols),
+                     std::move(row_ptr));
+  std::copy(data.begin(), data.end(), A.values().begin());
+  return A;
+}
+} // namespace impl
+
+/// @brief Assemble a discrete gradient operator.
+///
+/// The discrete gradient operator \f$A\f$ interpolates the gradient of
+/// a Lagrange finite element function in \f$V_0 \subset H^1\f$ into a
+/// Nédélec (first kind) space \f$V_1 \subset H({\rm curl})\f$, i.e.
+/// \f$\nabla V_0 \rightarrow V_1\f$. If \f$u_0\f$ is the
+/// degree-of-freedom vector associated with \f$V_0\f$, the hen
+/// \f$u_1=Au_0\f$ where \f$u_1\f$ is the degrees-of-freedom vector for
+/// interpolating function in the \f$H({\rm curl})\f$ space. An example
+/// of where discrete gradient operators are used is the creation of
+/// algebraic multigrid solvers for \f$H({\rm curl})\f$  and
+/// \f$H({\rm div})\f$ problems.
+///
+/// @note The sparsity pattern for a discrete operator can be
+/// initialised using sparsitybuild::cells. The space `V1` should be
+/// used for the rows of the sparsity pattern, `V0` for the columns.
+///
+/// @warning This function relies on the user supplying appropriate
+/// input and output spaces. See parameter descriptions.
+///
+/// @param[in] V0 A Lagrange space to interpolate the gradient from
+/// @param[in] V1 A Nédélec (first kind) space to interpolate into
+/// @param[in] mat_set A functor that sets values in a matrix
+template <typename T, typename U>
+void discrete_gradient(const FunctionSpace& V0, const FunctionSpace& V1,
+                       U&& mat_set)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = V1.mesh();
+  assert(mesh);
+  std::shared_ptr<const DofMap> dofmap0 = V0.dofmap();
+  assert(dofmap0);
+  std::shared_ptr<const DofMap> dofmap1 = V1.dofmap();
+  assert(dofmap1);
+
+  // Insert local interpolation matrix for each cell
+  auto cell_map = mesh->topology().index_map(mesh->topology().dim());
+  assert(cell_map);
+  std::vector<std::int32_t> cells(cell_map->size_local());
+  std::iota(cells.begin(), cells.end(), 0);
+  impl::discrete_gradient_kernel<T>(V0, V1)(
+      cells, [&](std::int32_t c, std::span<const T> Ae)
+      { mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), Ae); });
+}
+
+/// @brief Create a discrete gradient operator matrix.
+///
+/// The operator is the same as that assembled by discrete_gradient,
+/// but the non-zero structure and values are computed in one pass
+/// directly into a la::MatrixCSR, without building a
+/// la::SparsityPattern. Each row is computed once, and zero entries
+/// are not stored. No parallel communication is required to compute
+/// the entries.
+///
+/// @param[in] V0 A Lagrange space to interpolate the gradient from
+/// @param[in] V1 A Nédélec (first kind) space to interpolate into
+/// @param[in] num_threads Number of threads to use
+/// @return The discrete gradient operator. Rows are associated with
+/// `V1` and columns with `V0`.
+template <typename T>
+la::MatrixCSR<T> create_discrete_gradient(const FunctionSpace& V0,
+                                          const FunctionSpace& V1,
+                                          int num_threads = 1)
+{
+  common::Timer timer("Build discrete gradient (MatrixCSR)");
+  return impl::create_operator_csr<T>(
+      V0, V1, impl::discrete_gradient_kernel<T>(V0, V1), num_threads);
+}
+
+/// @brief Assemble an interpolation operator matrix
+///
+/// The interpolation operator \f$A\f$ interpolates a function in the
+/// space \f$V_0\f$ into a space \f$V_1\f$. If \f$u_0\f$ is the
+/// degree-of-freedom vector associated with \f$V_0\f$, then the
+/// degree-of-freedom vector \f$u_1\f$ for the interpolated function in
+/// \f$V_1\f$ is given by \f$u_1=Au_0\f$.
+///
+/// @note The sparsity pattern for a discrete operator can be
+/// initialised using sparsitybuild::cells. The space `V1` should be
+/// used for the rows of the sparsity pattern, `V0` for the columns.
+///
+/// @param[in] V0 The space to interpolate from
+/// @param[in] V1 The space to interpolate to
+/// @param[in] mat_set A functor that sets values in a matrix
+template <typename T, typename U>
+void interpolation_matrix(const FunctionSpace& V0, const FunctionSpace& V1,
+                          U&& mat_set)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = V0.mesh();
+  assert(mesh);
+  std::shared_ptr<const DofMap> dofmap0 = V0.dofmap();
+  assert(dofmap0);
+  std::shared_ptr<const DofMap> dofmap1 = V1.dofmap();
+  assert(dofmap1);
+
+  // Iterate over mesh and interpolate on each cell
+  auto cell_map = mesh->topology().index_map(mesh->topology().dim());
+  assert(cell_map);
+  std::vector<std::int32_t> cells(cell_map->size_local());
+  std::iota(cells.begin(), cells.end(), 0);
+  impl::interpolation_kernel<T>(V0, V1)(
+      cells, [&](std::int32_t c, std::span<const T> Ae)
+      { mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), Ae); });
+}
+
+/// @brief Create an interpolation operator matrix.
+///
+/// The operator is the same as that assembled by interpolation_matrix,
+/// but the non-zero structure and values are computed in one pass
+/// directly into a la::MatrixCSR, without building a
+/// la::SparsityPattern. Each row is computed once, and zero entries
+/// are not stored. No parallel communication is required to compute
+/// the entries.
+///
+/// @param[in] V0 The space to interpolate from
+/// @param[in] V1 The space to interpolate to
+/// @param[in] num_threads Number of threads to use
+/// @return The interpolation operator. Rows are associated with `V1`
+/// and columns with `V0`.
+template <typename T>
+la::MatrixCSR<T> create_interpolation_matrix(const FunctionSpace& V0,
+                                             const FunctionSpace& V1,
+                                             int num_threads = 1)
+{
+  common::Timer timer("Build interpolation matrix (MatrixCSR)");
+  return impl::create_operator_csr<T>(
+      V0, V1, impl::interpolation_kernel<T>(V0, V1), num_threads);
 }
 
 } // namespace dolfinx::fem
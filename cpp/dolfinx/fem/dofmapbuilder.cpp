@@ -318,6 +318,8 @@ build_basic_dofmap(const mesh::Topology& topology,
 /// @param [in] topology The mesh topology
 /// @param [in] reorder_fn Graph reordering function that is applied for
 /// dof re-ordering
+/// @param [in] interface_last If true, owned dofs that are ghosts on
+/// other processes are numbered after all other owned dofs
 /// @return The pair (old-to-new local index map, M), where M is the
 /// number of dofs owned by this process
 std::pair<std::vector<std::int32_t>, std::int32_t> compute_reordering_map(
@@ -325,7 +327,8 @@ std::pair<std::vector<std::int32_t>, std::int32_t> compute_reordering_map(
     const std::vector<std::pair<std::int8_t, std::int32_t>>& dof_entity,
     const mesh::Topology& topology,
     const std::function<std::vector<int>(
-        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
+        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
+    bool interface_last)
 {
   common::Timer t0("Compute dof reordering map");
 
@@ -395,6 +398,45 @@ std::pair<std::vector<std::int32_t>, std::int32_t> compute_reordering_map(
                    { return index < owned_size ? node_remap[index] : index; });
   }
 
+  if (interface_last)
+  {
+    // Mark owned dofs that are attached to mesh entities shared with
+    // other processes
+    std::vector<std::vector<std::int8_t>> shared_entity(D + 1);
+    for (int d = 0; d <= D; ++d)
+    {
+      if (auto map = topology.index_map(d); map)
+      {
+        shared_entity[d].resize(map->size_local(), false);
+        for (std::int32_t e : map->shared_indices())
+          shared_entity[d][e] = true;
+      }
+    }
+
+    std::vector<std::int8_t> shared(owned_size, false);
+    for (std::size_t dof = 0; dof < dof_entity.size(); ++dof)
+    {
+      if (const std::int32_t i = original_to_contiguous[dof]; i < owned_size)
+      {
+        auto [d, e] = dof_entity[dof];
+        shared[i] = shared_entity[d][e];
+      }
+    }
+
+    // Move shared dofs to the end of the owned range, preserving the
+    // relative order of interior and of shared dofs
+    std::vector<std::int32_t> remap(owned_size);
+    std::int32_t counter_interior = 0;
+    std::int32_t counter_shared
+        = owned_size - std::count(shared.begin(), shared.end(), true);
+    for (std::int32_t i = 0; i < owned_size; ++i)
+      remap[i] = shared[i] ? counter_shared++ : counter_interior++;
+    std::transform(original_to_contiguous.begin(), original_to_contiguous.end(),
+                   original_to_contiguous.begin(),
+                   [&remap, owned_size](auto index)
+                   { return index < owned_size ? remap[index] : index; });
+  }
+
   return {std::move(original_to_contiguous), owned_size};
 }
 //-----------------------------------------------------------------------------
@@ -572,7 +614,8 @@ fem::build_dofmap_data(
     MPI_Comm comm, const mesh::Topology& topology,
     const ElementDofLayout& element_dof_layout,
     const std::function<std::vector<int>(
-        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
+        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
+    bool interface_last)
 {
   common::Timer t0("Build dofmap data");
 
@@ -600,7 +643,8 @@ fem::build_dofmap_data(
   // Build re-ordering map for data locality and get number of owned
   // nodes
   const auto [old_to_new, num_owned]
-      = compute_reordering_map(node_graph0, dof_entity0, topology, reorder_fn);
+      = compute_reordering_map(node_graph0, dof_entity0, topology, reorder_fn,
+                               interface_last);
 
   // Get global indices for unowned dofs
   const auto [local_to_global_unowned, local_to_global_owner]
@@ -629,8 +673,8 @@ fem::build_dofmap_data(
 
   int dofs_per_cell
       = dofmap.empty() ? 0 : dofmap.size() / node_graph0.num_nodes();
-  graph::AdjacencyList<std::int32_t> dmap
-      = graph::regular_adjacency_list(std::move(dofmap), dofs_per_cell);
+  graph::AdjacencyList<std::int32_t> dmap = graph::regular_adjacency_list(
+      std::move(dofmap), dofs_per_cell, node_graph0.num_nodes());
 
   return {std::move(index_map), element_dof_layout.block_size(),
           std::move(dmap)};
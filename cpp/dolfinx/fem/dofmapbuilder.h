@@ -37,12 +37,18 @@ class ElementDofLayout;
 /// @param[in] element_dof_layout The element dof layout for the
 /// function space
 /// @param[in] reorder_fn Graph reordering function that is applied to
-/// the dofmap
+/// the graph of owned dofs, e.g. graph::reorder_gps or
+/// graph::reorder_rcm. If `nullptr`, dofs are numbered in the order in
+/// which they are first visited when iterating over cells.
+/// @param[in] interface_last If true, owned dofs that are ghosts on
+/// other processes are numbered after all other owned dofs (the
+/// relative order from `reorder_fn` is otherwise kept)
 /// @return The index map and local to global DOF data for the DOF map
 std::tuple<common::IndexMap, int, graph::AdjacencyList<std::int32_t>>
 build_dofmap_data(MPI_Comm comm, const mesh::Topology& topology,
                   const ElementDofLayout& element_dof_layout,
                   const std::function<std::vector<int>(
-                      const graph::AdjacencyList<std::int32_t>&)>& reorder_fn);
+                      const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
+                  bool interface_last = false);
 
 } // namespace dolfinx::fem
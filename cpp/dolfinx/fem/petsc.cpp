@@ -5,15 +5,22 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "petsc.h"
+#include "DofMap.h"
 #include "FunctionSpace.h"
+#include "SparsityPatternCache.h"
 #include "assembler.h"
 #include "sparsitybuild.h"
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/la/petsc.h>
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <petscistypes.h>
+#include <petscversion.h>
 #include <span>
+#include <stdexcept>
 
 using namespace dolfinx;
 
@@ -30,6 +37,14 @@ Mat fem::petsc::create_matrix(const Form<PetscScalar>& a,
   return la::petsc::create_matrix(a.mesh()->comm(), pattern, type);
 }
 //-----------------------------------------------------------------------------
+Mat fem::petsc::create_matrix(const Form<PetscScalar>& a,
+                              SparsityPatternCache& cache,
+                              const std::string& type)
+{
+  std::shared_ptr<const la::SparsityPattern> pattern = cache.get(a);
+  return la::petsc::create_matrix(a.mesh()->comm(), *pattern, type);
+}
+//-----------------------------------------------------------------------------
 Mat fem::petsc::create_matrix_block(
     const std::vector<std::vector<const Form<PetscScalar>*>>& a,
     const std::string& type)
@@ -421,3 +436,140 @@ void fem::petsc::set_bc(
   VecRestoreArray(b, &array);
 }
 //-----------------------------------------------------------------------------
+fem::petsc::MatrixAssemblerCOO::MatrixAssemblerCOO(Mat A,
+                                                   const Form<PetscScalar>& a)
+{
+#if PETSC_VERSION_LT(3, 16, 0)
+  throw std::runtime_error("COO matrix assembly requires PETSc 3.16 or later.");
+#else
+  common::Timer timer("Register COO pattern of bilinear form");
+
+  // Record the (unblocked) row and column of each element matrix entry,
+  // in the order that fem::assemble_matrix visits the integration
+  // domains
+  const DofMap& dofmap0 = *a.function_spaces().at(0)->dofmap();
+  const DofMap& dofmap1 = *a.function_spaces().at(1)->dofmap();
+  const int bs0 = dofmap0.bs();
+  const int bs1 = dofmap1.bs();
+  std::vector<PetscInt> coo_i, coo_j;
+  auto insert = [&coo_i, &coo_j, bs0,
+                 bs1](const std::span<const std::int32_t>& rows,
+                      const std::span<const std::int32_t>& cols)
+  {
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      for (int k0 = 0; k0 < bs0; ++k0)
+      {
+        for (std::size_t j = 0; j < cols.size(); ++j)
+        {
+          for (int k1 = 0; k1 < bs1; ++k1)
+          {
+            coo_i.push_back(bs0 * rows[i] + k0);
+            coo_j.push_back(bs1 * cols[j] + k1);
+          }
+        }
+      }
+    }
+  };
+
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    for (std::int32_t c : a.cell_domains(i))
+      insert(dofmap0.cell_dofs(c), dofmap1.cell_dofs(c));
+  }
+
+  for (int i : a.integral_ids(IntegralType::exterior_facet))
+  {
+    const std::vector<std::int32_t>& facets = a.exterior_facet_domains(i);
+    for (std::size_t index = 0; index < facets.size(); index += 2)
+    {
+      std::int32_t c = facets[index];
+      insert(dofmap0.cell_dofs(c), dofmap1.cell_dofs(c));
+    }
+  }
+
+  // Interior facet element matrices couple the dofs of both cells
+  std::array<std::vector<std::int32_t>, 2> macro_dofs;
+  for (int i : a.integral_ids(IntegralType::interior_facet))
+  {
+    const std::vector<std::int32_t>& facets = a.interior_facet_domains(i);
+    for (std::size_t index = 0; index < facets.size(); index += 4)
+    {
+      const std::array<std::int32_t, 2> cells
+          = {facets[index], facets[index + 2]};
+      for (int k = 0; k < 2; ++k)
+      {
+        const DofMap& dofmap = k == 0 ? dofmap0 : dofmap1;
+        auto dofs0 = dofmap.cell_dofs(cells[0]);
+        auto dofs1 = dofmap.cell_dofs(cells[1]);
+        macro_dofs[k].resize(dofs0.size() + dofs1.size());
+        std::copy(dofs0.begin(), dofs0.end(), macro_dofs[k].begin());
+        std::copy(dofs1.begin(), dofs1.end(),
+                  std::next(macro_dofs[k].begin(), dofs0.size()));
+      }
+      insert(macro_dofs[0], macro_dofs[1]);
+    }
+  }
+
+  _values.resize(coo_i.size());
+
+  // Note: PETSc may modify coo_i and coo_j
+  PetscErrorCode ierr = MatSetPreallocationCOOLocal(A, coo_i.size(),
+                                                    coo_i.data(), coo_j.data());
+  if (ierr != 0)
+    la::petsc::error(ierr, __FILE__, "MatSetPreallocationCOOLocal");
+#endif
+}
+//-----------------------------------------------------------------------------
+void fem::petsc::MatrixAssemblerCOO::assemble(
+    Mat A, const Form<PetscScalar>& a,
+    const std::span<const PetscScalar>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const PetscScalar>, int>>& coefficients,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    InsertMode mode)
+{
+  // Pack element matrices into the value buffer. fem::assemble_matrix
+  // ignores the return value of the insertion function, so a form with
+  // more entries than the pattern is an error here.
+  std::size_t pos = 0;
+  auto pack = [&pos, &values = _values](
+                  const std::span<const std::int32_t>&,
+                  const std::span<const std::int32_t>&,
+                  const std::span<const PetscScalar>& vals) -> int
+  {
+    if (pos + vals.size() > values.size())
+    {
+      throw std::runtime_error(
+          "Form does not match the COO pattern of the matrix assembler.");
+    }
+    std::copy(vals.begin(), vals.end(), std::next(values.begin(), pos));
+    pos += vals.size();
+    return 0;
+  };
+  fem::assemble_matrix(pack, a, constants, coefficients, bcs);
+  if (pos != _values.size())
+  {
+    throw std::runtime_error(
+        "Form does not match the COO pattern of the matrix assembler.");
+  }
+
+  PetscErrorCode ierr = MatSetValuesCOO(A, _values.data(), mode);
+  if (ierr != 0)
+    la::petsc::error(ierr, __FILE__, "MatSetValuesCOO");
+}
+//-----------------------------------------------------------------------------
+void fem::petsc::MatrixAssemblerCOO::assemble(
+    Mat A, const Form<PetscScalar>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    InsertMode mode)
+{
+  // Prepare constants and coefficients
+  const std::vector<PetscScalar> constants = pack_constants(a);
+  auto coefficients = allocate_coefficient_storage(a);
+  pack_coefficients(a, coefficients);
+
+  assemble(A, a, std::span(constants), make_coefficients_span(coefficients),
+           bcs, mode);
+}
+//-----------------------------------------------------------------------------
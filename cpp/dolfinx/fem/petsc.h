@@ -25,6 +25,7 @@ namespace dolfinx::fem
 template <typename T>
 class DirichletBC;
 class FunctionSpace;
+class SparsityPatternCache;
 
 /// Helper functions for assembly into PETSc data structures
 namespace petsc
@@ -38,6 +39,17 @@ namespace petsc
 Mat create_matrix(const Form<PetscScalar>& a,
                   const std::string& type = std::string());
 
+/// Create a matrix, reusing a cached sparsity pattern if possible
+/// @param[in] a A bilinear form
+/// @param[in,out] cache Cache of sparsity patterns. The pattern for
+/// `a` is added if it is not in the cache.
+/// @param[in] type The PETSc matrix type to create
+/// @return A sparse matrix with a layout and sparsity that matches the
+/// bilinear form. The caller is responsible for destroying the Mat
+/// object.
+Mat create_matrix(const Form<PetscScalar>& a, SparsityPatternCache& cache,
+                  const std::string& type = std::string());
+
 /// Initialise a monolithic matrix for an array of bilinear forms
 /// @param[in] a Rectangular array of bilinear forms. The `a(i, j)` form
 /// will correspond to the `(i, j)` block in the returned matrix
@@ -165,5 +177,72 @@ void set_bc(
     Vec b,
     const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
     const Vec x0, double scale = 1.0);
+
+// -- COO assembly -----------------------------------------------------------
+
+/// @brief Assembler of a bilinear form into a PETSc Mat using the PETSc
+/// COO interface.
+///
+/// The (row, column) indices of all element matrices are registered
+/// once with `MatSetPreallocationCOOLocal`. Each assembly then packs the
+/// element matrices, in the same order, into a single buffer that is
+/// passed to PETSc in one `MatSetValuesCOO` call. This avoids the search
+/// per entry of `MatSetValuesLocal`, and is well-suited to repeated
+/// assembly, e.g. in a Newton solver.
+///
+/// @note Requires PETSc 3.16 or later.
+class MatrixAssemblerCOO
+{
+public:
+  /// @brief Register the COO pattern of a bilinear form with a matrix.
+  ///
+  /// The pattern is computed from the dofmaps and the integration
+  /// domains of the form. No kernels are executed.
+  ///
+  /// @note Collective
+  /// @param[in,out] A The matrix, e.g. created by
+  /// fem::petsc::create_matrix. Its local-to-global maps must be set.
+  /// Its non-zero structure is replaced by the pattern of `a`.
+  /// @param[in] a The bilinear form
+  MatrixAssemblerCOO(Mat A, const Form<PetscScalar>& a);
+
+  /// @brief Assemble a bilinear form into a matrix.
+  ///
+  /// @note Collective. The matrix does not require a call to
+  /// `MatAssemblyBegin/End` after assembly.
+  /// @param[in,out] A The matrix passed to the constructor
+  /// @param[in] a The bilinear form passed to the constructor, or a
+  /// form with the same spaces and integration domains
+  /// @param[in] constants Constants that appear in `a`
+  /// @param[in] coefficients Coefficients that appear in `a`
+  /// @param[in] bcs Boundary conditions to apply. For boundary
+  /// condition dofs the row and column are zeroed. The diagonal entry
+  /// is not set.
+  /// @param[in] mode INSERT_VALUES to replace the matrix values or
+  /// ADD_VALUES to add to them
+  void assemble(
+      Mat A, const Form<PetscScalar>& a,
+      const std::span<const PetscScalar>& constants,
+      const std::map<std::pair<IntegralType, int>,
+                     std::pair<std::span<const PetscScalar>, int>>&
+          coefficients,
+      const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+      InsertMode mode = INSERT_VALUES);
+
+  /// @brief Assemble a bilinear form into a matrix, packing the
+  /// constants and coefficients of the form.
+  /// @see MatrixAssemblerCOO::assemble
+  void assemble(
+      Mat A, const Form<PetscScalar>& a,
+      const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+      InsertMode mode = INSERT_VALUES);
+
+  /// Number of COO entries, i.e. the total size of all element matrices
+  std::size_t size() const { return _values.size(); }
+
+private:
+  // Element matrix values, packed in assembly order
+  std::vector<PetscScalar> _values;
+};
 } // namespace petsc
 } // namespace dolfinx::fem
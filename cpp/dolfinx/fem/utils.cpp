@@ -141,7 +141,7 @@ fem::create_dofmap(MPI_Comm comm, const ElementDofLayout& layout,
                    mesh::Topology& topology,
                    const std::function<std::vector<int>(
                        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
-                   const FiniteElement& element)
+                   const FiniteElement& element, bool interface_last)
 {
   // Create required mesh entities
   const int D = topology.dim();
@@ -162,7 +162,7 @@ fem::create_dofmap(MPI_Comm comm, const ElementDofLayout& layout,
   }
 
   auto [_index_map, bs, dofmap]
-      = build_dofmap_data(comm, topology, layout, reorder_fn);
+      = build_dofmap_data(comm, topology, layout, reorder_fn, interface_last);
   auto index_map = std::make_shared<common::IndexMap>(std::move(_index_map));
 
   // If the element's DOF transformations are permutations, permute the
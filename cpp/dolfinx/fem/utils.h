@@ -14,6 +14,7 @@
 #include "Form.h"
 #include "Function.h"
 #include "sparsitybuild.h"
+#include <dolfinx/common/utils.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <functional>
@@ -109,12 +110,27 @@ la::SparsityPattern create_sparsity_pattern(
     const std::set<IntegralType>& integrals);
 
 /// @brief Create a sparsity pattern for a given form.
+///
+/// By default the entries are inserted in a single pass, and further
+/// entries (e.g. for the diagonal) can be inserted by the caller. If
+/// `two_pass` is true, the pattern is built in two passes over the
+/// integration domains (see la::SparsityPattern::count_begin), which
+/// reduces the peak memory use at the cost of inserting the entries
+/// twice. A two-pass pattern is returned with exactly the counted
+/// storage, so no further entries can be inserted.
+///
 /// @note The pattern is not finalised, i.e. the caller is responsible
 /// for calling SparsityPattern::assemble.
 /// @param[in] a A bilinear form
+/// @param[in] two_pass Build the pattern in two passes
+/// @param[in] num_threads The number of threads used to insert entries
+/// in a two-pass build. Single pass insertion is not thread-safe and
+/// always uses one thread.
 /// @return The corresponding sparsity pattern
 template <typename T>
-la::SparsityPattern create_sparsity_pattern(const Form<T>& a)
+la::SparsityPattern create_sparsity_pattern(const Form<T>& a,
+                                            bool two_pass = false,
+                                            int num_threads = 1)
 {
   if (a.rank() != 2)
   {
@@ -147,40 +163,79 @@ la::SparsityPattern create_sparsity_pattern(const Form<T>& a)
   const std::array bs
       = {dofmaps[0].get().index_map_bs(), dofmaps[1].get().index_map_bs()};
 
-  // Create and build sparsity pattern
-  la::SparsityPattern pattern(mesh->comm(), index_maps, bs);
-  for (auto type : types)
+  // Call f(entities) for blocks of the entities of an integration
+  // domain, where each entity is stored as `stride` values, with one
+  // block per thread
+  auto apply_threaded = [num_threads = two_pass ? num_threads : 1](
+                            std::span<const std::int32_t> entities,
+                            int stride, auto&& f)
   {
-    std::vector<int> ids = a.integral_ids(type);
-    switch (type)
+    common::apply_blocks(entities.size() / stride, num_threads,
+                         [&](std::int64_t e0, std::int64_t e1)
+                         {
+                           f(entities.subspan(stride * e0,
+                                              stride * (e1 - e0)));
+                         });
+  };
+
+  // Insert entries for all integration domains
+  auto insert = [&](la::SparsityPattern& pattern)
+  {
+    for (auto type : types)
     {
-    case IntegralType::cell:
-      for (int id : ids)
-      {
-        const std::vector<std::int32_t>& cells = a.cell_domains(id);
-        sparsitybuild::cells(pattern, cells, {{dofmaps[0], dofmaps[1]}});
-      }
-      break;
-    case IntegralType::interior_facet:
-      for (int id : ids)
+      std::vector<int> ids = a.integral_ids(type);
+      switch (type)
       {
-        const std::vector<std::int32_t>& facets = a.interior_facet_domains(id);
-        sparsitybuild::interior_facets(pattern, facets,
-                                       {{dofmaps[0], dofmaps[1]}});
+      case IntegralType::cell:
+        for (int id : ids)
+        {
+          apply_threaded(a.cell_domains(id), 1,
+                         [&](std::span<const std::int32_t> cells)
+                         {
+                           sparsitybuild::cells(pattern, cells,
+                                                {{dofmaps[0], dofmaps[1]}});
+                         });
+        }
+        break;
+      case IntegralType::interior_facet:
+        for (int id : ids)
+        {
+          apply_threaded(a.interior_facet_domains(id), 4,
+                         [&](std::span<const std::int32_t> facets)
+                         {
+                           sparsitybuild::interior_facets(
+                               pattern, facets, {{dofmaps[0], dofmaps[1]}});
+                         });
+        }
+        break;
+      case IntegralType::exterior_facet:
+        for (int id : ids)
+        {
+          apply_threaded(a.exterior_facet_domains(id), 2,
+                         [&](std::span<const std::int32_t> facets)
+                         {
+                           sparsitybuild::exterior_facets(
+                               pattern, facets, {{dofmaps[0], dofmaps[1]}});
+                         });
+        }
+        break;
+      default:
+        throw std::runtime_error("Unsupported integral type");
       }
-      break;
-    case IntegralType::exterior_facet:
-      for (int id : ids)
-      {
-        const std::vector<std::int32_t>& facets = a.exterior_facet_domains(id);
-        sparsitybuild::exterior_facets(pattern, facets,
-                                       {{dofmaps[0], dofmaps[1]}});
-      }
-      break;
-    default:
-      throw std::runtime_error("Unsupported integral type");
     }
+  };
+
+  // Create and build sparsity pattern. In a two-pass build the first
+  // pass counts the entries in each row, and the second pass inserts
+  // them.
+  la::SparsityPattern pattern(mesh->comm(), index_maps, bs);
+  if (two_pass)
+  {
+    pattern.count_begin();
+    insert(pattern);
+    pattern.count_end();
   }
+  insert(pattern);
 
   t0.stop();
 
@@ -200,13 +255,15 @@ ElementDofLayout create_element_dof_layout(const ufcx_dofmap& dofmap,
 /// @param[in] element The finite element
 /// @param[in] reorder_fn The graph reordering function called on the
 /// dofmap
+/// @param[in] interface_last If true, owned dofs that are shared with
+/// other processes are numbered after all other owned dofs
 /// @return A new dof map
 DofMap
 create_dofmap(MPI_Comm comm, const ElementDofLayout& layout,
               mesh::Topology& topology,
               const std::function<std::vector<int>(
                   const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
-              const FiniteElement& element);
+              const FiniteElement& element, bool interface_last = false);
 
 /// Get the name of each coefficient in a UFC form
 /// @param[in] ufcx_form The UFC form
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <mutex>
 #include <numeric>
 #include <sstream>
 #include <utility>
@@ -41,6 +43,11 @@ auto create_adjacency_data(const xt::xtensor<T, 2>& array)
 /// contiguous list of nodes [0, 1, 2, ..., n) it stores the connected
 /// nodes. The representation is strictly local, i.e. it is not parallel
 /// aware.
+///
+/// If every node has the same number of links (constant degree), the
+/// offsets are not stored and the links for node `i` start at position
+/// `i * degree()` in the data array. The size of the data array of a
+/// constant degree list must not be changed.
 template <typename T>
 class AdjacencyList
 {
@@ -48,10 +55,10 @@ public:
   /// Construct trivial adjacency list where each of the n nodes is
   /// connected to itself
   /// @param [in] n Number of nodes
-  explicit AdjacencyList(const std::int32_t n) : _array(n), _offsets(n + 1)
+  explicit AdjacencyList(const std::int32_t n)
+      : _array(n), _degree(1), _num_nodes(n)
   {
     std::iota(_array.begin(), _array.end(), 0);
-    std::iota(_offsets.begin(), _offsets.end(), 0);
   }
 
   /// Construct adjacency list from arrays of data
@@ -64,12 +71,32 @@ public:
           std::is_same<std::vector<T>, std::decay_t<U>>::value
           && std::is_same<std::vector<std::int32_t>, std::decay_t<V>>::value>>
   AdjacencyList(U&& data, V&& offsets)
-      : _array(std::forward<U>(data)), _offsets(std::forward<V>(offsets))
+      : _array(std::forward<U>(data)), _offsets(std::forward<V>(offsets)),
+        _num_nodes(_offsets.size() - 1)
   {
     _array.reserve(_offsets.back());
     assert(_offsets.back() == (std::int32_t)_array.size());
   }
 
+  /// Construct a constant degree adjacency list from an array of data
+  /// @param [in] data Adjacency array, where the links for node `i` are
+  /// `data[i * degree, (i + 1) * degree)`
+  /// @param [in] degree The number of links for each node
+  /// @param [in] num_nodes The number of nodes. If negative, it is
+  /// computed from the size of `data`, in which case a list with
+  /// `degree` zero has no nodes.
+  template <typename U, typename = std::enable_if_t<std::is_same<
+                            std::vector<T>, std::decay_t<U>>::value>>
+  AdjacencyList(U&& data, int degree, std::int32_t num_nodes = -1)
+      : _array(std::forward<U>(data)), _degree(degree), _num_nodes(num_nodes)
+  {
+    assert(degree >= 0);
+    assert(degree == 0 ? _array.empty() : _array.size() % degree == 0);
+    if (_num_nodes < 0)
+      _num_nodes = degree == 0 ? 0 : _array.size() / degree;
+    assert(std::size_t(_num_nodes) * degree == _array.size());
+  }
+
   /// Set all connections for all entities (T is a '2D' container, e.g.
   /// a `std::vector<<std::vector<std::size_t>>`,
   /// `std::vector<<std::set<std::size_t>>`, etc).
@@ -87,41 +114,93 @@ public:
     _array.reserve(_offsets.back());
     for (auto e = data.begin(); e != data.end(); ++e)
       _array.insert(_array.end(), e->begin(), e->end());
+
+    _num_nodes = data.size();
   }
 
   /// Copy constructor
-  AdjacencyList(const AdjacencyList& list) = default;
+  AdjacencyList(const AdjacencyList& list)
+      : _array(list._array), _offsets(list._degree < 0
+                                          ? list._offsets
+                                          : std::vector<std::int32_t>()),
+        _degree(list._degree), _num_nodes(list._num_nodes)
+  {
+  }
 
   /// Move constructor
-  AdjacencyList(AdjacencyList&& list) = default;
+  /// @note The moved-from list is left as an empty list
+  AdjacencyList(AdjacencyList&& list) noexcept
+      : _array(std::move(list._array)), _offsets(std::move(list._offsets)),
+        _offsets_built(list._offsets_built.load()), _degree(list._degree),
+        _num_nodes(list._num_nodes)
+  {
+    list.reset();
+  }
 
   /// Destructor
   ~AdjacencyList() = default;
 
   /// Assignment operator
-  AdjacencyList& operator=(const AdjacencyList& list) = default;
+  AdjacencyList& operator=(const AdjacencyList& list)
+  {
+    *this = AdjacencyList(list);
+    return *this;
+  }
 
   /// Move assignment operator
-  AdjacencyList& operator=(AdjacencyList&& list) = default;
+  /// @note The moved-from list is left as an empty list
+  AdjacencyList& operator=(AdjacencyList&& list) noexcept
+  {
+    if (this != &list)
+    {
+      _array = std::move(list._array);
+      _offsets = std::move(list._offsets);
+      _offsets_built = list._offsets_built.load();
+      _degree = list._degree;
+      _num_nodes = list._num_nodes;
+      list.reset();
+    }
+    return *this;
+  }
 
   /// Equality operator
   /// @return True is the adjacency lists are equal
   bool operator==(const AdjacencyList& list) const
   {
-    return this->_array == list._array and this->_offsets == list._offsets;
+    if (this->_num_nodes != list._num_nodes or this->_array != list._array)
+      return false;
+    else if (this->_degree >= 0 and list._degree >= 0)
+      return this->_degree == list._degree;
+    else if (this->_degree < 0 and list._degree < 0)
+      return this->_offsets == list._offsets;
+    else
+    {
+      for (std::int32_t i = 0; i < this->num_nodes(); ++i)
+      {
+        if (this->num_links(i) != list.num_links(i))
+          return false;
+      }
+      return true;
+    }
   }
 
   /// Get the number of nodes
   /// @return The number of nodes in the adjacency list
-  std::int32_t num_nodes() const { return _offsets.size() - 1; }
+  std::int32_t num_nodes() const { return _num_nodes; }
+
+  /// Number of links for each node if the adjacency list has constant
+  /// degree
+  /// @return The number of links for each node, or -1 if the number
+  /// of links is not (known to be) constant
+  int degree() const { return _degree; }
 
   /// Number of connections for given node
   /// @param [in] node Node index
   /// @return The number of outgoing links (edges) from the node
   int num_links(int node) const
   {
-    assert((node + 1) < (int)_offsets.size());
-    return _offsets[node + 1] - _offsets[node];
+    assert(node < num_nodes());
+    return _degree < 0 ? _offsets[node + 1] - _offsets[node] : _degree;
   }
 
   /// Get the links (edges) for given node
@@ -130,8 +209,16 @@ public:
   /// AdjacencyList::num_links(node).
   std::span<T> links(int node)
   {
-    return std::span<T>(_array.data() + _offsets[node],
-                        _offsets[node + 1] - _offsets[node]);
+    if (_degree < 0)
+    {
+      return std::span<T>(_array.data() + _offsets[node],
+                          _offsets[node + 1] - _offsets[node]);
+    }
+    else
+    {
+      return std::span<T>(_array.data() + std::size_t(node) * _degree,
+                          _degree);
+    }
   }
 
   /// Get the links (edges) for given node (const version)
@@ -140,8 +227,16 @@ public:
   /// AdjacencyList:num_links(node).
   std::span<const T> links(int node) const
   {
-    return std::span<const T>(_array.data() + _offsets[node],
-                              _offsets[node + 1] - _offsets[node]);
+    if (_degree < 0)
+    {
+      return std::span<const T>(_array.data() + _offsets[node],
+                                _offsets[node + 1] - _offsets[node]);
+    }
+    else
+    {
+      return std::span<const T>(_array.data() + std::size_t(node) * _degree,
+                                _degree);
+    }
   }
 
   /// Return contiguous array of links for all nodes (const version)
@@ -150,11 +245,25 @@ public:
   /// Return contiguous array of links for all nodes
   std::vector<T>& array() { return _array; }
 
-  /// Offset for each node in array() (const version)
-  const std::vector<std::int32_t>& offsets() const { return _offsets; }
-
   /// Offset for each node in array()
-  std::vector<std::int32_t>& offsets() { return _offsets; }
+  /// @note Offsets are not stored for constant degree adjacency lists.
+  /// They are computed (thread-safely) on the first call to this
+  /// function. Prefer AdjacencyList::links and AdjacencyList::degree.
+  const std::vector<std::int32_t>& offsets() const
+  {
+    if (_degree >= 0 and !_offsets_built.load(std::memory_order_acquire))
+    {
+      std::scoped_lock lock(_offsets_mutex);
+      if (!_offsets_built.load(std::memory_order_relaxed))
+      {
+        _offsets.resize(_num_nodes + 1);
+        for (std::size_t i = 0; i < _offsets.size(); ++i)
+          _offsets[i] = i * _degree;
+        _offsets_built.store(true, std::memory_order_release);
+      }
+    }
+    return _offsets;
+  }
 
   /// Informal string representation (pretty-print)
   /// @return String representation of the adjacency list
@@ -163,7 +272,7 @@ public:
     std::stringstream s;
     s << "<AdjacencyList> with " + std::to_string(this->num_nodes()) + " nodes"
       << std::endl;
-    for (std::size_t e = 0; e < _offsets.size() - 1; ++e)
+    for (std::int32_t e = 0; e < this->num_nodes(); ++e)
     {
       s << "  " << e << ": [";
       for (auto link : this->links(e))
@@ -174,11 +283,34 @@ public:
   }
 
 private:
+  // Make this an empty constant degree list (used for moved-from lists)
+  void reset() noexcept
+  {
+    _array.clear();
+    _offsets.clear();
+    _offsets_built = false;
+    _degree = 0;
+    _num_nodes = 0;
+  }
+
   // Connections for all entities stored as a contiguous array
   std::vector<T> _array;
 
-  // Position of first connection for each entity (using local index)
-  std::vector<std::int32_t> _offsets;
+  // Position of first connection for each entity (using local index).
+  // Not stored for constant degree lists (computed on demand by
+  // offsets()).
+  mutable std::vector<std::int32_t> _offsets;
+
+  // True if _offsets has been computed for a constant degree list, and
+  // the mutex for computing it. The mutex is not moved or copied.
+  mutable std::atomic<bool> _offsets_built = false;
+  mutable std::mutex _offsets_mutex;
+
+  // Number of connections for each entity, or -1 if not constant
+  int _degree = -1;
+
+  // Number of nodes
+  std::int32_t _num_nodes = 0;
 };
 
 /// @brief Construct a constant degree (valency) adjacency list.
@@ -186,10 +318,12 @@ private:
 /// A constant degree graph has the same number of edges for every node.
 /// @param [in] data Adjacency array
 /// @param [in] degree The number of (outgoing) edges for each node
+/// @param [in] num_nodes The number of nodes. If negative, it is
+/// computed from the size of `data` (zero if `degree` is zero).
 /// @return An adjacency list
 template <typename U>
-AdjacencyList<typename U::value_type> regular_adjacency_list(U&& data,
-                                                             int degree)
+AdjacencyList<typename U::value_type>
+regular_adjacency_list(U&& data, int degree, std::int32_t num_nodes = -1)
 {
   if (degree == 0 and !data.empty())
   {
@@ -203,12 +337,14 @@ AdjacencyList<typename U::value_type> regular_adjacency_list(U&& data,
         "Incompatible data size and degree for constant degree AdjacencyList");
   }
 
-  std::int32_t num_nodes = degree == 0 ? data.size() : data.size() / degree;
-  std::vector<std::int32_t> offsets(num_nodes + 1, 0);
-  for (std::size_t i = 1; i < offsets.size(); ++i)
-    offsets[i] = offsets[i - 1] + degree;
-  return AdjacencyList<typename U::value_type>(std::forward<U>(data),
-                                               std::move(offsets));
+  if (num_nodes >= 0 and std::size_t(num_nodes) * degree != data.size())
+  {
+    throw std::runtime_error("Incompatible data size and number of nodes for "
+                             "constant degree AdjacencyList");
+  }
+
+  return AdjacencyList<typename U::value_type>(std::forward<U>(data), degree,
+                                               num_nodes);
 }
 
 } // namespace dolfinx::graph
@@ -6,11 +6,14 @@
 
 #include "ordering.h"
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
 
 using namespace dolfinx;
 
@@ -95,7 +98,7 @@ create_level_structure(const graph::AdjacencyList<int>& graph, int s)
   int l = 0;
 
   std::vector<int> level_offsets = {0};
-  level_offsets.reserve(graph.offsets().size());
+  level_offsets.reserve(graph.num_nodes() + 1);
   std::vector<int> level_structure = {s};
   level_structure.reserve(graph.array().size());
   while (static_cast<int>(level_structure.size()) > level_offsets.back())
@@ -119,6 +122,52 @@ create_level_structure(const graph::AdjacencyList<int>& graph, int s)
                                    std::move(level_offsets));
 }
 
+//-----------------------------------------------------------------------------
+// Find a pseudo-peripheral node in the connected component of graph
+// that contains node s. The array depth (size graph.num_nodes()) must
+// be -1 for all nodes in the component, and is reset before return.
+int pseudo_peripheral_node(const graph::AdjacencyList<int>& graph, int s,
+                           std::vector<int>& depth)
+{
+  int eccentricity = -1;
+  std::vector<int> queue;
+  while (true)
+  {
+    // Breadth-first search from s
+    queue.assign(1, s);
+    depth[s] = 0;
+    for (std::size_t i = 0; i < queue.size(); ++i)
+    {
+      for (int w : graph.links(queue[i]))
+      {
+        if (depth[w] < 0)
+        {
+          depth[w] = depth[queue[i]] + 1;
+          queue.push_back(w);
+        }
+      }
+    }
+
+    // Pick node of minimum degree in the last level
+    const int e = depth[queue.back()];
+    int next = queue.back();
+    for (auto it = queue.rbegin(); it != queue.rend() and depth[*it] == e;
+         ++it)
+    {
+      if (graph.num_links(*it) < graph.num_links(next))
+        next = *it;
+    }
+
+    for (int v : queue)
+      depth[v] = -1;
+
+    // Stop when the eccentricity no longer increases
+    if (e <= eccentricity)
+      return s;
+    eccentricity = e;
+    s = next;
+  }
+}
 //-----------------------------------------------------------------------------
 // Gibbs-Poole-Stockmeyer algorithm, finding a reordering for the given
 // graph, operating only on nodes which are yet unlabelled (indicated
@@ -351,6 +400,48 @@ gps_reorder_unlabelled(const graph::AdjacencyList<std::int32_t>& graph,
 
   return rv;
 }
+//-----------------------------------------------------------------------------
+// Index along the Hilbert curve of the grid cell with integer
+// coordinates X (b bits each) in n dimensions. The coordinates are
+// converted in place to the 'transposed' Hilbert index (Skilling,
+// 2004), the bits of which are interleaved to give the index.
+std::uint64_t hilbert_index(std::array<std::uint32_t, 3>& X, int b, int n)
+{
+  // Inverse undo excess work
+  const std::uint32_t M = std::uint32_t(1) << (b - 1);
+  for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+  {
+    const std::uint32_t P = Q - 1;
+    for (int i = 0; i < n; ++i)
+    {
+      if (X[i] & Q)
+        X[0] ^= P;
+      else
+      {
+        const std::uint32_t t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for (int i = 1; i < n; ++i)
+    X[i] ^= X[i - 1];
+  std::uint32_t t = 0;
+  for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    if (X[n - 1] & Q)
+      t ^= Q - 1;
+  for (int i = 0; i < n; ++i)
+    X[i] ^= t;
+
+  // Interleave the bits, most significant first
+  std::uint64_t h = 0;
+  for (int j = b - 1; j >= 0; --j)
+    for (int i = 0; i < n; ++i)
+      h = (h << 1) | ((X[i] >> j) & 1);
+  return h;
+}
 
 } // namespace
 
@@ -379,3 +470,108 @@ graph::reorder_gps(const graph::AdjacencyList<std::int32_t>& graph)
   return r;
 }
 //-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+graph::reorder_rcm(const graph::AdjacencyList<std::int32_t>& graph)
+{
+  common::Timer timer("Reverse Cuthill-McKee ordering");
+
+  const std::int32_t n = graph.num_nodes();
+  std::vector<int> depth(n, -1);
+  std::vector<std::int8_t> labelled(n, false);
+
+  // Cuthill-McKee ordering, processing each connected component in
+  // turn
+  std::vector<int> order;
+  order.reserve(n);
+  std::vector<int> nbrs;
+  for (std::int32_t r = 0; r < n; ++r)
+  {
+    if (labelled[r])
+      continue;
+
+    const int s = pseudo_peripheral_node(graph, r, depth);
+    std::size_t c = order.size();
+    order.push_back(s);
+    labelled[s] = true;
+    for (; c < order.size(); ++c)
+    {
+      // Add unlabelled neighbours in order of increasing degree
+      nbrs.clear();
+      for (int w : graph.links(order[c]))
+      {
+        if (!labelled[w])
+        {
+          labelled[w] = true;
+          nbrs.push_back(w);
+        }
+      }
+      std::stable_sort(nbrs.begin(), nbrs.end(), [&graph](int a, int b)
+                       { return graph.num_links(a) < graph.num_links(b); });
+      order.insert(order.end(), nbrs.begin(), nbrs.end());
+    }
+  }
+
+  // Reverse the ordering
+  std::vector<std::int32_t> map(n);
+  for (std::int32_t i = 0; i < n; ++i)
+    map[order[i]] = n - 1 - i;
+
+  return map;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t> graph::reorder_hilbert(std::span<const double> x,
+                                                 int gdim)
+{
+  common::Timer timer("Hilbert curve ordering");
+
+  if (gdim < 1 or gdim > 3)
+    throw std::runtime_error("Hilbert ordering needs gdim 1, 2 or 3.");
+  assert(x.size() % gdim == 0);
+  const std::int32_t n = x.size() / gdim;
+  if (n == 0)
+    return std::vector<std::int32_t>();
+
+  // Cubic bounding box of the points
+  std::array<double, 3> x0;
+  double L = 0;
+  for (int d = 0; d < gdim; ++d)
+  {
+    double xmin = std::numeric_limits<double>::max();
+    double xmax = std::numeric_limits<double>::lowest();
+    for (std::int32_t i = 0; i < n; ++i)
+    {
+      xmin = std::min(xmin, x[i * gdim + d]);
+      xmax = std::max(xmax, x[i * gdim + d]);
+    }
+    x0[d] = xmin;
+    L = std::max(L, xmax - xmin);
+  }
+
+  // Index along the curve of the grid cell containing each point
+  constexpr int b = 21;
+  const double scale = L > 0 ? double(1 << b) / L : 0;
+  std::vector<std::uint64_t> h(n);
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    std::array<std::uint32_t, 3> X = {0, 0, 0};
+    for (int d = 0; d < gdim; ++d)
+    {
+      const double c = (x[i * gdim + d] - x0[d]) * scale;
+      X[d] = std::min<double>(c, (1 << b) - 1);
+    }
+    h[i] = hilbert_index(X, b, gdim);
+  }
+
+  // Number the points in order along the curve
+  std::vector<std::int32_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&h](std::int32_t p, std::int32_t q)
+                   { return h[p] < h[q]; });
+  std::vector<std::int32_t> map(n);
+  for (std::int32_t i = 0; i < n; ++i)
+    map[order[i]] = i;
+
+  return map;
+}
+//-----------------------------------------------------------------------------
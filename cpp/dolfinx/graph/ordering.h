@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace dolfinx::graph
@@ -28,4 +29,42 @@ class AdjacencyList;
 std::vector<std::int32_t>
 reorder_gps(const graph::AdjacencyList<std::int32_t>& graph);
 
+/// @brief Re-order a graph using the reverse Cuthill-McKee algorithm.
+///
+/// Each connected component is numbered by a breadth-first search
+/// from a pseudo-peripheral node, visiting neighbours in order of
+/// increasing degree. The resulting numbering is then reversed. The
+/// algorithm is described in
+///
+/// Reducing the bandwidth of sparse symmetric matrices, Proceedings of
+/// the 24th National Conference of the ACM, 157-172, 1969,
+/// https://doi.org/10.1145/800195.805928.
+///
+/// @param[in] graph The (symmetric) graph to compute a re-ordering for
+/// @return Reordering array `map`, where `map[i]` is the new index of
+/// node `i`
+std::vector<std::int32_t>
+reorder_rcm(const graph::AdjacencyList<std::int32_t>& graph);
+
+/// @brief Re-order points along a Hilbert space-filling curve.
+///
+/// The points are mapped onto a grid with 2^21 cells in each
+/// direction, covering the (cubic) bounding box of the points, and
+/// are numbered in the order that the Hilbert curve through the grid
+/// visits them. Points that are close in space are then mostly close
+/// in the numbering. Unlike the graph based orderings, this needs no
+/// connectivity and is cheap to compute. The index along the curve is
+/// computed using the algorithm in
+///
+/// J. Skilling, Programming the Hilbert curve, AIP Conference
+/// Proceedings 707, 381-387, 2004, https://doi.org/10.1063/1.1751381.
+///
+/// @param[in] x Point coordinates, `shape=(num_points, gdim)` and
+/// row-major storage
+/// @param[in] gdim Geometric dimension of the points (1, 2 or 3)
+/// @return Reordering array `map`, where `map[i]` is the new index of
+/// point `i`
+std::vector<std::int32_t> reorder_hilbert(std::span<const double> x,
+                                          int gdim);
+
 } // namespace dolfinx::graph
\ No newline at end of file
@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include "MultiVector.h"
 #include "SparsityPattern.h"
+#include "Vector.h"
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <mpi.h>
 #include <numeric>
@@ -106,6 +109,58 @@ void add_csr(U&& data, const V& cols, const V& row_ptr, const W& x,
     }
   }
 }
+
+/// @brief Insert a dense block of values into a block compressed
+/// sparse row (BSR) matrix.
+///
+/// @param[out] data The BSR matrix data. The `bs0` by `bs1` blocks are
+/// stored contiguously (row-major) in the order of `cols`.
+/// @param[in] cols The BSR (block) column indices
+/// @param[in] row_ptr The pointer to the ith block row in `cols`
+/// @param[in] x The `m * bs0` by `n * bs1` dense block of values
+/// (row-major) to insert into the matrix
+/// @param[in] xrows The block row indices of `x`
+/// @param[in] xcols The block column indices of `x`
+/// @param[in] op The operation applied to a matrix entry and a value
+/// from `x`, e.g. set or add
+/// @param[in] bs0 Row block size
+/// @param[in] bs1 Column block size
+template <typename U, typename V, typename W, typename X, typename OP>
+void insert_blocked_csr(U&& data, const V& cols, const V& row_ptr, const W& x,
+                        const X& xrows, const X& xcols, OP op, int bs0,
+                        int bs1)
+{
+  const std::size_t nbs = bs0 * bs1;
+  const std::size_t ncols = xcols.size() * bs1;
+  assert(x.size() == xrows.size() * xcols.size() * nbs);
+  for (std::size_t r = 0; r < xrows.size(); ++r)
+  {
+    // Row index and current data row
+    auto row = xrows[r];
+    using T = typename W::value_type;
+    const T* xr = x.data() + r * bs0 * ncols;
+
+#ifndef NDEBUG
+    if (row >= (int)row_ptr.size())
+      throw std::runtime_error("Local row out of range");
+#endif
+
+    // Columns indices for row
+    auto cit0 = std::next(cols.begin(), row_ptr[row]);
+    auto cit1 = std::next(cols.begin(), row_ptr[row + 1]);
+    for (std::size_t c = 0; c < xcols.size(); ++c)
+    {
+      // Find position of column index
+      auto it = std::lower_bound(cit0, cit1, xcols[c]);
+      assert(it != cit1);
+      std::size_t d = std::distance(cols.begin(), it) * nbs;
+      assert(d < data.size());
+      for (int k0 = 0; k0 < bs0; ++k0)
+        for (int k1 = 0; k1 < bs1; ++k1)
+          op(data[d + k0 * bs1 + k1], xr[k0 * ncols + c * bs1 + k1]);
+    }
+  }
+}
 } // namespace impl
 
 /// Distributed sparse matrix
@@ -113,6 +168,15 @@ void add_csr(U&& data, const V& cols, const V& row_ptr, const W& x,
 /// The matrix storage format is compressed sparse row. The matrix is
 /// partitioned row-wise across MPI rank.
 ///
+/// If the row or column block size is greater than one, the matrix is
+/// stored in block compressed sparse row (BSR) format. Row pointers and
+/// column indices then refer to blocks, and the values of each `bs0` by
+/// `bs1` block are stored contiguously (row-major). Indices passed to
+/// MatrixCSR::set and MatrixCSR::add are block indices, as in the
+/// blocked insertion functions for PETSc matrices. Functions that
+/// insert single (unblocked) entries, e.g. fem::set_diagonal, are
+/// therefore not supported for block sizes greater than one.
+///
 /// @tparam T The data type for the matrix
 /// @tparam Allocator The memory allocator type for the data storage
 ///
@@ -120,8 +184,6 @@ void add_csr(U&& data, const V& cols, const V& row_ptr, const W& x,
 /// can be assembled into using the usual dolfinx assembly routines
 /// Matrix internal data can be accessed for interfacing with other
 /// code.
-///
-/// @todo Handle block sizes
 template <typename T, class Allocator = std::allocator<T>>
 class MatrixCSR
 {
@@ -168,23 +230,60 @@ public:
   /// distribution and the non-zero structure
   /// @param[in] alloc The memory allocator for the data storafe
   MatrixCSR(const SparsityPattern& p, const Allocator& alloc = Allocator())
-      : _index_maps({p.index_map(0),
-                     std::make_shared<common::IndexMap>(p.column_index_map())}),
-        _bs({p.block_size(0), p.block_size(1)}),
-        _data(p.num_nonzeros(), 0, alloc),
-        _cols(p.graph().array().begin(), p.graph().array().end()),
-        _row_ptr(p.graph().offsets().begin(), p.graph().offsets().end()),
-        _comm(MPI_COMM_NULL)
+      : MatrixCSR({p.index_map(0), std::make_shared<common::IndexMap>(
+                                       p.column_index_map())},
+                  {p.block_size(0), p.block_size(1)},
+                  std::vector<std::int32_t>(p.graph().array().begin(),
+                                            p.graph().array().end()),
+                  std::vector<std::int32_t>(p.graph().offsets().begin(),
+                                            p.graph().offsets().end()),
+                  alloc)
+  {
+  }
+
+  /// @brief Create a distributed matrix from compressed sparse row
+  /// data.
+  ///
+  /// This constructor is used when the non-zero structure has been
+  /// computed directly, e.g. by an operator builder, and bypasses the
+  /// creation of a SparsityPattern.
+  ///
+  /// @param[in] maps Index maps for the row (0) and column (1) spaces.
+  /// The column map must contain all ghost columns that appear in
+  /// `cols`.
+  /// @param[in] bs Block sizes for the row and column maps
+  /// @param[in] cols (Block) column indices (local) for each row,
+  /// including ghost rows. The column indices on each row must be
+  /// sorted.
+  /// @param[in] row_ptr Offset into `cols` for each (block) row. The
+  /// size is the number of rows (owned and ghost) plus one.
+  /// @param[in] alloc The memory allocator for the data storage
+  MatrixCSR(const std::array<std::shared_ptr<const common::IndexMap>, 2>& maps,
+            const std::array<int, 2>& bs, std::vector<std::int32_t>&& cols,
+            std::vector<std::int32_t>&& row_ptr,
+            const Allocator& alloc = Allocator())
+      : _index_maps(maps), _bs(bs),
+        _data(cols.size() * bs[0] * bs[1], 0, alloc), _cols(std::move(cols)),
+        _row_ptr(std::move(row_ptr)), _comm(MPI_COMM_NULL)
   {
-    // TODO: handle block sizes
-    if (_bs[0] > 1 or _bs[1] > 1)
-      throw std::runtime_error("Block size not yet supported");
+    if (_row_ptr.size()
+        != std::size_t(_index_maps[0]->size_local()
+                       + _index_maps[0]->num_ghosts() + 1))
+    {
+      throw std::runtime_error("Row pointer size and row map mismatch.");
+    }
 
-    // Compute off-diagonal offset for each row
-    std::span<const std::int32_t> num_diag_nnz = p.off_diagonal_offset();
-    _off_diagonal_offset.reserve(num_diag_nnz.size());
-    std::transform(num_diag_nnz.begin(), num_diag_nnz.end(), _row_ptr.begin(),
-                   std::back_inserter(_off_diagonal_offset), std::plus{});
+    // Compute off-diagonal offset for each row (owned columns precede
+    // ghost columns in sorted local numbering)
+    const std::int32_t local_size1 = _index_maps[1]->size_local();
+    _off_diagonal_offset.reserve(_row_ptr.size() - 1);
+    for (std::size_t r = 0; r < _row_ptr.size() - 1; ++r)
+    {
+      auto cit0 = std::next(_cols.begin(), _row_ptr[r]);
+      auto cit1 = std::next(_cols.begin(), _row_ptr[r + 1]);
+      _off_diagonal_offset.push_back(std::distance(
+          _cols.begin(), std::lower_bound(cit0, cit1, local_size1)));
+    }
 
     // Some short-hand
     const std::array local_size
@@ -285,11 +384,24 @@ public:
                              recv_disp.data(), MPI_INT64_T, _comm.comm());
     }
 
-    // Store receive displacements for future use, when transferring
-    // data values
+    // Store send and receive displacements for future use, when
+    // transferring data values (bs0 * bs1 values for each block)
+    const int nbs = _bs[0] * _bs[1];
+    std::transform(_val_send_disp.begin(), _val_send_disp.end(),
+                   _val_send_disp.begin(), [nbs](int d) { return d * nbs; });
     _val_recv_disp.resize(recv_disp.size());
     std::transform(recv_disp.begin(), recv_disp.end(), _val_recv_disp.begin(),
-                   [](int d) { return d / 2; });
+                   [nbs](int d) { return nbs * d / 2; });
+
+    // Data sizes for send and receive, and buffers, for finalize
+    _val_send_count.resize(_val_send_disp.size() - 1);
+    std::adjacent_difference(std::next(_val_send_disp.begin()),
+                             _val_send_disp.end(), _val_send_count.begin());
+    _val_recv_count.resize(_val_recv_disp.size() - 1);
+    std::adjacent_difference(std::next(_val_recv_disp.begin()),
+                             _val_recv_disp.end(), _val_recv_count.begin());
+    _ghost_value_data_out.resize(_val_send_disp.back());
+    _ghost_value_data_in.resize(_val_recv_disp.back());
 
     // Global-to-local map for ghost columns
     std::vector<std::pair<std::int64_t, std::int32_t>> global_to_local;
@@ -327,14 +439,21 @@ public:
       assert(cit != cit1);
       assert(*cit == local_col);
       std::size_t d = std::distance(_cols.begin(), cit);
-      _unpack_pos.push_back(d);
+      for (int k = 0; k < nbs; ++k)
+        _unpack_pos.push_back(d * nbs + k);
     }
   }
 
   /// Move constructor
-  /// @todo Check handling of MPI_Request
   MatrixCSR(MatrixCSR&& A) = default;
 
+  /// Destructor
+  ~MatrixCSR()
+  {
+    for (MPI_Request& request : _requests)
+      MPI_Request_free(&request);
+  }
+
   /// Set all non-zero local entries to a value
   /// including entries in ghost rows
   /// @param[in] x The value to set non-zero matrix entries to
@@ -348,16 +467,31 @@ public:
   /// @note This should be called after `finalize`. Using before
   /// `finalize` will set the values correctly, but incoming values may
   /// get added to them during a subsequent finalize operation.
-  /// @param[in] x The `m` by `n` dense block of values (row-major) to
-  /// set in the matrix
-  /// @param[in] rows The row indices of `x`
-  /// @param[in] cols The column indices of `x`
+  /// @param[in] x The `m * bs0` by `n * bs1` dense block of values
+  /// (row-major) to set in the matrix
+  /// @param[in] rows The (block) row indices of `x`
+  /// @param[in] cols The (block) column indices of `x`
   void set(const std::span<const T>& x,
            const std::span<const std::int32_t>& rows,
            const std::span<const std::int32_t>& cols)
   {
-    impl::set_csr(_data, _cols, _row_ptr, x, rows, cols,
-                  _index_maps[0]->size_local());
+    if (_bs[0] == 1 and _bs[1] == 1)
+    {
+      impl::set_csr(_data, _cols, _row_ptr, x, rows, cols,
+                    _index_maps[0]->size_local());
+    }
+    else
+    {
+#ifndef NDEBUG
+      const std::int32_t local_size = _index_maps[0]->size_local();
+      for (std::int32_t row : rows)
+        if (row >= local_size)
+          throw std::runtime_error("Local row out of range");
+#endif
+      impl::insert_blocked_csr(
+          _data, _cols, _row_ptr, x, rows, cols,
+          [](T& a, const T& b) { a = b; }, _bs[0], _bs[1]);
+    }
   }
 
   /// Accumulate values in the matrix
@@ -368,23 +502,33 @@ public:
   /// @note Use `finalize` after all entries have been added to send
   /// ghost rows to owners. Adding more entries after `finalize` is
   /// allowed, but another call to `finalize` will then be required.
-  /// @param[in] x The `m` by `n` dense block of values (row-major) to
-  /// add to the matrix
-  /// @param[in] rows The row indices of `x`
-  /// @param[in] cols The column indices of `x`
+  /// @param[in] x The `m * bs0` by `n * bs1` dense block of values
+  /// (row-major) to add to the matrix
+  /// @param[in] rows The (block) row indices of `x`
+  /// @param[in] cols The (block) column indices of `x`
   void add(const std::span<const T>& x,
            const std::span<const std::int32_t>& rows,
            const std::span<const std::int32_t>& cols)
   {
-    impl::add_csr(_data, _cols, _row_ptr, x, rows, cols);
+    if (_bs[0] == 1 and _bs[1] == 1)
+      impl::add_csr(_data, _cols, _row_ptr, x, rows, cols);
+    else
+    {
+      impl::insert_blocked_csr(
+          _data, _cols, _row_ptr, x, rows, cols,
+          [](T& a, const T& b) { a += b; }, _bs[0], _bs[1]);
+    }
   }
 
-  /// Number of local rows excluding ghost rows
+  /// Number of local (block) rows excluding ghost rows
   std::int32_t num_owned_rows() const { return _index_maps[0]->size_local(); }
 
-  /// Number of local rows including ghost rows
+  /// Number of local (block) rows including ghost rows
   std::int32_t num_all_rows() const { return _row_ptr.size() - 1; }
 
+  /// Block sizes for the rows (0) and columns (1)
+  const std::array<int, 2>& block_size() const { return _bs; }
+
   /// Copy to a dense matrix
   /// @note This function is typically used for debugging and not used
   /// in production
@@ -394,17 +538,52 @@ public:
   /// Storage is row-major.
   std::vector<T> to_dense() const
   {
-    const std::size_t nrows = num_all_rows();
+    const std::size_t nrows = num_all_rows() * _bs[0];
     const std::size_t ncols
-        = _index_maps[1]->size_local() + _index_maps[1]->num_ghosts();
+        = (_index_maps[1]->size_local() + _index_maps[1]->num_ghosts())
+          * _bs[1];
+    const int nbs = _bs[0] * _bs[1];
     std::vector<T> A(nrows * ncols);
-    for (std::size_t r = 0; r < nrows; ++r)
+    for (std::int32_t r = 0; r < num_all_rows(); ++r)
+    {
       for (std::int32_t j = _row_ptr[r]; j < _row_ptr[r + 1]; ++j)
-        A[r * ncols + _cols[j]] = _data[j];
+      {
+        for (int k0 = 0; k0 < _bs[0]; ++k0)
+        {
+          for (int k1 = 0; k1 < _bs[1]; ++k1)
+          {
+            A[(r * _bs[0] + k0) * ncols + _cols[j] * _bs[1] + k1]
+                = _data[j * nbs + k0 * _bs[1] + k1];
+          }
+        }
+      }
+    }
 
     return A;
   }
 
+  /// @brief Use persistent MPI requests in MatrixCSR::finalize.
+  ///
+  /// When enabled, the request for transferring ghost row values is
+  /// created on the first call to MatrixCSR::finalize_begin and then
+  /// restarted by later calls, which is cheaper for matrices that are
+  /// assembled repeatedly.
+  ///
+  /// @note Must not be called between MatrixCSR::finalize_begin and
+  /// MatrixCSR::finalize_end. If MPI-4 is supported, the requests are
+  /// created collectively and all ranks must use the same setting.
+  /// @param[in] persistent True to use persistent requests
+  void set_persistent_requests(bool persistent)
+  {
+    if (persistent != _persistent)
+    {
+      for (MPI_Request& request : _requests)
+        MPI_Request_free(&request);
+      _requests.clear();
+      _persistent = persistent;
+    }
+  }
+
   /// Transfer ghost row data to the owning ranks
   /// accumulating received values on the owned rows, and zeroing any existing
   /// data in ghost rows.
@@ -425,10 +604,10 @@ public:
   {
     const std::int32_t local_size0 = _index_maps[0]->size_local();
     const std::int32_t num_ghosts0 = _index_maps[0]->num_ghosts();
+    const int nbs = _bs[0] * _bs[1];
 
     // For each ghost row, pack and send values to send to neighborhood
     std::vector<int> insert_pos = _val_send_disp;
-    std::vector<T> ghost_value_data(_val_send_disp.back());
     for (int i = 0; i < num_ghosts0; ++i)
     {
       const int rank = _ghost_row_to_rank[i];
@@ -436,30 +615,35 @@ public:
       // Get position in send buffer to place data to send to this
       // neighbour
       const std::int32_t val_pos = insert_pos[rank];
-      std::copy(std::next(_data.data(), _row_ptr[local_size0 + i]),
-                std::next(_data.data(), _row_ptr[local_size0 + i + 1]),
-                std::next(ghost_value_data.begin(), val_pos));
+      std::copy(std::next(_data.data(), _row_ptr[local_size0 + i] * nbs),
+                std::next(_data.data(), _row_ptr[local_size0 + i + 1] * nbs),
+                std::next(_ghost_value_data_out.begin(), val_pos));
       insert_pos[rank]
-          += _row_ptr[local_size0 + i + 1] - _row_ptr[local_size0 + i];
+          += (_row_ptr[local_size0 + i + 1] - _row_ptr[local_size0 + i]) * nbs;
     }
 
-    _ghost_value_data_in.resize(_val_recv_disp.back());
-
-    // Compute data sizes for send and receive from displacements
-    std::vector<int> val_send_count(_val_send_disp.size() - 1);
-    std::adjacent_difference(std::next(_val_send_disp.begin()),
-                             _val_send_disp.end(), val_send_count.begin());
-
-    std::vector<int> val_recv_count(_val_recv_disp.size() - 1);
-    std::adjacent_difference(std::next(_val_recv_disp.begin()),
-                             _val_recv_disp.end(), val_recv_count.begin());
-
-    int status = MPI_Ineighbor_alltoallv(
-        ghost_value_data.data(), val_send_count.data(), _val_send_disp.data(),
-        dolfinx::MPI::mpi_type<T>(), _ghost_value_data_in.data(),
-        val_recv_count.data(), _val_recv_disp.data(),
-        dolfinx::MPI::mpi_type<T>(), _comm.comm(), &_request);
-    assert(status == MPI_SUCCESS);
+    if (_persistent)
+    {
+      if (_requests.empty())
+      {
+        _requests = dolfinx::MPI::neighbor_alltoallv_init(
+            _ghost_value_data_out.data(), _val_send_count.data(),
+            _val_send_disp.data(), _ghost_value_data_in.data(),
+            _val_recv_count.data(), _val_recv_disp.data(), _comm.comm());
+      }
+      if (!_requests.empty())
+        MPI_Startall(_requests.size(), _requests.data());
+    }
+    else
+    {
+      int status = MPI_Ineighbor_alltoallv(
+          _ghost_value_data_out.data(), _val_send_count.data(),
+          _val_send_disp.data(), dolfinx::MPI::mpi_type<T>(),
+          _ghost_value_data_in.data(), _val_recv_count.data(),
+          _val_recv_disp.data(), dolfinx::MPI::mpi_type<T>(), _comm.comm(),
+          &_request);
+      assert(status == MPI_SUCCESS);
+    }
   }
 
   /// End transfer of ghost row data to owning ranks
@@ -469,8 +653,19 @@ public:
   /// zeroed.
   void finalize_end()
   {
-    int status = MPI_Wait(&_request, MPI_STATUS_IGNORE);
-    assert(status == MPI_SUCCESS);
+    if (_persistent)
+    {
+      if (!_requests.empty())
+      {
+        MPI_Waitall(_requests.size(), _requests.data(),
+                    MPI_STATUSES_IGNORE);
+      }
+    }
+    else
+    {
+      int status = MPI_Wait(&_request, MPI_STATUS_IGNORE);
+      assert(status == MPI_SUCCESS);
+    }
 
     // Add to local rows
     assert(_ghost_value_data_in.size() == _unpack_pos.size());
@@ -479,7 +674,195 @@ public:
 
     // Set ghost row data to zero
     const std::int32_t local_size0 = _index_maps[0]->size_local();
-    std::fill(std::next(_data.begin(), _row_ptr[local_size0]), _data.end(), 0);
+    std::fill(std::next(_data.begin(), _row_ptr[local_size0] * _bs[0] * _bs[1]),
+              _data.end(), 0);
+  }
+
+  /// @brief Compute the matrix-vector product y = Ax.
+  ///
+  /// The ghost update of `x` is overlapped with the product of the
+  /// block of owned columns. The off-diagonal (ghost column) block is
+  /// applied after the ghost update has completed.
+  ///
+  /// @note The matrix must be finalized before calling this function
+  /// @note Ghost entries of `y` are not updated
+  /// @param[in,out] x Vector to apply `A` to. It must use the column
+  /// index map and column block size of `A`. Its ghost values are
+  /// updated.
+  /// @param[out] y Vector to store the result in. It must use the row
+  /// index map and row block size of `A`.
+  /// @param[in] num_threads Number of threads used for the local
+  /// products. The owned rows are split into contiguous blocks, one
+  /// per thread.
+  template <class VAllocator>
+  void mult(Vector<T, VAllocator>& x, Vector<T, VAllocator>& y,
+            int num_threads = 1) const
+  {
+    assert(x.bs() == _bs[1] and y.bs() == _bs[0]);
+
+    // Start ghost update
+    x.scatter_fwd_begin();
+
+    std::span<const T> _x = x.array();
+    std::span<T> _y = y.mutable_array();
+
+    if (_bs[0] == 1 and _bs[1] == 1)
+    {
+      // y[0] = A[0] x[0] (owned columns)
+      apply_row_blocks(
+          num_threads,
+          [&](std::int32_t r0, std::int32_t r1)
+          {
+            for (std::int32_t r = r0; r < r1; ++r)
+            {
+              T y_r = 0;
+              for (std::int32_t j = _row_ptr[r]; j < _off_diagonal_offset[r];
+                   ++j)
+              {
+                y_r += _data[j] * _x[_cols[j]];
+              }
+              _y[r] = y_r;
+            }
+          });
+
+      // Finalise ghost update
+      x.scatter_fwd_end();
+
+      // y[0] += A[1] x[1] (ghost columns)
+      apply_row_blocks(
+          num_threads,
+          [&](std::int32_t r0, std::int32_t r1)
+          {
+            for (std::int32_t r = r0; r < r1; ++r)
+            {
+              T y_r = 0;
+              for (std::int32_t j = _off_diagonal_offset[r];
+                   j < _row_ptr[r + 1]; ++j)
+              {
+                y_r += _data[j] * _x[_cols[j]];
+              }
+              _y[r] += y_r;
+            }
+          });
+    }
+    else
+    {
+      // Block version: y_r += sum_j A_rj x_j for bs0 x bs1 blocks A_rj
+      const int bs0 = _bs[0];
+      const int bs1 = _bs[1];
+      const int nbs = bs0 * bs1;
+      auto spmv = [&](std::int32_t r, std::int32_t j0, std::int32_t j1)
+      {
+        T* y_r = _y.data() + r * bs0;
+        for (std::int32_t j = j0; j < j1; ++j)
+        {
+          const T* A_rj = _data.data() + j * nbs;
+          const T* x_j = _x.data() + _cols[j] * bs1;
+          for (int k0 = 0; k0 < bs0; ++k0)
+            for (int k1 = 0; k1 < bs1; ++k1)
+              y_r[k0] += A_rj[k0 * bs1 + k1] * x_j[k1];
+        }
+      };
+
+      // y[0] = A[0] x[0] (owned columns)
+      apply_row_blocks(
+          num_threads,
+          [&](std::int32_t r0, std::int32_t r1)
+          {
+            std::fill(std::next(_y.begin(), r0 * bs0),
+                      std::next(_y.begin(), r1 * bs0), 0);
+            for (std::int32_t r = r0; r < r1; ++r)
+              spmv(r, _row_ptr[r], _off_diagonal_offset[r]);
+          });
+
+      // Finalise ghost update
+      x.scatter_fwd_end();
+
+      // y[0] += A[1] x[1] (ghost columns)
+      apply_row_blocks(
+          num_threads,
+          [&](std::int32_t r0, std::int32_t r1)
+          {
+            for (std::int32_t r = r0; r < r1; ++r)
+              spmv(r, _off_diagonal_offset[r], _row_ptr[r + 1]);
+          });
+    }
+  }
+
+  /// @brief Compute the matrix-multivector product Y = AX (SpMM).
+  ///
+  /// Each matrix entry is read once and applied to all columns of `X`.
+  /// The ghost update of `X` is overlapped with the product of the
+  /// block of owned columns.
+  ///
+  /// @note The matrix must be finalized before calling this function
+  /// @note Ghost entries of `Y` are not updated
+  /// @param[in,out] X Multi-vector to apply `A` to. It must use the
+  /// column index map and column block size of `A`. Its ghost values
+  /// are updated.
+  /// @param[out] Y Multi-vector to store the result in. It must use the
+  /// row index map and row block size of `A`, and have the same number
+  /// of vectors as `X`.
+  /// @param[in] num_threads Number of threads used for the local
+  /// products. The owned rows are split into contiguous blocks, one
+  /// per thread.
+  template <class VAllocator>
+  void mult(MultiVector<T, VAllocator>& X, MultiVector<T, VAllocator>& Y,
+            int num_threads = 1) const
+  {
+    assert(X.bs() == _bs[1] and Y.bs() == _bs[0]);
+    assert(X.num_vectors() == Y.num_vectors());
+    const int k = X.num_vectors();
+    const int bs0 = _bs[0];
+    const int bs1 = _bs[1];
+    const int nbs = bs0 * bs1;
+
+    // Start ghost update
+    X.scatter_fwd_begin();
+
+    std::span<const T> _x = X.array();
+    std::span<T> _y = Y.mutable_array();
+
+    // Y_r += sum_j A_rj X_j for the entries [j0, j1) on row r
+    auto spmm = [&](std::int32_t r, std::int32_t j0, std::int32_t j1)
+    {
+      T* y_r = _y.data() + r * bs0 * k;
+      for (std::int32_t j = j0; j < j1; ++j)
+      {
+        const T* A_rj = _data.data() + j * nbs;
+        const T* x_j = _x.data() + _cols[j] * bs1 * k;
+        for (int k0 = 0; k0 < bs0; ++k0)
+        {
+          for (int k1 = 0; k1 < bs1; ++k1)
+          {
+            const T a = A_rj[k0 * bs1 + k1];
+            for (int c = 0; c < k; ++c)
+              y_r[k0 * k + c] += a * x_j[k1 * k + c];
+          }
+        }
+      }
+    };
+
+    // Y[0] = A[0] X[0] (owned columns)
+    apply_row_blocks(num_threads,
+                     [&](std::int32_t r0, std::int32_t r1)
+                     {
+                       std::fill(std::next(_y.begin(), r0 * bs0 * k),
+                                 std::next(_y.begin(), r1 * bs0 * k), 0);
+                       for (std::int32_t r = r0; r < r1; ++r)
+                         spmm(r, _row_ptr[r], _off_diagonal_offset[r]);
+                     });
+
+    // Finalise ghost update
+    X.scatter_fwd_end();
+
+    // Y[0] += A[1] X[1] (ghost columns)
+    apply_row_blocks(num_threads,
+                     [&](std::int32_t r0, std::int32_t r1)
+                     {
+                       for (std::int32_t r = r0; r < r1; ++r)
+                         spmm(r, _off_diagonal_offset[r], _row_ptr[r + 1]);
+                     });
   }
 
   /// Compute the Frobenius norm squared
@@ -489,7 +872,8 @@ public:
     assert(num_owned_rows < _row_ptr.size());
 
     const double norm_sq_local = std::accumulate(
-        _data.cbegin(), std::next(_data.cbegin(), _row_ptr[num_owned_rows]),
+        _data.cbegin(),
+        std::next(_data.cbegin(), _row_ptr[num_owned_rows] * _bs[0] * _bs[1]),
         double(0), [](double norm, T y) { return norm + std::norm(y); });
     double norm_sq;
     MPI_Allreduce(&norm_sq_local, &norm_sq, 1, MPI_DOUBLE, MPI_SUM,
@@ -511,6 +895,8 @@ public:
 
   /// Get local data values
   /// @note Includes ghost values
+  /// @note For block sizes greater than one, the values of each block
+  /// are stored contiguously (row-major)
   std::vector<T>& values() { return _data; }
 
   /// Get local values (const version)
@@ -538,6 +924,14 @@ public:
   }
 
 private:
+  // Call f(r0, r1) for contiguous blocks [r0, r1) of owned rows, one
+  // block per thread
+  template <typename F>
+  void apply_row_blocks(int num_threads, F&& f) const
+  {
+    common::apply_blocks(_index_maps[0]->size_local(), num_threads, f);
+  }
+
   // Maps for the distribution of the ows and columns
   std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
 
@@ -559,6 +953,12 @@ private:
   // Request in non-blocking communication
   MPI_Request _request;
 
+  // Use persistent requests in finalize
+  bool _persistent = false;
+
+  // Persistent requests for finalize (created on first use)
+  std::vector<MPI_Request> _requests;
+
   // Position in _data to add received data
   std::vector<int> _unpack_pos;
 
@@ -566,12 +966,15 @@ private:
   // receiving
   std::vector<int> _val_send_disp, _val_recv_disp;
 
+  // Number of values sent to and received from each neighbor
+  std::vector<int> _val_send_count, _val_recv_count;
+
   // Ownership of each row, by neighbor (for the neighbourhood defined
   // on _comm)
   std::vector<int> _ghost_row_to_rank;
 
   // Temporary store for finalize data during non-blocking communication
-  std::vector<T> _ghost_value_data_in;
+  std::vector<T> _ghost_value_data_in, _ghost_value_data_out;
 };
 
 } // namespace dolfinx::la
@@ -0,0 +1,264 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/utils.h>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::la
+{
+
+/// @brief Distributed sparse matrix in SELL-C-σ (sliced ELLPACK)
+/// format.
+///
+/// The owned rows are sorted by decreasing length within windows of
+/// σ rows, and grouped into chunks of `C` consecutive (sorted) rows.
+/// Each chunk is padded to the length of its longest row and stored
+/// column-major, so that a matrix-vector product processes `C` rows
+/// at a time with contiguous loads. `C` should be the SIMD width for
+/// `T`. The default is the number of values of type `T` in 64 bytes
+/// (one AVX-512 register or cache line), i.e. 8 for double, 16 for
+/// float and 4 for std::complex<double>.
+///
+/// As for MatrixCSR, the owned-column (diagonal) and ghost-column
+/// (off-diagonal) parts are stored separately so that the ghost update
+/// of the input vector can overlap with the diagonal product.
+///
+/// A MatrixSELL is created from a finalized MatrixCSR. It is a copy
+/// and is not updated if the MatrixCSR values change.
+///
+/// @tparam T The data type for the matrix
+/// @tparam C The chunk size (number of rows processed together)
+template <typename T, int C = static_cast<int>(64 / sizeof(T))>
+class MatrixSELL
+{
+public:
+  /// The value type
+  using value_type = T;
+
+  /// @brief Create a SELL-C-σ matrix from a CSR matrix.
+  /// @param[in] A The CSR matrix (block size one). Ghost rows are
+  /// ignored.
+  /// @param[in] sigma The sorting window (number of rows). Rows are
+  /// sorted by length within each window. Must be a multiple of `C`.
+  /// Use `sigma = C` for no sorting.
+  MatrixSELL(const MatrixCSR<T>& A, int sigma = 32 * C)
+      : _index_maps(A.index_maps()), _num_rows(A.num_owned_rows())
+  {
+    if (A.block_size()[0] != 1 or A.block_size()[1] != 1)
+      throw std::runtime_error("Block size not supported for MatrixSELL.");
+    if (sigma < C or sigma % C != 0)
+      throw std::runtime_error("Sorting window must be a multiple of C.");
+
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+
+    // Sort rows by decreasing length within each window of sigma rows
+    _perm.resize(_num_rows);
+    std::iota(_perm.begin(), _perm.end(), 0);
+    for (std::int32_t r0 = 0; r0 < _num_rows; r0 += sigma)
+    {
+      const std::int32_t r1 = std::min(r0 + sigma, _num_rows);
+      std::stable_sort(std::next(_perm.begin(), r0),
+                       std::next(_perm.begin(), r1),
+                       [&row_ptr](auto a, auto b)
+                       {
+                         return row_ptr[a + 1] - row_ptr[a]
+                                > row_ptr[b + 1] - row_ptr[b];
+                       });
+    }
+
+    std::span<const std::int32_t> rp(row_ptr);
+    std::span<const std::int32_t> od(off_diag);
+    _slices[0] = create_slices(A, rp.first(_num_rows), od.first(_num_rows));
+    _slices[1]
+        = create_slices(A, od.first(_num_rows), rp.subspan(1, _num_rows));
+  }
+
+  /// @brief Compute the matrix-vector product y = Ax.
+  ///
+  /// The ghost update of `x` is overlapped with the product of the
+  /// owned-column part of the matrix.
+  ///
+  /// @note Ghost entries of `y` are not updated
+  /// @param[in,out] x Vector to apply `A` to. It must use the column
+  /// index map of `A`. Its ghost values are updated.
+  /// @param[out] y Vector to store the result in. It must use the row
+  /// index map of `A`.
+  /// @param[in] num_threads Number of threads used for the local
+  /// products. The chunks are split into contiguous blocks, one per
+  /// thread.
+  template <class VAllocator>
+  void mult(Vector<T, VAllocator>& x, Vector<T, VAllocator>& y,
+            int num_threads = 1) const
+  {
+    assert(x.bs() == 1 and y.bs() == 1);
+    x.scatter_fwd_begin();
+    apply(_slices[0], x.array(), y.mutable_array(), false, num_threads);
+    x.scatter_fwd_end();
+    apply(_slices[1], x.array(), y.mutable_array(), true, num_threads);
+  }
+
+  /// Index maps for the row and column space
+  const std::array<std::shared_ptr<const common::IndexMap>, 2>&
+  index_maps() const
+  {
+    return _index_maps;
+  }
+
+  /// Number of owned rows
+  std::int32_t num_owned_rows() const { return _num_rows; }
+
+  /// Row permutation, where row `i` of the SELL storage is row
+  /// `permutation()[i]` of the matrix
+  const std::vector<std::int32_t>& permutation() const { return _perm; }
+
+  /// @brief Number of stored values, including padding, for the
+  /// owned-column (0) and ghost-column (1) parts
+  std::array<std::size_t, 2> num_stored() const
+  {
+    return {_slices[0].values.size(), _slices[1].values.size()};
+  }
+
+private:
+  // Chunks of C rows, stored column-major and padded to the longest
+  // row of the chunk
+  struct Slices
+  {
+    // Offset of each chunk in cols/values
+    std::vector<std::int32_t> chunk_ptr;
+
+    // Column indices and values. Padding has value zero and the last
+    // column of its row, so that it does not introduce any other
+    // entries of x (which may be Inf or NaN) into the product.
+    std::vector<std::int32_t> cols;
+    std::vector<T> values;
+
+    // Rows (in SELL order) with no entries, for which the padded
+    // product is discarded
+    std::vector<std::int8_t> empty;
+  };
+
+  // Build slices for the CSR entries [begin[r], end[r]) of each row r
+  Slices create_slices(const MatrixCSR<T>& A,
+                       std::span<const std::int32_t> begin,
+                       std::span<const std::int32_t> end) const
+  {
+    const std::int32_t num_chunks = (_num_rows + C - 1) / C;
+    Slices s;
+    s.chunk_ptr.resize(num_chunks + 1, 0);
+    for (std::int32_t k = 0; k < num_chunks; ++k)
+    {
+      std::int32_t width = 0;
+      for (std::int32_t i = k * C; i < std::min((k + 1) * C, _num_rows); ++i)
+        width = std::max(width, end[_perm[i]] - begin[_perm[i]]);
+      s.chunk_ptr[k + 1] = s.chunk_ptr[k] + width * C;
+    }
+
+    // Padding of empty rows, and of the lanes after the last row,
+    // refers to column 0 and its result is discarded
+    s.cols.resize(s.chunk_ptr.back(), 0);
+    s.values.resize(s.chunk_ptr.back(), 0);
+    s.empty.resize(num_chunks * C, false);
+    const std::vector<std::int32_t>& cols = A.cols();
+    const std::vector<T>& values = A.values();
+    for (std::int32_t i = 0; i < _num_rows; ++i)
+    {
+      const std::int32_t k = i / C;
+      const std::int32_t lane = i % C;
+      const std::int32_t r = _perm[i];
+      if (begin[r] == end[r])
+      {
+        s.empty[i] = true;
+        continue;
+      }
+
+      const std::int32_t width = (s.chunk_ptr[k + 1] - s.chunk_ptr[k]) / C;
+      for (std::int32_t j = 0; j < width; ++j)
+      {
+        const std::int32_t pos = s.chunk_ptr[k] + j * C + lane;
+        if (j < end[r] - begin[r])
+        {
+          s.cols[pos] = cols[begin[r] + j];
+          s.values[pos] = values[begin[r] + j];
+        }
+        else
+          s.cols[pos] = cols[end[r] - 1];
+      }
+    }
+
+    return s;
+  }
+
+  // Compute y = A x (add = false) or y += A x (add = true) for the
+  // slices s
+  void apply(const Slices& s, std::span<const T> x, std::span<T> y,
+             bool add, int num_threads) const
+  {
+    const std::int32_t num_chunks = s.chunk_ptr.size() - 1;
+    auto kernel = [&](std::int32_t k0, std::int32_t k1)
+    {
+      for (std::int32_t k = k0; k < k1; ++k)
+      {
+        std::array<T, C> tmp;
+        tmp.fill(0);
+        for (std::int32_t j = s.chunk_ptr[k]; j < s.chunk_ptr[k + 1]; j += C)
+        {
+          const T* v = s.values.data() + j;
+          const std::int32_t* c = s.cols.data() + j;
+          for (int i = 0; i < C; ++i)
+            tmp[i] += v[i] * x[c[i]];
+        }
+
+        const std::int32_t n = std::min(C, _num_rows - k * C);
+        const std::int32_t* rows = _perm.data() + k * C;
+        for (int i = 0; i < n; ++i)
+        {
+          if (s.empty[k * C + i])
+            tmp[i] = 0;
+        }
+
+        if (add)
+        {
+          for (int i = 0; i < n; ++i)
+            y[rows[i]] += tmp[i];
+        }
+        else
+        {
+          for (int i = 0; i < n; ++i)
+            y[rows[i]] = tmp[i];
+        }
+      }
+    };
+
+    common::apply_blocks(num_chunks, num_threads, kernel);
+  }
+
+  // Maps for the distribution of the rows and columns
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+
+  // Number of owned rows
+  std::int32_t _num_rows;
+
+  // Row permutation (SELL row -> matrix row)
+  std::vector<std::int32_t> _perm;
+
+  // Owned-column (0) and ghost-column (1) parts
+  std::array<Slices, 2> _slices;
+};
+
+} // namespace dolfinx::la
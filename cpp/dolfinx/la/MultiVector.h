@@ -0,0 +1,276 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::la
+{
+
+/// @brief Distributed multi-vector, i.e. a set of `k` vectors with the
+/// same index map and block size.
+///
+/// The vectors (columns) are stored interleaved: the `k` values of
+/// each entry are contiguous, so that entry `i` of column `c` is at
+/// position `i * k + c` of the local array. A ghost update of all
+/// columns is a single scatter, and a matrix-multivector product reads
+/// the matrix once for all columns.
+template <typename T, class Allocator = std::allocator<T>>
+class MultiVector
+{
+public:
+  /// The value type
+  using value_type = T;
+
+  /// The allocator type
+  using allocator_type = Allocator;
+
+  /// @brief Create a distributed multi-vector.
+  /// @param[in] map The index map
+  /// @param[in] bs The block size
+  /// @param[in] num_vectors The number of vectors (columns)
+  /// @param[in] alloc The memory allocator for the data storage
+  MultiVector(const std::shared_ptr<const common::IndexMap>& map, int bs,
+              int num_vectors, const Allocator& alloc = Allocator())
+      : _bs(bs), _num_vectors(num_vectors), _x(map, bs * num_vectors, alloc)
+  {
+  }
+
+  /// Set all entries (including ghosts)
+  /// @param[in] v The value to set all entries to (on calling rank)
+  void set(T v) { _x.set(v); }
+
+  /// Begin scatter of local data from owner to ghosts on other ranks
+  /// @note Collective MPI operation
+  void scatter_fwd_begin() { _x.scatter_fwd_begin(); }
+
+  /// End scatter of local data from owner to ghosts on other ranks
+  /// @note Collective MPI operation
+  void scatter_fwd_end() { _x.scatter_fwd_end(); }
+
+  /// Scatter local data to ghost positions on other ranks
+  /// @note Collective MPI operation
+  void scatter_fwd() { _x.scatter_fwd(); }
+
+  /// Start scatter of ghost data to owner
+  /// @note Collective MPI operation
+  void scatter_rev_begin() { _x.scatter_rev_begin(); }
+
+  /// End scatter of ghost data to owner
+  /// @param op The operation to perform when adding/setting received
+  /// values (add or insert)
+  /// @note Collective MPI operation
+  template <class BinaryOperation>
+  void scatter_rev_end(BinaryOperation op)
+  {
+    _x.scatter_rev_end(op);
+  }
+
+  /// Scatter ghost data to owner
+  /// @param op The operation to perform when adding/setting received
+  /// values (add or insert)
+  /// @note Collective MPI operation
+  template <class BinaryOperation>
+  void scatter_rev(BinaryOperation op)
+  {
+    _x.scatter_rev(op);
+  }
+
+  /// @brief Use persistent MPI requests for ghost scatters. See
+  /// Vector::set_persistent_requests.
+  /// @param[in] persistent True to use persistent requests
+  void set_persistent_requests(bool persistent)
+  {
+    _x.set_persistent_requests(persistent);
+  }
+
+  /// @brief Copy a column into a vector.
+  /// @param[in] c The column
+  /// @param[out] v The vector. It must have the same index map and
+  /// block size as the multi-vector.
+  template <class VAllocator>
+  void get_column(int c, Vector<T, VAllocator>& v) const
+  {
+    assert(v.bs() == _bs and v.map() == map());
+    std::span<const T> x = _x.array();
+    std::span<T> y = v.mutable_array();
+    for (std::size_t i = 0; i < y.size(); ++i)
+      y[i] = x[i * _num_vectors + c];
+  }
+
+  /// @brief Copy a vector into a column.
+  /// @param[in] c The column
+  /// @param[in] v The vector. It must have the same index map and block
+  /// size as the multi-vector.
+  template <class VAllocator>
+  void set_column(int c, const Vector<T, VAllocator>& v)
+  {
+    assert(v.bs() == _bs and v.map() == map());
+    std::span<const T> y = v.array();
+    std::span<T> x = _x.mutable_array();
+    for (std::size_t i = 0; i < y.size(); ++i)
+      x[i * _num_vectors + c] = y[i];
+  }
+
+  /// Get IndexMap
+  std::shared_ptr<const common::IndexMap> map() const { return _x.map(); }
+
+  /// Get block size
+  constexpr int bs() const { return _bs; }
+
+  /// Get the number of vectors (columns)
+  constexpr int num_vectors() const { return _num_vectors; }
+
+  /// Get local part of the multi-vector (const version)
+  std::span<const T> array() const { return _x.array(); }
+
+  /// Get local part of the multi-vector
+  std::span<T> mutable_array() { return _x.mutable_array(); }
+
+  /// Get the allocator associated with the container
+  constexpr allocator_type allocator() const { return _x.allocator(); }
+
+private:
+  // Block size
+  int _bs;
+
+  // Number of vectors
+  int _num_vectors;
+
+  // Data, stored as a vector with block size _bs * _num_vectors
+  Vector<T, Allocator> _x;
+};
+
+/// @brief Compute the block inner product `X^{H} Y` of two
+/// multi-vectors, using a single reduction.
+///
+/// @note Collective MPI operation
+/// @param[in] X A multi-vector with `m` columns
+/// @param[in] Y A multi-vector with `n` columns. It must have the same
+/// parallel layout as `X`.
+/// @return The `m x n` matrix of inner products (row-major), where
+/// entry `(i, j)` is `x_i^{H} y_j`
+template <typename T, class Allocator>
+std::vector<T> inner_product(const MultiVector<T, Allocator>& X,
+                             const MultiVector<T, Allocator>& Y)
+{
+  const std::int32_t local_size = X.bs() * X.map()->size_local();
+  if (local_size != Y.bs() * Y.map()->size_local())
+    throw std::runtime_error("Incompatible vector sizes");
+
+  const int m = X.num_vectors();
+  const int n = Y.num_vectors();
+  std::span<const T> x = X.array();
+  std::span<const T> y = Y.array();
+  std::vector<T> result(m * n, 0);
+  for (std::int32_t k = 0; k < local_size; ++k)
+  {
+    const T* x_k = x.data() + k * m;
+    const T* y_k = y.data() + k * n;
+    for (int i = 0; i < m; ++i)
+    {
+      const T xi = impl::conj(x_k[i]);
+      T* r = result.data() + i * n;
+      for (int j = 0; j < n; ++j)
+        r[j] += xi * y_k[j];
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, result.data(), result.size(),
+                dolfinx::MPI::mpi_type<T>(), MPI_SUM, X.map()->comm());
+  return result;
+}
+
+/// @brief Orthonormalize the columns of a multi-vector.
+///
+/// Two passes of Cholesky QR are used (CholQR2). Each pass computes the
+/// Gram matrix `X^{H} X` with a single reduction and updates each
+/// entry, with its `k` contiguous column values, by a triangular solve.
+/// If the Gram matrix cannot resolve a nearly dependent column, the
+/// columns are orthonormalized by modified Gram-Schmidt (with
+/// reorthogonalization) instead.
+///
+/// @note Collective MPI operation
+/// @param[in,out] X The multi-vector. It is modified in-place (owned
+/// and ghost entries).
+/// @param[in] tol The tolerance used to detect a linear dependency
+template <typename T, class Allocator>
+void orthonormalize(MultiVector<T, Allocator>& X, double tol = 1.0e-10)
+{
+  const int k = X.num_vectors();
+  const std::int32_t local_size = X.bs() * X.map()->size_local();
+  std::span<T> x = X.mutable_array();
+  MPI_Comm comm = X.map()->comm();
+
+  // Modified Gram-Schmidt, one column at a time
+  auto mgs = [&]()
+  {
+    for (int j = 0; j < k; ++j)
+    {
+      for (int pass = 0; pass < 2; ++pass)
+      {
+        for (int i = 0; i < j; ++i)
+        {
+          T c = 0;
+          for (std::int32_t r = 0; r < local_size; ++r)
+            c += impl::conj(x[r * k + i]) * x[r * k + j];
+          MPI_Allreduce(MPI_IN_PLACE, &c, 1, dolfinx::MPI::mpi_type<T>(),
+                        MPI_SUM, comm);
+          for (std::size_t r = 0; r < x.size(); r += k)
+            x[r + j] -= c * x[r + i];
+        }
+      }
+
+      double norm = 0;
+      for (std::int32_t r = 0; r < local_size; ++r)
+        norm += std::norm(x[r * k + j]);
+      MPI_Allreduce(MPI_IN_PLACE, &norm, 1, MPI_DOUBLE, MPI_SUM, comm);
+      norm = std::sqrt(norm);
+      if (norm < tol)
+      {
+        throw std::runtime_error(
+            "Linear dependency detected. Cannot orthogonalize.");
+      }
+      for (std::size_t r = 0; r < x.size(); r += k)
+        x[r + j] /= norm;
+    }
+  };
+
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    std::vector<T> R = inner_product(X, X);
+    if (!impl::cholesky(std::span<T>(R), k, tol))
+    {
+      mgs();
+      return;
+    }
+
+    // x_r <- x_r R^{-1} for each entry r
+    for (std::size_t r = 0; r < x.size(); r += k)
+    {
+      T* x_r = x.data() + r;
+      for (int j = 0; j < k; ++j)
+      {
+        T v = x_r[j];
+        for (int i = 0; i < j; ++i)
+          v -= x_r[i] * R[i * k + j];
+        x_r[j] = v / R[j * k + j];
+      }
+    }
+  }
+}
+
+} // namespace dolfinx::la
@@ -6,16 +6,57 @@
 
 #include "SparsityPattern.h"
 #include <algorithm>
+#include <atomic>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <map>
+#include <sys/resource.h>
 
 using namespace dolfinx;
 using namespace dolfinx::la;
 
+namespace
+{
+/// Peak resident set size of the calling process (kB)
+long peak_memory_usage()
+{
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+/// Sort and remove duplicate entries in each row of an array of rows,
+/// and compact the rows in-place
+/// @param[in,out] entries The entries of all rows
+/// @param[in,out] offsets The offset of each row in `entries`
+void sort_unique_rows(std::vector<std::int32_t>& entries,
+                      std::vector<std::int64_t>& offsets)
+{
+  std::int64_t pos = 0;
+  for (std::size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    auto row0 = std::next(entries.begin(), offsets[i]);
+    auto row1 = std::next(entries.begin(), offsets[i + 1]);
+    std::sort(row0, row1);
+    row1 = std::unique(row0, row1);
+
+    // Move row forward to its compacted position
+    offsets[i] = pos;
+    pos += std::distance(row0, row1);
+    std::copy(row0, row1, std::next(entries.begin(), offsets[i]));
+  }
+  offsets.back() = pos;
+  entries.resize(pos);
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(
     MPI_Comm comm,
@@ -103,7 +144,7 @@ SparsityPattern::SparsityPattern(
       // Iterate over owned rows cache
       for (std::int32_t i = 0; i < num_rows_local; ++i)
       {
-        for (std::int32_t c_old : p->_row_cache[i])
+        for (std::int32_t c_old : p->row_entries(i))
         {
           const std::int32_t r_new = bs_dof0 * i + local_offset0[row];
           const std::int32_t c_new = (c_old < num_cols_local)
@@ -122,7 +163,7 @@ SparsityPattern::SparsityPattern(
       // Iterate over unowned rows cache
       for (std::int32_t i = 0; i < num_ghost_rows_local; ++i)
       {
-        for (std::int32_t c_old : p->_row_cache[i + num_rows_local])
+        for (std::int32_t c_old : p->row_entries(i + num_rows_local))
         {
           const std::int32_t r_new = bs_dof0 * i + ghost_offsets0[row];
           const std::int32_t c_new = (c_old < num_cols_local)
@@ -162,7 +203,27 @@ void SparsityPattern::insert(const std::span<const std::int32_t>& rows,
           "Cannot insert rows that do not exist in the IndexMap.");
     }
 
-    _row_cache[row].insert(_row_cache[row].end(), cols.begin(), cols.end());
+    switch (_mode)
+    {
+    case insert_mode::cache:
+      _row_cache[row].insert(_row_cache[row].end(), cols.begin(), cols.end());
+      break;
+    case insert_mode::count:
+      std::atomic_ref(_entry_pos[row])
+          .fetch_add(cols.size(), std::memory_order_relaxed);
+      break;
+    case insert_mode::fill:
+    {
+      // Entries beyond the counted size are not stored, and are detected
+      // in SparsityPattern::assemble
+      const std::int64_t pos = std::atomic_ref(_entry_pos[row])
+                                   .fetch_add(cols.size(),
+                                              std::memory_order_relaxed);
+      if (pos + std::int64_t(cols.size()) <= _entry_offsets[row + 1])
+        std::copy(cols.begin(), cols.end(), std::next(_entries.begin(), pos));
+      break;
+    }
+    }
   }
 }
 //-----------------------------------------------------------------------------
@@ -186,10 +247,44 @@ void SparsityPattern::insert_diagonal(const std::span<const std::int32_t>& rows)
           "Cannot insert rows that do not exist in the IndexMap.");
     }
 
-    _row_cache[row].push_back(row);
+    if (_mode == insert_mode::cache)
+      _row_cache[row].push_back(row);
+    else
+      insert(std::span(&row, 1), std::span(&row, 1));
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::count_begin()
+{
+  if (_graph or _mode != insert_mode::cache)
+    throw std::runtime_error("Cannot begin counting pass.");
+  if (std::any_of(_row_cache.begin(), _row_cache.end(),
+                  [](auto& row) { return !row.empty(); }))
+  {
+    throw std::runtime_error(
+        "Cannot begin counting pass after entries have been inserted.");
+  }
+
+  _entry_pos.assign(_row_cache.size(), 0);
+  std::vector<std::vector<std::int32_t>>().swap(_row_cache);
+  _mode = insert_mode::count;
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::count_end()
+{
+  if (_mode != insert_mode::count)
+    throw std::runtime_error("Sparsity pattern is not in counting pass.");
+
+  _entry_offsets.resize(_entry_pos.size() + 1);
+  _entry_offsets[0] = 0;
+  std::partial_sum(_entry_pos.begin(), _entry_pos.end(),
+                   std::next(_entry_offsets.begin()));
+  _entries.resize(_entry_offsets.back());
+  std::copy(_entry_offsets.begin(), std::prev(_entry_offsets.end()),
+            _entry_pos.begin());
+  _mode = insert_mode::fill;
+}
+//-----------------------------------------------------------------------------
 std::shared_ptr<const common::IndexMap>
 SparsityPattern::index_map(int dim) const
 {
@@ -228,8 +323,15 @@ void SparsityPattern::assemble()
 {
   if (_graph)
     throw std::runtime_error("Sparsity pattern has already been finalised.");
+  if (_mode == insert_mode::count)
+  {
+    throw std::runtime_error(
+        "Cannot assemble sparsity pattern during the counting pass.");
+  }
 
   common::Timer t0("SparsityPattern::assemble");
+  LOG(INFO) << "Peak memory usage before sparsity pattern assembly: "
+            << peak_memory_usage() << " kB";
 
   assert(_index_maps[0]);
   const std::int32_t local_size0 = _index_maps[0]->size_local();
@@ -246,6 +348,43 @@ void SparsityPattern::assemble()
   _col_ghosts = _index_maps[1]->ghosts();
   _col_ghost_owners = _index_maps[1]->owners();
 
+  // Move entries into a single array (releasing the cache row-by-row)
+  const std::int32_t num_rows = local_size0 + owners0.size();
+  if (_mode == insert_mode::cache)
+  {
+    _entry_offsets.resize(num_rows + 1);
+    _entry_offsets[0] = 0;
+    for (std::int32_t i = 0; i < num_rows; ++i)
+      _entry_offsets[i + 1] = _entry_offsets[i] + _row_cache[i].size();
+    _entries.resize(_entry_offsets.back());
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      std::copy(_row_cache[i].begin(), _row_cache[i].end(),
+                std::next(_entries.begin(), _entry_offsets[i]));
+      std::vector<std::int32_t>().swap(_row_cache[i]);
+    }
+    std::vector<std::vector<std::int32_t>>().swap(_row_cache);
+  }
+  else
+  {
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      if (_entry_pos[i] != _entry_offsets[i + 1])
+      {
+        throw std::runtime_error("Insertions in the counting and fill passes "
+                                 "of the sparsity pattern do not match.");
+      }
+    }
+    std::vector<std::int64_t>().swap(_entry_pos);
+  }
+
+  sort_unique_rows(_entries, _entry_offsets);
+  auto row_data = [this](std::int32_t i)
+  {
+    return std::span(std::next(_entries.data(), _entry_offsets[i]),
+                     _entry_offsets[i + 1] - _entry_offsets[i]);
+  };
+
   // Compute size of data to send to each process
   std::vector<int> send_sizes(src0.size(), 0);
   for (std::size_t i = 0; i < owners0.size(); ++i)
@@ -253,7 +392,7 @@ void SparsityPattern::assemble()
     auto it = std::lower_bound(src0.begin(), src0.end(), owners0[i]);
     assert(it != src0.end() and *it == owners0[i]);
     const int neighbour_rank = std::distance(src0.begin(), it);
-    send_sizes[neighbour_rank] += 3 * _row_cache[i + local_size0].size();
+    send_sizes[neighbour_rank] += 3 * row_data(i + local_size0).size();
   }
 
   // Compute send displacements
@@ -272,7 +411,7 @@ void SparsityPattern::assemble()
     assert(it != src0.end() and *it == owners0[i]);
     const int neighbour_rank = std::distance(src0.begin(), it);
 
-    for (std::int32_t col_local : _row_cache[i + local_size0])
+    for (std::int32_t col_local : row_data(i + local_size0))
     {
       // Get index in send buffer
       const std::int32_t pos = insert_pos[neighbour_rank];
@@ -328,17 +467,20 @@ void SparsityPattern::assemble()
   for (std::int64_t global_i : _col_ghosts)
     global_to_local.insert({global_i, local_i++});
 
-  // Add data received from the neighborhood
+  // Convert data received from the neighborhood to local (row, column)
+  // pairs, and count the number of received entries for each row
+  std::vector<std::int32_t> num_received(num_rows, 0);
+  std::vector<std::int32_t> received_cols(ghost_data_in.size() / 3);
   for (std::size_t i = 0; i < ghost_data_in.size(); i += 3)
   {
     const std::int32_t row_local = ghost_data_in[i] - local_range0[0];
     const std::int64_t col = ghost_data_in[i + 1];
     const int owner = ghost_data_in[i + 2];
+    ++num_received[row_local];
     if (col >= local_range1[0] and col < local_range1[1])
     {
       // Convert to local column index
-      const std::int32_t J = col - local_range1[0];
-      _row_cache[row_local].push_back(J);
+      received_cols[i / 3] = col - local_range1[0];
     }
     else
     {
@@ -351,44 +493,83 @@ void SparsityPattern::assemble()
         ++local_i;
       }
 
-      const std::int32_t col_local = it.first->second;
-      _row_cache[row_local].push_back(col_local);
+      received_cols[i / 3] = it.first->second;
     }
   }
 
-  // Sort and remove duplicate column indices in each row
-  std::vector<std::int32_t> adj_counts(local_size0 + owners0.size(), 0);
-  std::vector<std::int32_t> adj_data;
-  _off_diagonal_offset.resize(local_size0 + owners0.size());
-  for (std::size_t i = 0; i < local_size0 + owners0.size(); ++i)
+  // Make space for the received entries at the end of each row, moving
+  // rows (last row first) to their new positions, and add the entries
   {
-    std::vector<std::int32_t>& row = _row_cache[i];
-    std::sort(row.begin(), row.end());
-    auto it_end = std::unique(row.begin(), row.end());
+    std::vector<std::int64_t> offsets(num_rows + 1, 0);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      offsets[i + 1] = offsets[i] + row_data(i).size() + num_received[i];
+    }
+    _entries.resize(offsets.back());
+    for (std::int32_t i = num_rows - 1; i >= 0; --i)
+    {
+      std::copy_backward(
+          std::next(_entries.begin(), _entry_offsets[i]),
+          std::next(_entries.begin(), _entry_offsets[i + 1]),
+          std::next(_entries.begin(), offsets[i + 1] - num_received[i]));
+    }
 
-    // Find position of first "off-diagonal" column
-    _off_diagonal_offset[i] = std::distance(
-        row.begin(), std::lower_bound(row.begin(), it_end, local_size1));
+    std::vector<std::int64_t> insert_pos(num_rows);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+      insert_pos[i] = offsets[i + 1] - num_received[i];
+    for (std::size_t i = 0; i < ghost_data_in.size(); i += 3)
+    {
+      const std::int32_t row_local = ghost_data_in[i] - local_range0[0];
+      _entries[insert_pos[row_local]++] = received_cols[i / 3];
+    }
 
-    adj_data.insert(adj_data.end(), row.begin(), it_end);
-    adj_counts[i] += std::distance(row.begin(), it_end);
+    _entry_offsets = std::move(offsets);
   }
-  // Clear cache
-  std::vector<std::vector<std::int32_t>>().swap(_row_cache);
 
-  // Compute offsets for adjacency list
-  std::vector<std::int32_t> adj_offsets(local_size0 + owners0.size() + 1);
-  std::partial_sum(adj_counts.begin(), adj_counts.end(),
-                   adj_offsets.begin() + 1);
+  // Sort and remove duplicate column indices in each row
+  sort_unique_rows(_entries, _entry_offsets);
+
+  // Find position of first "off-diagonal" column
+  _off_diagonal_offset.resize(num_rows);
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    std::span<const std::int32_t> row = row_data(i);
+    _off_diagonal_offset[i] = std::distance(
+        row.begin(), std::lower_bound(row.begin(), row.end(), local_size1));
+  }
 
-  adj_data.shrink_to_fit();
+  std::vector<std::int32_t> adj_offsets(_entry_offsets.begin(),
+                                        _entry_offsets.end());
+  std::vector<std::int64_t>().swap(_entry_offsets);
+  _entries.shrink_to_fit();
   _graph = std::make_shared<graph::AdjacencyList<std::int32_t>>(
-      std::move(adj_data), std::move(adj_offsets));
+      std::move(_entries), std::move(adj_offsets));
+  _entries.clear();
 
   // Column count increased due to received rows from other processes
   LOG(INFO) << "Column ghost size increased from "
             << _index_maps[1]->ghosts().size() << " to " << _col_ghosts.size()
             << std::endl;
+  LOG(INFO) << "Peak memory usage after sparsity pattern assembly: "
+            << peak_memory_usage() << " kB";
+}
+//-----------------------------------------------------------------------------
+std::span<const std::int32_t>
+SparsityPattern::row_entries(std::int32_t i) const
+{
+  switch (_mode)
+  {
+  case insert_mode::cache:
+    return _row_cache[i];
+  case insert_mode::fill:
+  {
+    const std::int64_t end = std::min(_entry_pos[i], _entry_offsets[i + 1]);
+    return std::span(std::next(_entries.data(), _entry_offsets[i]),
+                     end - _entry_offsets[i]);
+  }
+  default:
+    throw std::runtime_error("Sparsity pattern is in the counting pass.");
+  }
 }
 //-----------------------------------------------------------------------------
 std::int64_t SparsityPattern::num_nonzeros() const
@@ -30,6 +30,15 @@ namespace dolfinx::la
 /// used to initialize sparse matrices. After assembly, column indices
 /// are always sorted in increasing order. Ghost entries are kept after
 /// assembly.
+///
+/// Entries can be inserted in a single pass, in which case they are
+/// cached in a growing array for each row, or in two passes to reduce
+/// the peak memory use. In a two-pass build the same insertions are
+/// made twice: first between SparsityPattern::count_begin and
+/// SparsityPattern::count_end, where only the number of entries in
+/// each row is counted, and then after SparsityPattern::count_end,
+/// where the entries are stored in a single array of the exact size.
+/// Insertion in a two-pass build is thread-safe.
 class SparsityPattern
 {
 
@@ -83,6 +92,19 @@ public:
   /// indices must exist in the row IndexMap.
   void insert_diagonal(const std::span<const std::int32_t>& rows);
 
+  /// @brief Begin the counting pass of a two-pass build.
+  ///
+  /// Until SparsityPattern::count_end is called, insertions only count
+  /// the number of entries in each row.
+  /// @pre No entries have been inserted
+  void count_begin();
+
+  /// @brief End the counting pass of a two-pass build, and allocate
+  /// storage for the counted entries.
+  ///
+  /// The insertions of the counting pass must then be repeated.
+  void count_end();
+
   /// Finalize sparsity pattern and communicate off-process entries
   void assemble();
 
@@ -153,9 +175,29 @@ private:
   // Owning process of ghost columns in owned rows
   std::vector<std::int32_t> _col_ghost_owners;
 
+  // Unassembled entries on row i (owned or ghost)
+  std::span<const std::int32_t> row_entries(std::int32_t i) const;
+
   // Cache for unassembled entries on owned and unowned (ghost) rows
   std::vector<std::vector<std::int32_t>> _row_cache;
 
+  // Insertion mode: single pass (cache), or counting/filling pass of a
+  // two-pass build
+  enum class insert_mode : std::int8_t
+  {
+    cache,
+    count,
+    fill
+  };
+  insert_mode _mode = insert_mode::cache;
+
+  // Two-pass build: unassembled entries of all rows, with entries of row
+  // i in [_entry_offsets[i], _entry_offsets[i + 1]). _entry_pos[i] is the
+  // number of entries counted in row i in the counting pass, and the
+  // next insert position of row i in the fill pass.
+  std::vector<std::int32_t> _entries;
+  std::vector<std::int64_t> _entry_offsets, _entry_pos;
+
   // Sparsity pattern data (computed once pattern is finalised)
   std::shared_ptr<graph::AdjacencyList<std::int32_t>> _graph;
 
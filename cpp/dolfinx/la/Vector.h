@@ -7,13 +7,19 @@
 #pragma once
 
 #include "utils.h"
+#include <array>
 #include <complex>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Scatterer.h>
+#include <dolfinx/common/utils.h>
+#include <initializer_list>
 #include <limits>
 #include <memory>
 #include <numeric>
 #include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::la
@@ -34,18 +40,42 @@ public:
   /// Create a distributed vector
   Vector(const std::shared_ptr<const common::IndexMap>& map, int bs,
          const Allocator& alloc = Allocator())
-      : _map(map), _scatterer(std::make_shared<common::Scatterer>(*_map, bs)),
-        _bs(bs), _buffer_local(_scatterer->local_buffer_size(), alloc),
+      : Vector(map, bs, common::Scatterer::type::neighbor, false, alloc)
+  {
+  }
+
+  /// @brief Create a distributed vector that uses a given communication
+  /// backend for ghost updates.
+  /// @param[in] map The index map
+  /// @param[in] bs The block size
+  /// @param[in] type The communication backend, see
+  /// common::Scatterer::type and common::Scatterer::autotune
+  /// @param[in] shared_memory If true, forward scatters to ranks on the
+  /// same node read the data from shared memory (see
+  /// common::Scatterer::Scatterer)
+  /// @param[in] alloc The memory allocator for the data storage
+  Vector(const std::shared_ptr<const common::IndexMap>& map, int bs,
+         common::Scatterer::type type, bool shared_memory = false,
+         const Allocator& alloc = Allocator())
+      : _map(map), _scatterer(std::make_shared<common::Scatterer>(
+                       *_map, bs, type, shared_memory)),
+        _bs(bs), _request(_scatterer->create_request_vector()),
+        _buffer_local(_scatterer->local_buffer_size(), alloc),
         _buffer_remote(_scatterer->remote_buffer_size(), alloc),
         _x(bs * (map->size_local() + map->num_ghosts()), alloc)
   {
   }
 
-  /// Copy constructor
+  /// @brief Copy constructor
+  /// @note Collective MPI operation if the vector uses the
+  /// common::Scatterer::type::rma backend or shared memory, since the
+  /// copy then creates its own scatterer
   Vector(const Vector& x)
-      : _map(x._map), _scatterer(x._scatterer), _bs(x._bs),
-        _request(MPI_REQUEST_NULL), _buffer_local(x._buffer_local),
-        _buffer_remote(x._buffer_remote), _x(x._x)
+      : _map(x._map), _scatterer(copy_scatterer(x)), _bs(x._bs),
+        _request(_scatterer->create_request_vector()),
+        _persistent(x._persistent),
+        _buffer_local(x._buffer_local), _buffer_remote(x._buffer_remote),
+        _x(x._x)
   {
   }
 
@@ -53,17 +83,47 @@ public:
   Vector(Vector&& x)
       : _map(std::move(x._map)), _scatterer(std::move(x._scatterer)),
         _bs(std::move(x._bs)),
-        _request(std::exchange(x._request, MPI_REQUEST_NULL)),
+        _request(std::move(x._request)), _persistent(x._persistent),
+        _requests_fwd(std::exchange(x._requests_fwd, {})),
+        _requests_rev(std::exchange(x._requests_rev, {})),
         _buffer_local(std::move(x._buffer_local)),
         _buffer_remote(std::move(x._buffer_remote)), _x(std::move(x._x))
   {
   }
 
+  /// Destructor
+  ~Vector() { free_requests(); }
+
   // Assignment operator (disabled)
   Vector& operator=(const Vector& x) = delete;
 
   /// Move Assignment operator
-  Vector& operator=(Vector&& x) = default;
+  Vector& operator=(Vector&& x)
+  {
+    free_requests();
+    _map = std::move(x._map);
+    _scatterer = std::move(x._scatterer);
+    _bs = x._bs;
+    _request = std::move(x._request);
+    _persistent = x._persistent;
+    _buffer_local = std::move(x._buffer_local);
+    _buffer_remote = std::move(x._buffer_remote);
+    _x = std::move(x._x);
+
+    // Persistent requests hold pointers into the buffers, so they can
+    // only be taken over if the buffer storage has been moved
+    using traits = std::allocator_traits<Allocator>;
+    if constexpr (traits::propagate_on_container_move_assignment::value
+                  or traits::is_always_equal::value)
+    {
+      _requests_fwd = std::exchange(x._requests_fwd, {});
+      _requests_rev = std::exchange(x._requests_rev, {});
+    }
+    else
+      x.free_requests();
+
+    return *this;
+  }
 
   /// Set all entries (including ghosts)
   /// @param[in] v The value to set all entries to (on calling rank)
@@ -76,15 +136,23 @@ public:
     const std::int32_t local_size = _bs * _map->size_local();
     std::span<const T> x_local(_x.data(), local_size);
 
-    auto pack = [](const auto& in, const auto& idx, auto& out)
-    {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[i] = in[idx[i]];
-    };
-    pack(x_local, _scatterer->local_indices(), _buffer_local);
+    _scatterer->pack_local(x_local, std::span<T>(_buffer_local));
 
-    _scatterer->scatter_fwd_begin(std::span<const T>(_buffer_local),
-                                  std::span<T>(_buffer_remote), _request);
+    if (_persistent)
+    {
+      if (_requests_fwd.empty())
+      {
+        _requests_fwd = _scatterer->scatter_fwd_init(
+            std::span<const T>(_buffer_local), std::span<T>(_buffer_remote));
+      }
+      _scatterer->scatter_start(_requests_fwd);
+    }
+    else
+    {
+      _scatterer->scatter_fwd_begin(std::span<const T>(_buffer_local),
+                                    std::span<T>(_buffer_remote),
+                                    std::span<MPI_Request>(_request));
+    }
   }
 
   /// End scatter of local data from owner to ghosts on other ranks
@@ -94,16 +162,12 @@ public:
     const std::int32_t local_size = _bs * _map->size_local();
     const std::int32_t num_ghosts = _bs * _map->num_ghosts();
     std::span<T> x_remote(_x.data() + local_size, num_ghosts);
-    _scatterer->scatter_fwd_end(_request);
-
-    auto unpack = [](const auto& in, const auto& idx, auto& out, auto op)
-    {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[idx[i]] = op(out[idx[i]], in[i]);
-    };
-
-    unpack(_buffer_remote, _scatterer->remote_indices(), x_remote,
-           [](auto /*a*/, auto b) { return b; });
+    if (_persistent)
+      _scatterer->scatter_wait(_requests_fwd);
+    else
+      _scatterer->scatter_fwd_end(std::span<MPI_Request>(_request));
+    _scatterer->unpack_remote(std::span<const T>(_buffer_remote), x_remote,
+                              [](auto /*a*/, auto b) { return b; });
   }
 
   /// Scatter local data to ghost positions on other ranks
@@ -122,15 +186,24 @@ public:
     const std::int32_t num_ghosts = _bs * _map->num_ghosts();
     std::span<T> x_remote(_x.data() + local_size, num_ghosts);
 
-    auto pack = [](const auto& in, const auto& idx, auto& out)
-    {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[i] = in[idx[i]];
-    };
-    pack(x_remote, _scatterer->remote_indices(), _buffer_remote);
+    _scatterer->pack_remote(std::span<const T>(x_remote),
+                            std::span<T>(_buffer_remote));
 
-    _scatterer->scatter_rev_begin(std::span<const T>(_buffer_remote),
-                                  std::span<T>(_buffer_local), _request);
+    if (_persistent)
+    {
+      if (_requests_rev.empty())
+      {
+        _requests_rev = _scatterer->scatter_rev_init(
+            std::span<const T>(_buffer_remote), std::span<T>(_buffer_local));
+      }
+      _scatterer->scatter_start(_requests_rev);
+    }
+    else
+    {
+      _scatterer->scatter_rev_begin(std::span<const T>(_buffer_remote),
+                                    std::span<T>(_buffer_local),
+                                    std::span<MPI_Request>(_request));
+    }
   }
 
   /// End scatter of ghost data to owner. This process may receive data
@@ -144,14 +217,11 @@ public:
   {
     const std::int32_t local_size = _bs * _map->size_local();
     std::span<T> x_local(_x.data(), local_size);
-    _scatterer->scatter_rev_end(_request);
-
-    auto unpack = [](const auto& in, const auto& idx, auto& out, auto op)
-    {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[idx[i]] = op(out[idx[i]], in[i]);
-    };
-    unpack(_buffer_local, _scatterer->local_indices(), x_local, op);
+    if (_persistent)
+      _scatterer->scatter_wait(_requests_rev);
+    else
+      _scatterer->scatter_rev_end(std::span<MPI_Request>(_request));
+    _scatterer->unpack_local(std::span<const T>(_buffer_local), x_local, op);
   }
 
   /// Scatter ghost data to owner. This process may receive data from
@@ -166,6 +236,28 @@ public:
     this->scatter_rev_end(op);
   }
 
+  /// @brief Use persistent MPI requests for ghost scatters.
+  ///
+  /// When enabled, the requests for the forward and reverse scatters
+  /// are created on the first scatter in each direction and then
+  /// restarted for every subsequent scatter. This removes the setup cost
+  /// of a non-blocking neighbourhood collective on each ghost update,
+  /// which dominates for small halos and frequent updates.
+  ///
+  /// @note Must not be called while a scatter is in progress. If MPI-4
+  /// is supported, the requests are created collectively and all ranks
+  /// must use the same setting. Persistent requests are not supported
+  /// with the common::Scatterer::type::rma backend.
+  /// @param[in] persistent True to use persistent requests
+  void set_persistent_requests(bool persistent)
+  {
+    if (persistent != _persistent)
+    {
+      free_requests();
+      _persistent = persistent;
+    }
+  }
+
   /// Get IndexMap
   std::shared_ptr<const common::IndexMap> map() const { return _map; }
 
@@ -182,6 +274,34 @@ public:
   constexpr allocator_type allocator() const { return _x.get_allocator(); }
 
 private:
+  // Scatterer for a copy of x. Scatterers that hold the state of the
+  // scatter in progress (RMA windows and shared-memory buffers) cannot
+  // be shared, since the copy may scatter at the same time as x.
+  static std::shared_ptr<const common::Scatterer>
+  copy_scatterer(const Vector& x)
+  {
+    const common::Scatterer::type type = x._scatterer->comm_type();
+    if (type == common::Scatterer::type::rma
+        or x._scatterer->shared_memory())
+    {
+      return std::make_shared<common::Scatterer>(
+          *x._map, x._bs, type, x._scatterer->shared_memory());
+    }
+    else
+      return x._scatterer;
+  }
+
+  // Free persistent requests
+  void free_requests()
+  {
+    for (auto r : {&_requests_fwd, &_requests_rev})
+    {
+      for (MPI_Request& request : *r)
+        MPI_Request_free(&request);
+      r->clear();
+    }
+  }
+
   // Map describing the data layout
   std::shared_ptr<const common::IndexMap> _map;
 
@@ -191,8 +311,15 @@ private:
   // Block size
   int _bs;
 
-  // MPI request handle
-  MPI_Request _request = MPI_REQUEST_NULL;
+  // MPI request handles
+  std::vector<MPI_Request> _request;
+
+  // Use persistent requests for scatters
+  bool _persistent = false;
+
+  // Persistent requests for forward and reverse scatters (created on
+  // first use)
+  std::vector<MPI_Request> _requests_fwd, _requests_rev;
 
   // Buffers for ghost scatters
   std::vector<T, Allocator> _buffer_local, _buffer_remote;
@@ -201,6 +328,57 @@ private:
   std::vector<T, Allocator> _x;
 };
 
+namespace impl
+{
+/// @brief Compute the sum of f(i) for i in [i0, i1).
+///
+/// Independent partial sums are used for consecutive entries, so that
+/// the loop can be vectorized without re-association of a single sum.
+template <typename T, typename F>
+T sum(std::int32_t i0, std::int32_t i1, F&& f)
+{
+  constexpr int lanes = 8;
+  std::array<T, lanes> acc;
+  acc.fill(0);
+  std::int32_t i = i0;
+  for (; i + lanes <= i1; i += lanes)
+    for (int l = 0; l < lanes; ++l)
+      acc[l] += f(i + l);
+  T s = std::accumulate(acc.begin(), acc.end(), T(0));
+  for (; i < i1; ++i)
+    s += f(i);
+  return s;
+}
+
+/// Complex conjugate (identity for real types)
+template <typename T>
+T conj(T a)
+{
+  if constexpr (std::is_same<T, std::complex<double>>::value
+                or std::is_same<T, std::complex<float>>::value)
+  {
+    return std::conj(a);
+  }
+  else
+    return a;
+}
+
+/// Compute the inner product of the owned entries of two vectors on
+/// this process (no communication)
+template <typename T, class Allocator>
+T inner_product_local(const Vector<T, Allocator>& a,
+                      const Vector<T, Allocator>& b)
+{
+  const std::int32_t local_size = a.bs() * a.map()->size_local();
+  if (local_size != b.bs() * b.map()->size_local())
+    throw std::runtime_error("Incompatible vector sizes");
+  const T* x_a = a.array().data();
+  const T* x_b = b.array().data();
+  return sum<T>(0, local_size,
+                [x_a, x_b](std::int32_t i) { return conj(x_a[i]) * x_b[i]; });
+}
+} // namespace impl
+
 /// Compute the inner product of two vectors. The two vectors must have
 /// the same parallel layout
 /// @note Collective MPI operation
@@ -210,31 +388,75 @@ private:
 template <typename T, class Allocator>
 T inner_product(const Vector<T, Allocator>& a, const Vector<T, Allocator>& b)
 {
-  const std::int32_t local_size = a.bs() * a.map()->size_local();
-  if (local_size != b.bs() * b.map()->size_local())
-    throw std::runtime_error("Incompatible vector sizes");
-  std::span<const T> x_a = a.array().subspan(0, local_size);
-  std::span<const T> x_b = b.array().subspan(0, local_size);
-
-  const T local = std::transform_reduce(
-      x_a.begin(), x_a.end(), x_b.begin(), static_cast<T>(0), std::plus{},
-      [](T a, T b) -> T
-      {
-        if constexpr (std::is_same<T, std::complex<double>>::value
-                      or std::is_same<T, std::complex<float>>::value)
-        {
-          return std::conj(a) * b;
-        }
-        else
-          return a * b;
-      });
-
+  const T local = impl::inner_product_local(a, b);
   T result;
   MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
                 a.map()->comm());
   return result;
 }
 
+/// @brief Start a non-blocking computation of several inner products,
+/// `result[i] = a_i^{H} b_i`, using a single reduction.
+///
+/// The local products are computed before returning. The reduction is
+/// completed by la::inner_product_end, which must be called before
+/// `result` is read. Other work, e.g. an operator application, can be
+/// done between the two calls to hide the reduction latency.
+///
+/// @note Collective MPI operation
+/// @param[in] pairs The vector pairs `(a_i, b_i)`. All vectors must
+/// have the same parallel layout.
+/// @param[out] result Array of size `pairs.size()` to hold the inner
+/// products. It must not be modified or destroyed until the reduction
+/// is completed.
+/// @return The MPI request for the reduction
+template <typename T, class Allocator>
+MPI_Request inner_product_begin(
+    std::span<const std::array<const Vector<T, Allocator>*, 2>> pairs,
+    std::span<T> result)
+{
+  assert(pairs.size() == result.size());
+  if (pairs.empty())
+    return MPI_REQUEST_NULL;
+  for (std::size_t i = 0; i < pairs.size(); ++i)
+    result[i] = impl::inner_product_local(*pairs[i][0], *pairs[i][1]);
+
+  MPI_Request request;
+  MPI_Iallreduce(MPI_IN_PLACE, result.data(), result.size(),
+                 dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                 pairs.front()[0]->map()->comm(), &request);
+  return request;
+}
+
+/// @brief Start a non-blocking computation of the inner product
+/// `a^{H} b`.
+///
+/// See la::inner_product_begin for several inner products.
+/// @note Collective MPI operation
+/// @param[in] a A vector
+/// @param[in] b A vector
+/// @param[out] result The inner product. It must not be read, modified
+/// or destroyed until la::inner_product_end has been called.
+/// @return The MPI request for the reduction
+template <typename T, class Allocator>
+MPI_Request inner_product_begin(const Vector<T, Allocator>& a,
+                                const Vector<T, Allocator>& b, T& result)
+{
+  const std::array<const Vector<T, Allocator>*, 2> pair = {&a, &b};
+  return inner_product_begin(
+      std::span<const std::array<const Vector<T, Allocator>*, 2>>(&pair, 1),
+      std::span<T>(&result, 1));
+}
+
+/// @brief Complete a non-blocking inner product computation started by
+/// la::inner_product_begin.
+/// @param[in,out] request The request returned by
+/// la::inner_product_begin
+inline void inner_product_end(MPI_Request& request)
+{
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+
 /// Compute the squared L2 norm of vector
 /// @note Collective MPI operation
 template <typename T, class Allocator>
@@ -273,42 +495,440 @@ auto norm(const Vector<T, Allocator>& a, Norm type = Norm::l2)
   }
 }
 
-/// Orthonormalize a set of vectors
+/// @brief Compute norms of several vectors, using a single reduction.
+/// @note Collective MPI operation
+/// @param[in] x The vectors. They must have the same parallel layout.
+/// @param[in] type Norm type (supported types are \f$L^1\f$,
+/// \f$L^2\f$ and \f$L^\infty\f$)
+/// @return The norm of each vector
+template <typename T, class Allocator>
+auto norms(std::span<const Vector<T, Allocator>* const> x,
+           Norm type = Norm::l2)
+{
+  using U = decltype(std::abs(T()));
+  std::vector<U> result(x.size(), 0);
+  if (x.empty())
+    return result;
+
+  const std::int32_t size_local
+      = x.front()->bs() * x.front()->map()->size_local();
+  for (std::size_t k = 0; k < x.size(); ++k)
+  {
+    const T* _x = x[k]->array().data();
+    switch (type)
+    {
+    case Norm::l1:
+      result[k] = impl::sum<U>(0, size_local, [_x](std::int32_t i)
+                               { return std::abs(_x[i]); });
+      break;
+    case Norm::l2:
+      result[k] = impl::sum<U>(0, size_local, [_x](std::int32_t i)
+                               { return std::norm(_x[i]); });
+      break;
+    case Norm::linf:
+      for (std::int32_t i = 0; i < size_local; ++i)
+        result[k] = std::max(result[k], U(std::abs(_x[i])));
+      break;
+    default:
+      throw std::runtime_error("Norm type not supported");
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, result.data(), result.size(),
+                dolfinx::MPI::mpi_type<U>(),
+                type == Norm::linf ? MPI_MAX : MPI_SUM,
+                x.front()->map()->comm());
+  if (type == Norm::l2)
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](auto r) { return std::sqrt(r); });
+  return result;
+}
+
+/// @brief Compute norms of several vectors, using a single reduction.
+///
+/// Convenience overload for a `std::vector` of vector pointers, for
+/// which the scalar type cannot be deduced from the span overload.
+///
+/// @note Collective MPI operation
+/// @param[in] x The vectors. They must have the same parallel layout.
+/// @param[in] type Norm type
+/// @return The norm of each vector
+template <typename T, class Allocator>
+auto norms(const std::vector<const Vector<T, Allocator>*>& x,
+           Norm type = Norm::l2)
+{
+  return norms(std::span<const Vector<T, Allocator>* const>(x), type);
+}
+
+/// @brief Compute norms of several vectors, using a single reduction.
+///
+/// Convenience overload for a list of vector pointers, e.g.
+/// `norms({&x, &y})`.
+///
+/// @note Collective MPI operation
+/// @param[in] x The vectors. They must have the same parallel layout.
+/// @param[in] type Norm type
+/// @return The norm of each vector
+template <typename T, class Allocator>
+auto norms(std::initializer_list<const Vector<T, Allocator>*> x,
+           Norm type = Norm::l2)
+{
+  return norms(std::span<const Vector<T, Allocator>* const>(x.begin(),
+                                                             x.size()),
+               type);
+}
+
+namespace impl
+{
+/// Number of entries processed together by the fused vector kernels,
+/// small enough for the data of several vectors to stay in cache
+constexpr std::int32_t chunk_size = 1024;
+} // namespace impl
+
+/// @brief Compute w = alpha x + beta y.
+///
+/// The owned entries are updated. Ghost entries of `w` are not
+/// updated. `w` may be the same vector as `x` or `y`.
+///
+/// @param[out] w The result vector
+/// @param[in] alpha Scalar
+/// @param[in] x A vector
+/// @param[in] beta Scalar
+/// @param[in] y A vector
+/// @param[in] num_threads Number of threads
+template <typename T, class Allocator>
+void waxpby(Vector<T, Allocator>& w, T alpha, const Vector<T, Allocator>& x,
+            T beta, const Vector<T, Allocator>& y, int num_threads = 1)
+{
+  const std::int32_t n = w.bs() * w.map()->size_local();
+  const T* _x = x.array().data();
+  const T* _y = y.array().data();
+  T* _w = w.mutable_array().data();
+  common::apply_blocks(n, num_threads,
+                     [=](std::int32_t i0, std::int32_t i1)
+                     {
+                       for (std::int32_t i = i0; i < i1; ++i)
+                         _w[i] = alpha * _x[i] + beta * _y[i];
+                     });
+}
+
+/// @brief Compute y = y + alpha x.
+///
+/// The owned entries are updated. Ghost entries of `y` are not
+/// updated.
+///
+/// @param[in,out] y The vector to update
+/// @param[in] alpha Scalar
+/// @param[in] x A vector
+/// @param[in] num_threads Number of threads
+template <typename T, class Allocator>
+void axpy(Vector<T, Allocator>& y, T alpha, const Vector<T, Allocator>& x,
+          int num_threads = 1)
+{
+  const std::int32_t n = y.bs() * y.map()->size_local();
+  const T* _x = x.array().data();
+  T* _y = y.mutable_array().data();
+  common::apply_blocks(n, num_threads,
+                     [=](std::int32_t i0, std::int32_t i1)
+                     {
+                       for (std::int32_t i = i0; i < i1; ++i)
+                         _y[i] += alpha * _x[i];
+                     });
+}
+
+/// @brief Compute y = y + alpha x and the inner product `z^{H} y` of
+/// the updated `y`, in a single pass.
+///
+/// This fuses, e.g., the residual update and the residual norm of a
+/// conjugate gradient iteration (with `z = y`). The owned entries are
+/// updated. Ghost entries of `y` are not updated.
+///
+/// @note Collective MPI operation
+/// @param[in,out] y The vector to update
+/// @param[in] alpha Scalar
+/// @param[in] x A vector
+/// @param[in] z A vector. It may be the same vector as `y`.
+/// @param[in] num_threads Number of threads
+/// @return `z^{H} y`
+template <typename T, class Allocator>
+T axpy_dot(Vector<T, Allocator>& y, T alpha, const Vector<T, Allocator>& x,
+           const Vector<T, Allocator>& z, int num_threads = 1)
+{
+  const std::int32_t n = y.bs() * y.map()->size_local();
+  const T* _x = x.array().data();
+  const T* _z = z.array().data();
+  T* _y = y.mutable_array().data();
+  const T local = common::reduce_blocks<T>(
+      n, num_threads,
+      [=](std::int32_t i0, std::int32_t i1)
+      {
+        // Update chunks that fit in cache, then compute the inner
+        // product of the chunk while it is in cache
+        T dot = 0;
+        for (std::int32_t c0 = i0; c0 < i1; c0 += impl::chunk_size)
+        {
+          const std::int32_t c1 = std::min(c0 + impl::chunk_size, i1);
+          for (std::int32_t i = c0; i < c1; ++i)
+            _y[i] += alpha * _x[i];
+          dot += impl::sum<T>(c0, c1, [=](std::int32_t i)
+                              { return impl::conj(_z[i]) * _y[i]; });
+        }
+        return dot;
+      });
+
+  T result;
+  MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                y.map()->comm());
+  return result;
+}
+
+/// @brief Compute y = y + sum_i alpha_i x_i.
+///
+/// The owned entries of `y` are updated in chunks that fit in cache, so
+/// that `y` is read and written once for all `x_i`. Ghost entries of
+/// `y` are not updated.
+///
+/// @param[in,out] y The vector to update
+/// @param[in] alpha The scalars `alpha_i`
+/// @param[in] x The vectors `x_i`
+/// @param[in] num_threads Number of threads
+template <typename T, class Allocator>
+void maxpy(Vector<T, Allocator>& y, std::span<const T> alpha,
+           std::span<const Vector<T, Allocator>* const> x,
+           int num_threads = 1)
+{
+  assert(alpha.size() == x.size());
+  const std::int32_t n = y.bs() * y.map()->size_local();
+  T* _y = y.mutable_array().data();
+  std::vector<const T*> _x(x.size());
+  std::transform(x.begin(), x.end(), _x.begin(),
+                 [](auto xk) { return xk->array().data(); });
+  common::apply_blocks(
+      n, num_threads,
+      [&](std::int32_t i0, std::int32_t i1)
+      {
+        for (std::int32_t c0 = i0; c0 < i1; c0 += impl::chunk_size)
+        {
+          const std::int32_t c1 = std::min(c0 + impl::chunk_size, i1);
+
+          // Four vectors at a time, then the remainder
+          std::size_t k = 0;
+          for (; k + 4 <= _x.size(); k += 4)
+          {
+            const T a0 = alpha[k], a1 = alpha[k + 1], a2 = alpha[k + 2],
+                    a3 = alpha[k + 3];
+            const T *x0 = _x[k], *x1 = _x[k + 1], *x2 = _x[k + 2],
+                    *x3 = _x[k + 3];
+            for (std::int32_t i = c0; i < c1; ++i)
+              _y[i] += a0 * x0[i] + a1 * x1[i] + a2 * x2[i] + a3 * x3[i];
+          }
+          for (; k < _x.size(); ++k)
+          {
+            const T a = alpha[k];
+            const T* xk = _x[k];
+            for (std::int32_t i = c0; i < c1; ++i)
+              _y[i] += a * xk[i];
+          }
+        }
+      });
+}
+
+namespace impl
+{
+/// @brief Compute the matrix of inner products `X^{H} Y` (row-major),
+/// using a single reduction.
+///
+/// The owned entries are processed in chunks so that each vector is
+/// read from memory once.
+template <typename T, typename U>
+std::vector<T> inner_products(std::span<const Vector<T, U>> X,
+                              std::span<const Vector<T, U>> Y)
+{
+  const std::size_t m = X.size();
+  const std::size_t n = Y.size();
+  std::vector<T> G(m * n, 0);
+  if (m == 0 or n == 0)
+    return G;
+
+  const std::int32_t size = X.front().bs() * X.front().map()->size_local();
+  for (std::int32_t c0 = 0; c0 < size; c0 += chunk_size)
+  {
+    const std::int32_t c1 = std::min(c0 + chunk_size, size);
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      const T* x = X[i].array().data();
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        const T* y = Y[j].array().data();
+        G[i * n + j] += sum<T>(c0, c1, [x, y](std::int32_t k)
+                               { return conj(x[k]) * y[k]; });
+      }
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, G.data(), G.size(), dolfinx::MPI::mpi_type<T>(),
+                MPI_SUM, X.front().map()->comm());
+  return G;
+}
+
+/// @brief Compute the Cholesky factorization `G = R^{H} R` of a Gram
+/// matrix in-place.
+///
+/// The orthogonal component of a column can only be resolved from the
+/// Gram matrix down to about √ε relative to the column norm. A column
+/// below this is reported by returning `false`, and the caller should
+/// then fall back to a method that works on the vectors.
+///
+/// @param[in,out] G The `k x k` Gram matrix (row-major). On exit, the
+/// upper triangle holds `R` if the factorization succeeded.
+/// @param[in] k The matrix size
+/// @param[in] tol The tolerance used to detect a linear dependency
+/// @return False if a pivot is not resolved by the Gram matrix
+/// @throws std::runtime_error if the orthogonal component of a column
+/// is resolved but smaller than `tol`
+template <typename T>
+bool cholesky(std::span<T> G, std::size_t k, double tol)
+{
+  using V = decltype(std::abs(T()));
+  const double eps = std::numeric_limits<V>::epsilon();
+  for (std::size_t j = 0; j < k; ++j)
+  {
+    for (std::size_t i = 0; i < j; ++i)
+    {
+      T r = G[i * k + j];
+      for (std::size_t l = 0; l < i; ++l)
+        r -= conj(G[l * k + i]) * G[l * k + j];
+      G[i * k + j] = r / G[i * k + i];
+    }
+
+    double d = std::real(G[j * k + j]);
+    const double g = std::sqrt(std::max(d, 0.0));
+    for (std::size_t l = 0; l < j; ++l)
+      d -= std::norm(G[l * k + j]);
+    if (d <= 0 or std::sqrt(d) < std::sqrt(eps) * g)
+      return false;
+    if (std::sqrt(d) < tol)
+    {
+      throw std::runtime_error(
+          "Linear dependency detected. Cannot orthogonalize.");
+    }
+    G[j * k + j] = std::sqrt(d);
+  }
+
+  return true;
+}
+} // namespace impl
+
+/// @brief Orthonormalize a set of vectors.
+///
+/// The vectors are processed in blocks using block classical
+/// Gram-Schmidt with reorthogonalization (BCGS2). Each block is
+/// projected twice against the preceding blocks, and then
+/// orthonormalized by two passes of Cholesky QR. Each projection and
+/// each Cholesky QR pass uses a single reduction, so the number of
+/// global reductions is four per block rather than one per vector
+/// pair.
+///
+/// If the Gram matrix of a block cannot resolve a nearly dependent
+/// vector, the block is orthonormalized by modified Gram-Schmidt (with
+/// reorthogonalization) instead, so that a linear dependency is only
+/// reported if the orthogonal component of a vector is below `tol`.
+///
+/// @note Collective MPI operation
 /// @param[in,out] basis The set of vectors to orthonormalise. The
 /// vectors must have identical parallel layouts. The vectors are
-/// modified in-place.
+/// modified in-place (owned and ghost entries).
 /// @param[in] tol The tolerance used to detect a linear dependency
 template <typename T, typename U>
 void orthonormalize(const std::span<Vector<T, U>>& basis, double tol = 1.0e-10)
 {
-  // Loop over each vector in basis
-  for (std::size_t i = 0; i < basis.size(); ++i)
+  // Block size, which limits the size of the Gram matrices
+  constexpr std::size_t block_size = 16;
+
+  // b <- (b - sum_i c_i q_i) / s (owned and ghost entries), with
+  // stride cs in c
+  auto update = [](Vector<T, U>& b, const T* c, std::size_t cs,
+                   std::span<const Vector<T, U>> q, T s)
   {
-    // Orthogonalize vector i with respect to previously orthonormalized
-    // vectors
-    for (std::size_t j = 0; j < i; ++j)
+    std::span<T> _b = b.mutable_array();
+    const std::int32_t size = _b.size();
+    for (std::int32_t c0 = 0; c0 < size; c0 += impl::chunk_size)
     {
-      // basis_i <- basis_i - dot_ij  basis_j
-      T dot_ij = inner_product(basis[i], basis[j]);
-      std::transform(basis[j].array().begin(), basis[j].array().end(),
-                     basis[i].array().begin(), basis[i].mutable_array().begin(),
-                     [dot_ij](auto xj, auto xi) { return xi - dot_ij * xj; });
+      const std::int32_t c1 = std::min(c0 + impl::chunk_size, size);
+      for (std::size_t i = 0; i < q.size(); ++i)
+      {
+        const T ci = c[i * cs];
+        const T* _q = q[i].array().data();
+        for (std::int32_t k = c0; k < c1; ++k)
+          _b[k] -= ci * _q[k];
+      }
+      for (std::int32_t k = c0; k < c1; ++k)
+        _b[k] /= s;
     }
+  };
 
-    // Normalise basis function
-    double norm = la::norm(basis[i], la::Norm::l2);
-    if (norm < tol)
+  for (std::size_t i0 = 0; i0 < basis.size(); i0 += block_size)
+  {
+    const std::size_t i1 = std::min(i0 + block_size, basis.size());
+    const std::size_t nb = i1 - i0;
+    std::span<const Vector<T, U>> Q = basis.first(i0);
+    std::span<Vector<T, U>> B = basis.subspan(i0, nb);
+
+    // Project the block twice against the preceding (orthonormal)
+    // vectors: B <- B - Q (Q^H B)
+    for (int pass = 0; pass < 2 and i0 > 0; ++pass)
     {
-      throw std::runtime_error(
-          "Linear dependency detected. Cannot orthogonalize.");
+      const std::vector<T> C
+          = impl::inner_products(Q, std::span<const Vector<T, U>>(B));
+      for (std::size_t j = 0; j < nb; ++j)
+        update(B[j], C.data() + j, nb, Q, T(1));
+    }
+
+    // Orthonormalize the block by Cholesky QR, twice: B <- B R^{-1}
+    // with B^H B = R^H R
+    bool cholqr = true;
+    for (int pass = 0; pass < 2 and cholqr; ++pass)
+    {
+      std::vector<T> R = impl::inner_products(
+          std::span<const Vector<T, U>>(B), std::span<const Vector<T, U>>(B));
+      cholqr = impl::cholesky(std::span<T>(R), nb, tol);
+      if (cholqr)
+      {
+        std::span<const Vector<T, U>> _B(B);
+        for (std::size_t j = 0; j < nb; ++j)
+          update(B[j], R.data() + j, nb, _B.first(j), R[j * nb + j]);
+      }
+    }
+
+    // Fall back to modified Gram-Schmidt for the block
+    if (!cholqr)
+    {
+      std::span<const Vector<T, U>> _basis(basis);
+      for (std::size_t j = i0; j < i1; ++j)
+      {
+        for (int pass = 0; pass < 2; ++pass)
+        {
+          for (std::size_t i = 0; i < j; ++i)
+          {
+            const T c = inner_product(basis[i], basis[j]);
+            update(basis[j], &c, 1, _basis.subspan(i, 1), T(1));
+          }
+        }
+
+        const double norm = la::norm(basis[j], Norm::l2);
+        if (norm < tol)
+        {
+          throw std::runtime_error(
+              "Linear dependency detected. Cannot orthogonalize.");
+        }
+        update(basis[j], nullptr, 1, {}, T(norm));
+      }
     }
-    std::transform(basis[i].array().begin(), basis[i].array().end(),
-                   basis[i].mutable_array().begin(),
-                   [norm](auto x) { return x / norm; });
   }
 }
 
 /// Test if basis is orthonormal
+/// @note Collective MPI operation
 /// @param[in] basis The set of vectors to check
 /// @param[in] tol The tolerance used to test for orthonormality
 /// @return True is basis is orthonormal, otherwise false
@@ -316,13 +936,13 @@ template <typename T, typename U>
 bool is_orthonormal(const std::span<const Vector<T, U>>& basis,
                     double tol = 1.0e-10)
 {
+  const std::vector<T> G = impl::inner_products(basis, basis);
   for (std::size_t i = 0; i < basis.size(); i++)
   {
     for (std::size_t j = i; j < basis.size(); j++)
     {
       const double delta_ij = (i == j) ? 1.0 : 0.0;
-      T dot_ij = inner_product(basis[i], basis[j]);
-      if (std::abs(delta_ij - dot_ij) > tol)
+      if (std::abs(delta_ij - G[i * basis.size() + j]) > tol)
         return false;
     }
   }
@@ -0,0 +1,801 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "Vector.h"
+#include "matrix_ops.h"
+#include "preconditioners.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <functional>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Algebraic multigrid preconditioners for la::MatrixCSR
+namespace dolfinx::la::amg
+{
+
+/// Smoother types
+enum class Smoother
+{
+  jacobi,
+  chebyshev,
+  block_jacobi,
+  ilu
+};
+
+/// Parameters for smoothed aggregation algebraic multigrid
+struct Parameters
+{
+  /// Strength of connection threshold. Entry (block) `A_ij` is strong
+  /// if `|A_ij| >= threshold * sqrt(|A_ii| |A_jj|)`, using the Frobenius
+  /// norm of blocks.
+  double threshold = 0.08;
+
+  /// Prolongator smoothing weight. The damping used for smoothing the
+  /// tentative prolongator is this value divided by an estimate of the
+  /// spectral radius of `D^{-1} A`.
+  double prolongation_weight = 4.0 / 3.0;
+
+  /// Maximum number of levels
+  int max_levels = 10;
+
+  /// Stop coarsening when the global number of rows is below this
+  /// value
+  std::int64_t coarse_size = 500;
+
+  /// Largest coarsest level (global number of rows) that is solved
+  /// directly. Larger coarsest levels are smoothed.
+  std::int64_t max_direct_size = 4000;
+
+  /// Smoother type
+  Smoother smoother = Smoother::chebyshev;
+
+  /// Number of Jacobi, block-Jacobi or ILU(0) sweeps, or Chebyshev
+  /// polynomial degree
+  int smoother_steps = 2;
+
+  /// Damping for the Jacobi and block-Jacobi smoothers
+  double jacobi_weight = 2.0 / 3.0;
+
+  /// Ratio between the upper and lower ends of the eigenvalue interval
+  /// targeted by the Chebyshev smoother
+  double chebyshev_ratio = 30.0;
+
+  /// Number of threads used by the smoothers
+  int num_threads = 1;
+};
+
+namespace impl
+{
+/// @brief Aggregate the owned (block) rows of a square matrix.
+///
+/// Aggregation is decoupled, i.e. only connections between owned rows
+/// are considered and aggregates do not cross process boundaries. Rows
+/// without off-diagonal entries, e.g. Dirichlet boundary conditions,
+/// are not aggregated.
+///
+/// @param[in] A The matrix
+/// @param[in] threshold The strength of connection threshold
+/// @return Aggregate of each owned row (-1 if not aggregated) and the
+/// number of aggregates
+template <typename T>
+std::pair<std::vector<std::int32_t>, std::int32_t>
+aggregate(const MatrixCSR<T>& A, double threshold)
+{
+  const std::int32_t num_rows = A.num_owned_rows();
+  const int nbs = A.block_size()[0] * A.block_size()[1];
+  const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+  const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+  const std::vector<std::int32_t>& cols = A.cols();
+  const std::vector<T>& values = A.values();
+
+  auto block_norm = [&values, nbs](std::int32_t j)
+  {
+    double norm = 0;
+    for (int k = 0; k < nbs; ++k)
+      norm += std::norm(values[j * nbs + k]);
+    return std::sqrt(norm);
+  };
+
+  // Norm of diagonal blocks, and rows with off-diagonal entries
+  std::vector<double> dnorm(num_rows, 0);
+  std::vector<std::int8_t> coupled(num_rows, false);
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    for (std::int32_t j = row_ptr[i]; j < row_ptr[i + 1]; ++j)
+    {
+      if (cols[j] == i)
+        dnorm[i] = block_norm(j);
+      else if (block_norm(j) > 0)
+        coupled[i] = true;
+    }
+  }
+
+  // Strong connections between owned rows
+  std::vector<std::int32_t> S_ptr = {0};
+  std::vector<std::int32_t> S;
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    for (std::int32_t j = row_ptr[i]; j < off_diag[i]; ++j)
+    {
+      const double norm = block_norm(j);
+      if (cols[j] != i and norm > 0
+          and norm >= threshold * std::sqrt(dnorm[i] * dnorm[cols[j]]))
+      {
+        S.push_back(cols[j]);
+      }
+    }
+    S_ptr.push_back(S.size());
+  }
+
+  // Pass 1: aggregate rows whose strong neighbours are all free
+  std::vector<std::int32_t> agg(num_rows, -1);
+  std::int32_t num_agg = 0;
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    if (agg[i] != -1 or S_ptr[i] == S_ptr[i + 1])
+      continue;
+    auto S0 = std::next(S.begin(), S_ptr[i]);
+    auto S1 = std::next(S.begin(), S_ptr[i + 1]);
+    if (std::all_of(S0, S1, [&agg](auto j) { return agg[j] == -1; }))
+    {
+      agg[i] = num_agg;
+      std::for_each(S0, S1, [&agg, num_agg](auto j) { agg[j] = num_agg; });
+      ++num_agg;
+    }
+  }
+
+  // Pass 2: add free rows to a neighbouring aggregate from pass 1
+  std::vector<std::int32_t> agg1 = agg;
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    if (agg1[i] != -1)
+      continue;
+    for (std::int32_t j = S_ptr[i]; j < S_ptr[i + 1]; ++j)
+    {
+      if (agg1[S[j]] != -1)
+      {
+        agg[i] = agg1[S[j]];
+        break;
+      }
+    }
+  }
+
+  // Pass 3: create aggregates from the remaining coupled rows and
+  // their free strong neighbours
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    if (agg[i] != -1 or !coupled[i])
+      continue;
+    agg[i] = num_agg;
+    for (std::int32_t j = S_ptr[i]; j < S_ptr[i + 1]; ++j)
+    {
+      if (agg[S[j]] == -1)
+        agg[S[j]] = num_agg;
+    }
+    ++num_agg;
+  }
+
+  return {std::move(agg), num_agg};
+}
+
+/// @brief Create the tentative prolongator by fitting the near
+/// nullspace on each aggregate.
+///
+/// @param[in] A The matrix
+/// @param[in] agg The aggregate of each owned row
+/// @param[in] num_agg The number of aggregates
+/// @param[in] B The near nullspace, with `B[(i * bs + c) * k + m]` for
+/// component `c` of row `i` in vector `m`
+/// @param[in] k The number of near nullspace vectors
+/// @return The tentative prolongator (block size `(bs, k)`) and the
+/// coarse near nullspace
+template <typename T>
+std::pair<MatrixCSR<T>, std::vector<T>>
+tentative_prolongator(const MatrixCSR<T>& A,
+                      std::span<const std::int32_t> agg, std::int32_t num_agg,
+                      std::span<const T> B, int k)
+{
+  const std::shared_ptr<const common::IndexMap> row_map = A.index_maps()[0];
+  const std::int32_t num_rows = row_map->size_local();
+  const int bs = A.block_size()[0];
+
+  // Rows in each aggregate
+  std::vector<std::int32_t> agg_ptr(num_agg + 1, 0);
+  for (std::int32_t a : agg)
+  {
+    if (a >= 0)
+      ++agg_ptr[a + 1];
+  }
+  std::partial_sum(agg_ptr.begin(), agg_ptr.end(), agg_ptr.begin());
+  std::vector<std::int32_t> agg_rows(agg_ptr.back());
+  {
+    std::vector<std::int32_t> pos(agg_ptr.begin(), std::prev(agg_ptr.end()));
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      if (agg[i] >= 0)
+        agg_rows[pos[agg[i]]++] = i;
+    }
+  }
+
+  // Structure of the tentative prolongator: one block per aggregated
+  // row
+  std::vector<std::int32_t> row_ptr(num_rows + row_map->num_ghosts() + 1, 0);
+  std::vector<std::int32_t> cols;
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    if (agg[i] >= 0)
+      cols.push_back(agg[i]);
+    row_ptr[i + 1] = cols.size();
+  }
+  std::fill(std::next(row_ptr.begin(), num_rows + 1), row_ptr.end(),
+            cols.size());
+  std::vector<std::int32_t> row_pos(num_rows, -1);
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    if (agg[i] >= 0)
+      row_pos[i] = row_ptr[i];
+  }
+
+  auto coarse_map
+      = std::make_shared<common::IndexMap>(row_map->comm(), num_agg);
+  MatrixCSR<T> P({row_map, coarse_map}, {bs, k}, std::move(cols),
+                 std::move(row_ptr));
+
+  // Thin QR factorisation of the near nullspace on each aggregate
+  // (modified Gram-Schmidt). Q is stored in the prolongator and R is
+  // the coarse near nullspace.
+  std::vector<T>& Q = P.values();
+  std::vector<T> Bc(num_agg * k * k, 0);
+  for (std::int32_t a = 0; a < num_agg; ++a)
+  {
+    std::span<const std::int32_t> rows(agg_rows.data() + agg_ptr[a],
+                                       agg_ptr[a + 1] - agg_ptr[a]);
+    auto q = [&](std::size_t r, int c, int m) -> T&
+    { return Q[(row_pos[rows[r]] * bs + c) * k + m]; };
+    for (std::size_t r = 0; r < rows.size(); ++r)
+      for (int c = 0; c < bs; ++c)
+        for (int m = 0; m < k; ++m)
+          q(r, c, m) = B[(rows[r] * bs + c) * k + m];
+
+    T* R = Bc.data() + a * k * k;
+    for (int m = 0; m < k; ++m)
+    {
+      double norm0 = 0;
+      for (std::size_t r = 0; r < rows.size(); ++r)
+        for (int c = 0; c < bs; ++c)
+          norm0 += std::norm(q(r, c, m));
+
+      for (int p = 0; p < m; ++p)
+      {
+        T dot = 0;
+        for (std::size_t r = 0; r < rows.size(); ++r)
+        {
+          for (int c = 0; c < bs; ++c)
+            dot += la::impl::conj(q(r, c, p)) * q(r, c, m);
+        }
+        R[p * k + m] = dot;
+        for (std::size_t r = 0; r < rows.size(); ++r)
+          for (int c = 0; c < bs; ++c)
+            q(r, c, m) -= dot * q(r, c, p);
+      }
+
+      double norm = 0;
+      for (std::size_t r = 0; r < rows.size(); ++r)
+        for (int c = 0; c < bs; ++c)
+          norm += std::norm(q(r, c, m));
+      norm = std::sqrt(norm);
+
+      // Drop linearly dependent vectors
+      const bool dependent = norm <= 1e-10 * std::sqrt(norm0);
+      R[m * k + m] = dependent ? 0 : norm;
+      for (std::size_t r = 0; r < rows.size(); ++r)
+        for (int c = 0; c < bs; ++c)
+          q(r, c, m) = dependent ? T(0) : q(r, c, m) / T(norm);
+    }
+  }
+
+  return {std::move(P), std::move(Bc)};
+}
+
+/// @brief Dense LU factorisation with partial pivoting (in-place,
+/// row-major).
+///
+/// Zero pivots, which arise for coarse degrees-of-freedom that are not
+/// coupled to the fine level, are replaced by one.
+template <typename T>
+void lu_factor(std::span<T> A, std::span<std::int32_t> perm)
+{
+  const std::size_t n = perm.size();
+  std::iota(perm.begin(), perm.end(), 0);
+  double max_abs = 0;
+  for (T a : A)
+    max_abs = std::max(max_abs, double(std::abs(a)));
+  for (std::size_t k = 0; k < n; ++k)
+  {
+    std::size_t p = k;
+    for (std::size_t i = k + 1; i < n; ++i)
+    {
+      if (std::abs(A[i * n + k]) > std::abs(A[p * n + k]))
+        p = i;
+    }
+
+    if (std::abs(A[p * n + k]) <= 1e-14 * max_abs)
+    {
+      A[k * n + k] = 1;
+      for (std::size_t i = k + 1; i < n; ++i)
+        A[i * n + k] = 0;
+      continue;
+    }
+
+    if (p != k)
+    {
+      std::swap_ranges(std::next(A.begin(), k * n),
+                       std::next(A.begin(), (k + 1) * n),
+                       std::next(A.begin(), p * n));
+      std::swap(perm[k], perm[p]);
+    }
+
+    for (std::size_t i = k + 1; i < n; ++i)
+    {
+      const T l = A[i * n + k] / A[k * n + k];
+      A[i * n + k] = l;
+      for (std::size_t j = k + 1; j < n; ++j)
+        A[i * n + j] -= l * A[k * n + j];
+    }
+  }
+}
+
+/// Solve with a factorisation computed by lu_factor
+template <typename T>
+void lu_solve(std::span<const T> LU, std::span<const std::int32_t> perm,
+              std::span<const T> b, std::span<T> x)
+{
+  const std::size_t n = perm.size();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    T xi = b[perm[i]];
+    for (std::size_t j = 0; j < i; ++j)
+      xi -= LU[i * n + j] * x[j];
+    x[i] = xi;
+  }
+
+  for (std::size_t i = n; i-- > 0;)
+  {
+    T xi = x[i];
+    for (std::size_t j = i + 1; j < n; ++j)
+      xi -= LU[i * n + j] * x[j];
+    x[i] = xi / LU[i * n + i];
+  }
+}
+} // namespace impl
+
+/// @brief Smoothed aggregation algebraic multigrid preconditioner.
+///
+/// The hierarchy is built from a la::MatrixCSR:
+/// 1. Owned rows are aggregated using strong connections between owned
+///    rows (decoupled aggregation).
+/// 2. A tentative prolongator is created by fitting the near nullspace
+///    (e.g. rigid body modes for elasticity) on each aggregate.
+/// 3. The tentative prolongator `P_0` is smoothed by a damped Jacobi
+///    step, `P = (I - w D^{-1} A) P_0`.
+/// 4. The coarse operator is the Galerkin product `P^T A P`.
+///
+/// The distributed products use la::multiply and la::transpose. Blocked
+/// matrices are supported, with one aggregation node per block and a
+/// coarse block size equal to the number of near nullspace vectors.
+///
+/// A preconditioner application is one V-cycle with a smoother from
+/// la::preconditioners (Jacobi, Chebyshev, block-Jacobi or ILU(0)), and
+/// a direct solve on the coarsest level. With the Jacobi, Chebyshev or
+/// block-Jacobi smoothers the preconditioner is symmetric if `A` is
+/// Hermitian, so it can be used with la::solvers::CG.
+///
+/// @tparam T The scalar type
+template <typename T>
+class SmoothedAggregation
+{
+public:
+  /// @brief Create the multigrid hierarchy.
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] A The finalized operator. It must be square, with the
+  /// same owned rows and columns, and must outlive the preconditioner.
+  /// @param[in] nullspace Vectors that span the near nullspace of `A`,
+  /// with the block size of `A`. If empty, the constant vector for
+  /// each component of a block is used.
+  /// @param[in] params Parameters
+  SmoothedAggregation(const MatrixCSR<T>& A,
+                      std::span<const Vector<T>> nullspace = {},
+                      const Parameters& params = {})
+      : _params(params), _A0(&A)
+  {
+    const std::array<int, 2> bs = A.block_size();
+    if (bs[0] != bs[1])
+      throw std::runtime_error("Matrix must have square blocks.");
+
+    // Near nullspace
+    const std::int32_t num_rows = A.num_owned_rows();
+    int k = nullspace.empty() ? bs[0] : nullspace.size();
+    std::vector<T> B(num_rows * bs[0] * k, 0);
+    for (std::int32_t i = 0; i < num_rows * bs[0]; ++i)
+    {
+      for (int m = 0; m < k; ++m)
+      {
+        if (nullspace.empty())
+          B[i * k + m] = (i % bs[0] == m) ? 1 : 0;
+        else
+          B[i * k + m] = nullspace[m].array()[i];
+      }
+    }
+
+    for (int l = 0;; ++l)
+    {
+      const MatrixCSR<T>& Al = op(l);
+      auto [dinv, rho] = preconditioners::impl::inverse_diagonal(Al);
+      _dinv.push_back(std::move(dinv));
+      _rho.push_back(rho);
+
+      const std::int64_t size
+          = Al.index_maps()[0]->size_global() * Al.block_size()[0];
+      if (size <= _params.coarse_size or l == _params.max_levels - 1)
+        break;
+
+      auto [agg, num_agg] = impl::aggregate(Al, _params.threshold);
+      std::int64_t num_agg_global = num_agg;
+      MPI_Allreduce(MPI_IN_PLACE, &num_agg_global, 1, MPI_INT64_T, MPI_SUM,
+                    Al.index_maps()[0]->comm());
+      if (num_agg_global == 0 or num_agg_global * k >= size)
+        break;
+
+      auto [P0, Bc] = impl::tentative_prolongator(
+          Al, std::span<const std::int32_t>(agg), num_agg,
+          std::span<const T>(B), k);
+      MatrixCSR<T> P = smooth_prolongator(Al, P0, agg, l);
+      MatrixCSR<T> R = la::transpose(P);
+      MatrixCSR<T> AP = la::multiply(Al, P);
+      MatrixCSR<T> Ac = la::multiply(R, AP);
+
+      _P.push_back(std::move(P));
+      _R.push_back(std::move(R));
+      _A.push_back(std::move(Ac));
+      B = std::move(Bc);
+    }
+
+    // Work vectors
+    const int num_levels = _A.size() + 1;
+    for (int l = 0; l < num_levels; ++l)
+    {
+      const MatrixCSR<T>& Al = op(l);
+      const int bs_l = Al.block_size()[0];
+      std::array<Vector<T>, 3> w = {Vector<T>(Al.index_maps()[1], bs_l),
+                                    Vector<T>(Al.index_maps()[1], bs_l),
+                                    Vector<T>(Al.index_maps()[1], bs_l)};
+      _work.push_back(std::move(w));
+      _smoothers.push_back(create_smoother(Al));
+      if (l < num_levels - 1)
+      {
+        _xc.emplace_back(_P[l].index_maps()[1], _P[l].block_size()[1]);
+        _rf.emplace_back(_R[l].index_maps()[1], _R[l].block_size()[1]);
+      }
+    }
+
+    // Direct solver on the coarsest level
+    const MatrixCSR<T>& Ac = op(num_levels - 1);
+    if (Ac.index_maps()[0]->size_global() * Ac.block_size()[0]
+        <= _params.max_direct_size)
+    {
+      setup_coarse_solver(Ac);
+    }
+  }
+
+  /// Copy constructor (deleted, the smoothers refer to the operators)
+  SmoothedAggregation(const SmoothedAggregation& amg) = delete;
+
+  /// Move constructor
+  SmoothedAggregation(SmoothedAggregation&& amg) = default;
+
+  /// Destructor
+  ~SmoothedAggregation() = default;
+
+  /// Copy assignment (deleted)
+  SmoothedAggregation& operator=(const SmoothedAggregation& amg) = delete;
+
+  /// Move assignment
+  SmoothedAggregation& operator=(SmoothedAggregation&& amg) = default;
+
+  /// @brief Apply the preconditioner, `y = M^{-1} x`.
+  /// @param[in] x The input vector (owned entries are used)
+  /// @param[out] y The output vector (owned entries are set)
+  void operator()(Vector<T>& x, Vector<T>& y)
+  {
+    const std::size_t n = x.bs() * x.map()->size_local();
+    std::copy_n(x.array().begin(), n, _work[0][b].mutable_array().begin());
+    vcycle(0);
+    std::copy_n(_work[0][u].array().begin(), n, y.mutable_array().begin());
+  }
+
+  /// Number of levels in the hierarchy
+  int num_levels() const { return _A.size() + 1; }
+
+  /// @brief Operator complexity, i.e. the number of stored values on
+  /// all levels divided by the number on the finest level.
+  /// @note Collective MPI operation
+  double operator_complexity() const
+  {
+    std::array<std::int64_t, 2> nnz = {0, 0};
+    for (int l = 0; l < num_levels(); ++l)
+    {
+      const MatrixCSR<T>& Al = op(l);
+      const std::int64_t n = Al.row_ptr()[Al.num_owned_rows()]
+                             * Al.block_size()[0] * Al.block_size()[1];
+      nnz[0] += n;
+      if (l == 0)
+        nnz[1] = n;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, nnz.data(), 2, MPI_INT64_T, MPI_SUM,
+                  _A0->index_maps()[0]->comm());
+    return double(nnz[0]) / double(nnz[1]);
+  }
+
+private:
+  // Indices of work vectors
+  static constexpr int u = 0, b = 1, t = 2;
+
+  // Operator on level l
+  const MatrixCSR<T>& op(int l) const { return l == 0 ? *_A0 : _A[l - 1]; }
+
+  // Compute P = (I - w D^{-1} A) P0, where w is the damping weight
+  MatrixCSR<T> smooth_prolongator(const MatrixCSR<T>& A,
+                                  const MatrixCSR<T>& P0,
+                                  std::span<const std::int32_t> agg, int l)
+  {
+    MatrixCSR<T> P = la::multiply(A, P0);
+    const std::array<int, 2> bs = P.block_size();
+    const int nbs = bs[0] * bs[1];
+    const T w = _params.prolongation_weight / _rho[l];
+    const std::vector<std::int32_t>& row_ptr = P.row_ptr();
+    const std::vector<std::int32_t>& off_diag = P.off_diag_offset();
+    const std::vector<std::int32_t>& cols = P.cols();
+    const std::vector<T>& P0_values = P0.values();
+    std::vector<T>& values = P.values();
+    for (std::int32_t i = 0; i < P.num_owned_rows(); ++i)
+    {
+      for (std::int32_t j = row_ptr[i]; j < row_ptr[i + 1]; ++j)
+      {
+        for (int k0 = 0; k0 < bs[0]; ++k0)
+        {
+          for (int k1 = 0; k1 < bs[1]; ++k1)
+            values[j * nbs + k0 * bs[1] + k1] *= -w * _dinv[l][i * bs[0] + k0];
+        }
+      }
+
+      // Add P0 (the aggregate is an owned column)
+      if (agg[i] >= 0)
+      {
+        auto c0 = std::next(cols.begin(), row_ptr[i]);
+        auto c1 = std::next(cols.begin(), off_diag[i]);
+        auto it = std::lower_bound(c0, c1, agg[i]);
+        if (it == c1 or *it != agg[i])
+          throw std::runtime_error("Matrix has no diagonal entry.");
+        const std::size_t pos = std::distance(cols.begin(), it);
+        const std::size_t pos0 = P0.row_ptr()[i];
+        for (int k = 0; k < nbs; ++k)
+          values[pos * nbs + k] += P0_values[pos0 * nbs + k];
+      }
+    }
+
+    return P;
+  }
+
+  // Gather the coarsest operator on all ranks and factorise it
+  void setup_coarse_solver(const MatrixCSR<T>& A)
+  {
+    const common::IndexMap& col_map = *A.index_maps()[1];
+    const int bs = A.block_size()[0];
+    const std::int64_t c0 = col_map.local_range()[0];
+    const std::int32_t nc = col_map.size_local();
+    const std::int64_t n = A.index_maps()[0]->size_global() * bs;
+    const std::int32_t num_rows = A.num_owned_rows();
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& cols = A.cols();
+    const std::vector<T>& values = A.values();
+
+    // Owned rows with global columns
+    std::vector<T> A_local(num_rows * bs * n, 0);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      for (std::int32_t j = row_ptr[i]; j < row_ptr[i + 1]; ++j)
+      {
+        const std::int64_t col
+            = cols[j] < nc ? c0 + cols[j] : col_map.ghosts()[cols[j] - nc];
+        for (int k0 = 0; k0 < bs; ++k0)
+        {
+          for (int k1 = 0; k1 < bs; ++k1)
+          {
+            A_local[(i * bs + k0) * n + col * bs + k1]
+                = values[(j * bs + k0) * bs + k1];
+          }
+        }
+      }
+    }
+
+    MPI_Comm comm = col_map.comm();
+    const int size = dolfinx::MPI::size(comm);
+    _coarse_counts.resize(size);
+    const int num_local = num_rows * bs;
+    MPI_Allgather(&num_local, 1, MPI_INT, _coarse_counts.data(), 1, MPI_INT,
+                  comm);
+    _coarse_disp.resize(size + 1, 0);
+    std::partial_sum(_coarse_counts.begin(), _coarse_counts.end(),
+                     std::next(_coarse_disp.begin()));
+
+    std::vector<int> counts(size), disp(size + 1, 0);
+    std::transform(_coarse_counts.begin(), _coarse_counts.end(),
+                   counts.begin(), [n](auto c) { return c * n; });
+    std::partial_sum(counts.begin(), counts.end(), std::next(disp.begin()));
+    _lu.resize(n * n);
+    MPI_Allgatherv(A_local.data(), A_local.size(), dolfinx::MPI::mpi_type<T>(),
+                   _lu.data(), counts.data(), disp.data(),
+                   dolfinx::MPI::mpi_type<T>(), comm);
+    _perm.resize(n);
+    impl::lu_factor(std::span<T>(_lu), std::span<std::int32_t>(_perm));
+    _coarse_b.resize(n);
+    _coarse_x.resize(n);
+  }
+
+  // Create the smoother for A u = b
+  std::function<void(const Vector<T>&, Vector<T>&)>
+  create_smoother(const MatrixCSR<T>& A) const
+  {
+    const int steps = _params.smoother_steps;
+    const int num_threads = _params.num_threads;
+    switch (_params.smoother)
+    {
+    case Smoother::jacobi:
+    {
+      auto s = std::make_shared<preconditioners::Jacobi<T>>(
+          A, _params.jacobi_weight, num_threads);
+      return [s, steps](const Vector<T>& b, Vector<T>& u)
+      { s->smooth(b, u, steps); };
+    }
+    case Smoother::chebyshev:
+    {
+      // Use the Gershgorin bound for the upper end of the spectrum, as
+      // for the prolongator smoothing
+      auto s = std::make_shared<preconditioners::Chebyshev<T>>(
+          A, steps, _params.chebyshev_ratio, 0, num_threads);
+      return [s](const Vector<T>& b, Vector<T>& u) { s->smooth(b, u, 1); };
+    }
+    case Smoother::block_jacobi:
+    {
+      auto s = std::make_shared<preconditioners::BlockJacobi<T>>(
+          A, _params.jacobi_weight, num_threads);
+      return [s, steps](const Vector<T>& b, Vector<T>& u)
+      { s->smooth(b, u, steps); };
+    }
+    case Smoother::ilu:
+    {
+      auto s = std::make_shared<preconditioners::ILU0<T>>(A, num_threads);
+      return [s, steps](const Vector<T>& b, Vector<T>& u)
+      { s->smooth(b, u, steps); };
+    }
+    default:
+      throw std::runtime_error("Unsupported smoother");
+    }
+  }
+
+  // Smooth A u = b on level l
+  void smooth(int l) { _smoothers[l](_work[l][b], _work[l][u]); }
+
+  // Apply a V-cycle on level l to b, with zero initial guess
+  void vcycle(int l)
+  {
+    std::array<Vector<T>, 3>& w = _work[l];
+    const std::size_t n = _dinv[l].size();
+    w[u].set(0);
+
+    // Coarsest level
+    if (l == num_levels() - 1)
+    {
+      if (_lu.empty())
+        smooth(l);
+      else
+      {
+        MPI_Comm comm = w[b].map()->comm();
+        MPI_Allgatherv(w[b].array().data(), n, dolfinx::MPI::mpi_type<T>(),
+                       _coarse_b.data(), _coarse_counts.data(),
+                       _coarse_disp.data(), dolfinx::MPI::mpi_type<T>(), comm);
+        impl::lu_solve(std::span<const T>(_lu),
+                       std::span<const std::int32_t>(_perm),
+                       std::span<const T>(_coarse_b), std::span<T>(_coarse_x));
+        const int rank = dolfinx::MPI::rank(comm);
+        std::copy_n(std::next(_coarse_x.begin(), _coarse_disp[rank]), n,
+                    w[u].mutable_array().begin());
+      }
+      return;
+    }
+
+    // Pre-smoothing
+    smooth(l);
+
+    // Restrict residual, r_c = R (b - A u)
+    op(l).mult(w[u], w[t]);
+    std::span<const T> _b = w[b].array();
+    std::span<const T> _t = w[t].array();
+    std::span<T> rf = _rf[l].mutable_array();
+    for (std::size_t i = 0; i < n; ++i)
+      rf[i] = _b[i] - _t[i];
+    _R[l].mult(_rf[l], _work[l + 1][b]);
+
+    // Coarse correction, u <- u + P u_c
+    vcycle(l + 1);
+    const std::size_t nc = _dinv[l + 1].size();
+    std::copy_n(_work[l + 1][u].array().begin(), nc,
+                _xc[l].mutable_array().begin());
+    _P[l].mult(_xc[l], w[t]);
+    std::span<T> _u = w[u].mutable_array();
+    for (std::size_t i = 0; i < n; ++i)
+      _u[i] += _t[i];
+
+    // Post-smoothing
+    smooth(l);
+  }
+
+  // Parameters
+  Parameters _params;
+
+  // Finest level operator
+  const MatrixCSR<T>* _A0;
+
+  // Coarse operators (levels 1, 2, ...)
+  std::vector<MatrixCSR<T>> _A;
+
+  // Prolongation (l + 1 -> l) and restriction (l -> l + 1) operators
+  std::vector<MatrixCSR<T>> _P, _R;
+
+  // Pointwise inverse diagonal on each level (owned rows)
+  std::vector<std::vector<T>> _dinv;
+
+  // Smoother on each level
+  std::vector<std::function<void(const Vector<T>&, Vector<T>&)>> _smoothers;
+
+  // Upper bound on the spectral radius of D^{-1} A on each level
+  std::vector<double> _rho;
+
+  // Work vectors on each level (on the column map of the operator):
+  // solution, right-hand side and a temporary
+  std::vector<std::array<Vector<T>, 3>> _work;
+
+  // Coarse vectors on the column map of P, and fine vectors on the
+  // column map of R
+  std::vector<Vector<T>> _xc, _rf;
+
+  // LU factorisation of the coarsest operator (empty if the coarsest
+  // level is smoothed)
+  std::vector<T> _lu;
+  std::vector<std::int32_t> _perm;
+
+  // Sizes and offsets of the coarsest level on each rank, and work
+  // arrays for the coarse solve
+  std::vector<int> _coarse_counts, _coarse_disp;
+  std::vector<T> _coarse_b, _coarse_x;
+};
+
+} // namespace dolfinx::la::amg
@@ -0,0 +1,785 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Operations on distributed sparse matrices
+namespace dolfinx::la
+{
+
+namespace impl
+{
+/// @brief Create a neighbourhood communicator for sending data from
+/// the ranks that ghost indices to the owners (`reverse = false`), or
+/// from the owners to the ranks that ghost indices (`reverse = true`).
+inline dolfinx::MPI::Comm create_neighbor_comm(const common::IndexMap& map,
+                                               bool reverse)
+{
+  const std::vector<int>& src = map.src();
+  const std::vector<int>& dest = map.dest();
+  const std::vector<int>& in = reverse ? src : dest;
+  const std::vector<int>& out = reverse ? dest : src;
+  MPI_Comm comm;
+  MPI_Dist_graph_create_adjacent(map.comm(), in.size(), in.data(),
+                                 MPI_UNWEIGHTED, out.size(), out.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
+  return dolfinx::MPI::Comm(comm, false);
+}
+
+/// @brief Send variable-sized data to the out-neighbours of a
+/// neighbourhood communicator.
+/// @param[in] comm Neighbourhood communicator
+/// @param[in] data Data to send, packed by destination
+/// @param[in] disp Offset into `data` for each out-neighbour (size
+/// is the number of out-neighbours plus one)
+/// @return Received data and the offset for each in-neighbour
+template <typename U>
+std::pair<std::vector<U>, std::vector<int>>
+neighbor_alltoallv(MPI_Comm comm, std::span<const U> data,
+                   std::span<const int> disp)
+{
+  int indegree(-1), outdegree(-2), weighted(-1);
+  MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
+  assert(disp.size() == std::size_t(outdegree + 1));
+
+  std::vector<int> send_sizes(outdegree);
+  std::adjacent_difference(std::next(disp.begin()), disp.end(),
+                           send_sizes.begin());
+  if (!send_sizes.empty())
+    send_sizes.front() = disp[1] - disp[0];
+
+  std::vector<int> recv_sizes(indegree);
+  send_sizes.reserve(1);
+  recv_sizes.reserve(1);
+  MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1,
+                        MPI_INT, comm);
+
+  std::vector<int> recv_disp(indegree + 1, 0);
+  std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                   std::next(recv_disp.begin()));
+  std::vector<U> recv_data(recv_disp.back());
+  MPI_Neighbor_alltoallv(data.data(), send_sizes.data(), disp.data(),
+                         dolfinx::MPI::mpi_type<U>(), recv_data.data(),
+                         recv_sizes.data(), recv_disp.data(),
+                         dolfinx::MPI::mpi_type<U>(), comm);
+
+  return {std::move(recv_data), std::move(recv_disp)};
+}
+
+/// @brief Create a matrix from owned rows with global column indices.
+///
+/// The column index map is created from the owned column range
+/// `[c0, c0 + nc)` and the columns outside this range. Ghost rows (of
+/// `row_map`) are empty.
+///
+/// @param[in] row_map The row index map
+/// @param[in] bs The block sizes
+/// @param[in] c0 First owned (global) column
+/// @param[in] nc Number of owned columns
+/// @param[in] row_ptr Offset of each owned row in `cols`
+/// @param[in] cols Global column indices. They must be unique on each
+/// row.
+/// @param[in] ghost_owners Pairs (global column, owner) for columns
+/// outside the owned range. May contain duplicates.
+/// @param[out] perm Position in the matrix data of each entry in
+/// `cols`
+template <typename T>
+MatrixCSR<T>
+create_matrix(std::shared_ptr<const common::IndexMap> row_map,
+              std::array<int, 2> bs, std::int64_t c0, std::int32_t nc,
+              std::span<const std::int32_t> row_ptr,
+              std::span<const std::int64_t> cols,
+              std::vector<std::pair<std::int64_t, int>>& ghost_owners,
+              std::vector<std::int32_t>& perm)
+{
+  std::sort(ghost_owners.begin(), ghost_owners.end());
+  ghost_owners.erase(std::unique(ghost_owners.begin(), ghost_owners.end()),
+                     ghost_owners.end());
+  std::vector<std::int64_t> ghosts(ghost_owners.size());
+  std::vector<int> owners(ghost_owners.size());
+  for (std::size_t i = 0; i < ghost_owners.size(); ++i)
+    std::tie(ghosts[i], owners[i]) = ghost_owners[i];
+  auto col_map = std::make_shared<common::IndexMap>(row_map->comm(), nc,
+                                                    ghosts, owners);
+
+  // Convert to local column indices and sort each row
+  const std::int32_t num_rows = row_ptr.size() - 1;
+  std::vector<std::int32_t> local_cols(cols.size());
+  for (std::size_t j = 0; j < cols.size(); ++j)
+  {
+    if (cols[j] >= c0 and cols[j] < c0 + nc)
+      local_cols[j] = cols[j] - c0;
+    else
+    {
+      auto it = std::lower_bound(ghosts.begin(), ghosts.end(), cols[j]);
+      assert(it != ghosts.end() and *it == cols[j]);
+      local_cols[j] = nc + std::distance(ghosts.begin(), it);
+    }
+  }
+
+  perm.resize(cols.size());
+  std::vector<std::int32_t> sorted_cols(cols.size());
+  for (std::int32_t r = 0; r < num_rows; ++r)
+  {
+    auto p0 = std::next(perm.begin(), row_ptr[r]);
+    auto p1 = std::next(perm.begin(), row_ptr[r + 1]);
+    std::vector<std::int32_t> order(std::distance(p0, p1));
+    std::iota(order.begin(), order.end(), row_ptr[r]);
+    std::sort(order.begin(), order.end(), [&local_cols](auto a, auto b)
+              { return local_cols[a] < local_cols[b]; });
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+      sorted_cols[row_ptr[r] + k] = local_cols[order[k]];
+      perm[order[k]] = row_ptr[r] + k;
+    }
+  }
+
+  // Ghost rows are empty
+  std::vector<std::int32_t> _row_ptr(row_ptr.begin(), row_ptr.end());
+  _row_ptr.resize(row_map->size_local() + row_map->num_ghosts() + 1,
+                  _row_ptr.back());
+
+  return MatrixCSR<T>({row_map, col_map}, bs, std::move(sorted_cols),
+                      std::move(_row_ptr));
+}
+} // namespace impl
+
+/// @brief Distributed sparse matrix-matrix product C = A B, with
+/// separate symbolic and numeric phases.
+///
+/// The symbolic phase (constructor) fetches the structure of the rows
+/// of `B` that are needed for the ghost columns of `A` from the owning
+/// ranks, and creates `C` with zero values. The numeric phase
+/// (MatrixProduct::compute) fetches only the values of these rows and
+/// computes the values of `C`. It can be called repeatedly for
+/// matrices with the same sparsity and layout as at construction, e.g.
+/// when a multigrid hierarchy is rebuilt for new matrix values.
+///
+/// The row index map of `C` is the row index map of `A`. The column
+/// index map of `C` is created, with the owned range of the column
+/// index map of `B` and ghosts for the off-process columns in the owned
+/// rows of `C`.
+///
+/// @note Ghost rows of `A` and `B` are ignored. The matrices should be
+/// finalized.
+template <typename T>
+class MatrixProduct
+{
+public:
+  /// @brief Create the product structure (symbolic phase).
+  /// @note Collective MPI operation
+  /// @param[in] A The left matrix
+  /// @param[in] B The right matrix. The owned range of its row index
+  /// map must be the same as the owned range of the column index map
+  /// of `A`.
+  MatrixProduct(const MatrixCSR<T>& A, const MatrixCSR<T>& B)
+      : _maps_A(A.index_maps()), _maps_B(B.index_maps()),
+        _nnz({A.cols().size(), B.cols().size()}),
+        _comm(impl::create_neighbor_comm(*_maps_A[1], true))
+  {
+    const std::array<int, 2> bsA = A.block_size();
+    const std::array<int, 2> bsB = B.block_size();
+    if (bsA[1] != bsB[0])
+      throw std::runtime_error("Incompatible block sizes.");
+    const common::IndexMap& mapA = *_maps_A[1];
+    const common::IndexMap& mapB = *_maps_B[0];
+    if (mapA.local_range() != mapB.local_range())
+      throw std::runtime_error("Incompatible matrix layouts.");
+
+    // Pack requests (global row indices of B) by owner, and keep the
+    // ghost column of A for each request
+    const std::vector<std::int64_t>& ghosts = mapA.ghosts();
+    const std::vector<int>& src = mapA.src();
+    std::vector<int> req_disp(src.size() + 1, 0);
+    std::vector<int> nbr(ghosts.size());
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+      auto it = std::lower_bound(src.begin(), src.end(), mapA.owners()[i]);
+      assert(it != src.end() and *it == mapA.owners()[i]);
+      nbr[i] = std::distance(src.begin(), it);
+      ++req_disp[nbr[i] + 1];
+    }
+    std::partial_sum(req_disp.begin(), req_disp.end(), req_disp.begin());
+    std::vector<std::int64_t> requests(ghosts.size());
+    _ghost_to_fetched.resize(ghosts.size());
+    {
+      std::vector<int> pos(req_disp.begin(), std::prev(req_disp.end()));
+      for (std::size_t i = 0; i < ghosts.size(); ++i)
+      {
+        _ghost_to_fetched[i] = pos[nbr[i]];
+        requests[pos[nbr[i]]++] = ghosts[i];
+      }
+    }
+
+    // Send requests to owners
+    dolfinx::MPI::Comm comm0 = impl::create_neighbor_comm(mapA, false);
+    auto [recv_rows, recv_disp] = impl::neighbor_alltoallv(
+        comm0.comm(), std::span<const std::int64_t>(requests),
+        std::span<const int>(req_disp));
+
+    // Pack the structure of the requested rows, with global column
+    // indices and column owners
+    const common::IndexMap& colB = *_maps_B[1];
+    const std::int64_t r0 = mapB.local_range()[0];
+    const std::int64_t c0 = colB.local_range()[0];
+    const std::int32_t nc = colB.size_local();
+    const int rank = dolfinx::MPI::rank(mapA.comm());
+    const int nbsB = bsB[0] * bsB[1];
+    const std::vector<std::int32_t>& B_row_ptr = B.row_ptr();
+    const std::vector<std::int32_t>& B_cols = B.cols();
+
+    _send_rows.resize(recv_rows.size());
+    std::vector<std::int32_t> row_sizes(recv_rows.size());
+    std::vector<int> data_disp(recv_disp.size(), 0);
+    std::vector<std::int64_t> send_cols;
+    std::vector<int> send_owners;
+    for (std::size_t p = 0; p < recv_disp.size() - 1; ++p)
+    {
+      for (int i = recv_disp[p]; i < recv_disp[p + 1]; ++i)
+      {
+        const std::int32_t r = recv_rows[i] - r0;
+        assert(r >= 0 and r < mapB.size_local());
+        _send_rows[i] = r;
+        row_sizes[i] = B_row_ptr[r + 1] - B_row_ptr[r];
+        for (std::int32_t j = B_row_ptr[r]; j < B_row_ptr[r + 1]; ++j)
+        {
+          if (B_cols[j] < nc)
+          {
+            send_cols.push_back(B_cols[j] + c0);
+            send_owners.push_back(rank);
+          }
+          else
+          {
+            send_cols.push_back(colB.ghosts()[B_cols[j] - nc]);
+            send_owners.push_back(colB.owners()[B_cols[j] - nc]);
+          }
+        }
+      }
+      data_disp[p + 1] = send_cols.size();
+    }
+
+    // Send the structure back to the requesting ranks
+    auto [sizes_in, sizes_disp] = impl::neighbor_alltoallv(
+        _comm.comm(), std::span<const std::int32_t>(row_sizes),
+        std::span<const int>(recv_disp));
+    auto [cols_in, cols_disp] = impl::neighbor_alltoallv(
+        _comm.comm(), std::span<const std::int64_t>(send_cols),
+        std::span<const int>(data_disp));
+    auto [owners_in, owners_disp] = impl::neighbor_alltoallv(
+        _comm.comm(), std::span<const int>(send_owners),
+        std::span<const int>(data_disp));
+
+    // Value counts and displacements for the numeric phase
+    auto to_values = [nbsB](std::span<const int> disp, std::vector<int>& d,
+                            std::vector<int>& sizes)
+    {
+      d.resize(disp.size());
+      std::transform(disp.begin(), disp.end(), d.begin(),
+                     [nbsB](auto x) { return x * nbsB; });
+      sizes.resize(d.size() - 1);
+      for (std::size_t p = 0; p < sizes.size(); ++p)
+        sizes[p] = d[p + 1] - d[p];
+      sizes.reserve(1);
+    };
+    to_values(data_disp, _send_disp, _send_sizes);
+    to_values(cols_disp, _recv_disp, _recv_sizes);
+    _send_values.resize(_send_disp.back());
+    _recv_values.resize(_recv_disp.back());
+
+    // Ghost columns of C: off-process columns in the owned rows of B
+    // that are used by A, and in the fetched rows
+    const std::int32_t nb = mapB.size_local();
+    const std::vector<std::int32_t>& A_row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& A_cols = A.cols();
+    const std::int32_t num_rows = A.num_owned_rows();
+    std::vector<std::int8_t> row_used(nb, false);
+    for (std::int32_t j = 0; j < A_row_ptr[num_rows]; ++j)
+      if (A_cols[j] < nb)
+        row_used[A_cols[j]] = true;
+    std::vector<std::pair<std::int64_t, int>> ghost_owners;
+    _B_col_to_C.assign(nc + colB.num_ghosts(), -1);
+    for (std::int32_t r = 0; r < nb; ++r)
+    {
+      if (!row_used[r])
+        continue;
+      for (std::int32_t j = B_row_ptr[r]; j < B_row_ptr[r + 1]; ++j)
+      {
+        if (B_cols[j] >= nc)
+        {
+          const std::int32_t g = B_cols[j] - nc;
+          ghost_owners.push_back({colB.ghosts()[g], colB.owners()[g]});
+        }
+      }
+    }
+    for (std::size_t j = 0; j < cols_in.size(); ++j)
+      if (cols_in[j] < c0 or cols_in[j] >= c0 + nc)
+        ghost_owners.push_back({cols_in[j], owners_in[j]});
+    std::sort(ghost_owners.begin(), ghost_owners.end());
+    ghost_owners.erase(std::unique(ghost_owners.begin(), ghost_owners.end()),
+                       ghost_owners.end());
+    std::vector<std::int64_t> ghostsC(ghost_owners.size());
+    std::vector<int> ownersC(ghost_owners.size());
+    for (std::size_t i = 0; i < ghost_owners.size(); ++i)
+      std::tie(ghostsC[i], ownersC[i]) = ghost_owners[i];
+    auto col_map = std::make_shared<common::IndexMap>(mapA.comm(), nc,
+                                                      ghostsC, ownersC);
+
+    // Local column of C for global column c
+    auto local_col = [&ghostsC, c0, nc](std::int64_t c) -> std::int32_t
+    {
+      if (c >= c0 and c < c0 + nc)
+        return c - c0;
+      auto it = std::lower_bound(ghostsC.begin(), ghostsC.end(), c);
+      assert(it != ghostsC.end() and *it == c);
+      return nc + std::distance(ghostsC.begin(), it);
+    };
+    std::iota(_B_col_to_C.begin(), std::next(_B_col_to_C.begin(), nc), 0);
+    for (std::int32_t g = 0; g < colB.num_ghosts(); ++g)
+    {
+      auto it = std::lower_bound(ghostsC.begin(), ghostsC.end(),
+                                 colB.ghosts()[g]);
+      if (it != ghostsC.end() and *it == colB.ghosts()[g])
+        _B_col_to_C[nc + g] = nc + std::distance(ghostsC.begin(), it);
+    }
+    _fetched_ptr.resize(sizes_in.size() + 1, 0);
+    std::partial_sum(sizes_in.begin(), sizes_in.end(),
+                     std::next(_fetched_ptr.begin()));
+    _fetched_cols.resize(cols_in.size());
+    std::transform(cols_in.begin(), cols_in.end(), _fetched_cols.begin(),
+                   local_col);
+
+    // Symbolic product
+    const std::int32_t num_cols = nc + ghostsC.size();
+    std::vector<std::int32_t> marker(num_cols, -1);
+    std::vector<std::int32_t> row_ptr = {0};
+    std::vector<std::int32_t> cols;
+    const T* B_values = B.values().data();
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      for (std::int32_t j = A_row_ptr[i]; j < A_row_ptr[i + 1]; ++j)
+      {
+        for_each_in_row(B, A_cols[j], B_values,
+                        [&](std::int32_t c, const T*)
+                        {
+                          if (marker[c] != i)
+                          {
+                            marker[c] = i;
+                            cols.push_back(c);
+                          }
+                        });
+      }
+      std::sort(std::next(cols.begin(), row_ptr.back()), cols.end());
+      row_ptr.push_back(cols.size());
+    }
+
+    // Ghost rows are empty
+    const common::IndexMap& row_map = *_maps_A[0];
+    row_ptr.resize(row_map.size_local() + row_map.num_ghosts() + 1,
+                   row_ptr.back());
+    _C = std::make_unique<MatrixCSR<T>>(
+        std::array<std::shared_ptr<const common::IndexMap>, 2>{_maps_A[0],
+                                                               col_map},
+        std::array<int, 2>{bsA[0], bsB[1]}, std::move(cols),
+        std::move(row_ptr));
+  }
+
+  /// @brief Compute the values of the product (numeric phase).
+  ///
+  /// The values of the rows of `B` that are needed for the ghost
+  /// columns of `A` are fetched from the owning ranks.
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] A The left matrix. It must have the same index maps and
+  /// sparsity as the matrix used to create the product.
+  /// @param[in] B The right matrix. It must have the same index maps
+  /// and sparsity as the matrix used to create the product.
+  void compute(const MatrixCSR<T>& A, const MatrixCSR<T>& B)
+  {
+    if (A.index_maps() != _maps_A or B.index_maps() != _maps_B
+        or A.cols().size() != _nnz[0] or B.cols().size() != _nnz[1])
+    {
+      throw std::runtime_error("Matrix differs from the symbolic product.");
+    }
+
+    // Fetch values of the rows of B for the ghost columns of A
+    const std::array<int, 2> bsB = B.block_size();
+    const int nbsB = bsB[0] * bsB[1];
+    const std::vector<std::int32_t>& B_row_ptr = B.row_ptr();
+    const std::vector<T>& B_values = B.values();
+    {
+      auto it = _send_values.begin();
+      for (std::int32_t r : _send_rows)
+      {
+        it = std::copy(std::next(B_values.begin(), B_row_ptr[r] * nbsB),
+                       std::next(B_values.begin(), B_row_ptr[r + 1] * nbsB),
+                       it);
+      }
+    }
+    MPI_Neighbor_alltoallv(_send_values.data(), _send_sizes.data(),
+                           _send_disp.data(), dolfinx::MPI::mpi_type<T>(),
+                           _recv_values.data(), _recv_sizes.data(),
+                           _recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
+                           _comm.comm());
+
+    // Numeric product
+    const int bs0 = A.block_size()[0];
+    const int bsk = bsB[0];
+    const int bs1 = bsB[1];
+    const std::vector<std::int32_t>& A_row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& A_cols = A.cols();
+    const std::vector<T>& A_values = A.values();
+    const std::vector<std::int32_t>& C_row_ptr = _C->row_ptr();
+    const std::vector<std::int32_t>& C_cols = _C->cols();
+    std::vector<T>& C_values = _C->values();
+    std::fill(C_values.begin(), C_values.end(), 0);
+    std::vector<std::int32_t> pos(_C->index_maps()[1]->size_local()
+                                  + _C->index_maps()[1]->num_ghosts());
+    for (std::int32_t i = 0; i < _C->num_owned_rows(); ++i)
+    {
+      for (std::int32_t j = C_row_ptr[i]; j < C_row_ptr[i + 1]; ++j)
+        pos[C_cols[j]] = j;
+      for (std::int32_t j = A_row_ptr[i]; j < A_row_ptr[i + 1]; ++j)
+      {
+        const T* Aij = A_values.data() + j * bs0 * bsk;
+        for_each_in_row(
+            B, A_cols[j], B_values.data(),
+            [&](std::int32_t c, const T* Bjk)
+            {
+              T* Cik = C_values.data() + pos[c] * bs0 * bs1;
+              for (int k0 = 0; k0 < bs0; ++k0)
+                for (int m = 0; m < bsk; ++m)
+                  for (int k1 = 0; k1 < bs1; ++k1)
+                    Cik[k0 * bs1 + k1] += Aij[k0 * bsk + m] * Bjk[m * bs1 + k1];
+            });
+      }
+    }
+  }
+
+  /// The product matrix
+  MatrixCSR<T>& matrix() { return *_C; }
+
+  /// The product matrix (const version)
+  const MatrixCSR<T>& matrix() const { return *_C; }
+
+private:
+  // Call f(local column of C, value block) for each entry on row k of
+  // B, where k is a local column of A (owned or ghost)
+  template <typename F>
+  void for_each_in_row(const MatrixCSR<T>& B, std::int32_t k,
+                       const T* B_values, F&& f) const
+  {
+    const std::array<int, 2> bs = B.block_size();
+    const int nbs = bs[0] * bs[1];
+    const std::int32_t nb = _maps_B[0]->size_local();
+    if (k < nb)
+    {
+      const std::vector<std::int32_t>& row_ptr = B.row_ptr();
+      const std::vector<std::int32_t>& cols = B.cols();
+      for (std::int32_t j = row_ptr[k]; j < row_ptr[k + 1]; ++j)
+        f(_B_col_to_C[cols[j]], B_values + j * nbs);
+    }
+    else
+    {
+      const std::int32_t p = _ghost_to_fetched[k - nb];
+      for (std::int32_t j = _fetched_ptr[p]; j < _fetched_ptr[p + 1]; ++j)
+        f(_fetched_cols[j], _recv_values.data() + j * nbs);
+    }
+  }
+
+  // Index maps and number of entries of A and B at construction
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _maps_A, _maps_B;
+  std::array<std::size_t, 2> _nnz;
+
+  // Neighbourhood communicator (owner -> ranks that ghost columns of A)
+  dolfinx::MPI::Comm _comm;
+
+  // Owned rows of B sent to other ranks, packed by destination, and
+  // the value counts and displacements
+  std::vector<std::int32_t> _send_rows;
+  std::vector<int> _send_sizes, _send_disp, _recv_sizes, _recv_disp;
+  std::vector<T> _send_values, _recv_values;
+
+  // Fetched rows of B in the order received: offset of each row, and
+  // local column indices of C
+  std::vector<std::int32_t> _fetched_ptr, _fetched_cols;
+
+  // Fetched row for each ghost column of A
+  std::vector<std::int32_t> _ghost_to_fetched;
+
+  // Local column of C for each local column of B (-1 if not used)
+  std::vector<std::int32_t> _B_col_to_C;
+
+  // The product
+  std::unique_ptr<MatrixCSR<T>> _C;
+};
+
+/// @brief Distributed sparse matrix transpose, with separate symbolic
+/// and numeric phases.
+///
+/// Entries in ghost columns of `A` are sent to the owner of the
+/// column. The row index map of the transpose is the column index map
+/// of `A`. The column index map is created, with the owned range of
+/// the row index map of `A` and ghosts for the rows of `A` on other
+/// ranks that have entries in owned columns.
+///
+/// The symbolic phase (constructor) creates the transpose with zero
+/// values. The numeric phase (MatrixTranspose::compute) sends only
+/// values, and can be called repeatedly for matrices with the same
+/// sparsity and layout as at construction.
+///
+/// @note Ghost rows of `A` are ignored. The matrix should be finalized.
+template <typename T>
+class MatrixTranspose
+{
+public:
+  /// @brief Create the transpose structure (symbolic phase).
+  /// @note Collective MPI operation
+  /// @param[in] A The matrix
+  explicit MatrixTranspose(const MatrixCSR<T>& A)
+      : _maps(A.index_maps()), _nnz(A.cols().size()),
+        _comm(impl::create_neighbor_comm(*_maps[1], false))
+  {
+    const common::IndexMap& row_map = *_maps[0];
+    const common::IndexMap& col_map = *_maps[1];
+    const std::array<int, 2> bs = A.block_size();
+    const int nbs = bs[0] * bs[1];
+    const std::int32_t num_rows = row_map.size_local();
+    const std::int64_t r0 = row_map.local_range()[0];
+    const std::int32_t nc = col_map.size_local();
+    const std::vector<std::int64_t>& col_ghosts = col_map.ghosts();
+    const std::vector<int>& col_owners = col_map.owners();
+    const std::vector<int>& src = col_map.src();
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& cols = A.cols();
+    const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+
+    // Pack entries in ghost columns by owner as (row, col) of the
+    // transpose
+    std::vector<int> nbr(col_ghosts.size());
+    for (std::size_t i = 0; i < col_ghosts.size(); ++i)
+    {
+      auto it = std::lower_bound(src.begin(), src.end(), col_owners[i]);
+      assert(it != src.end() and *it == col_owners[i]);
+      nbr[i] = std::distance(src.begin(), it);
+    }
+    std::vector<int> disp(src.size() + 1, 0);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+      for (std::int32_t j = off_diag[i]; j < row_ptr[i + 1]; ++j)
+        ++disp[nbr[cols[j] - nc] + 1];
+    std::partial_sum(disp.begin(), disp.end(), disp.begin());
+    std::vector<std::int64_t> send_idx(2 * disp.back());
+    _send_entries.resize(disp.back());
+    {
+      std::vector<int> pos(disp.begin(), std::prev(disp.end()));
+      for (std::int32_t i = 0; i < num_rows; ++i)
+      {
+        for (std::int32_t j = off_diag[i]; j < row_ptr[i + 1]; ++j)
+        {
+          const int p = pos[nbr[cols[j] - nc]]++;
+          send_idx[2 * p] = col_ghosts[cols[j] - nc];
+          send_idx[2 * p + 1] = r0 + i;
+          _send_entries[p] = j;
+        }
+      }
+    }
+
+    std::vector<int> idx_disp(disp.size());
+    std::transform(disp.begin(), disp.end(), idx_disp.begin(),
+                   [](auto d) { return 2 * d; });
+    auto [recv_idx, recv_disp] = impl::neighbor_alltoallv(
+        _comm.comm(), std::span<const std::int64_t>(send_idx),
+        std::span<const int>(idx_disp));
+
+    // Value counts and displacements for the numeric phase
+    _send_disp.resize(disp.size());
+    std::transform(disp.begin(), disp.end(), _send_disp.begin(),
+                   [nbs](auto d) { return nbs * d; });
+    _recv_disp.resize(recv_disp.size());
+    std::transform(recv_disp.begin(), recv_disp.end(), _recv_disp.begin(),
+                   [nbs](auto d) { return nbs * (d / 2); });
+    _send_sizes.resize(_send_disp.size() - 1);
+    std::adjacent_difference(std::next(_send_disp.begin()), _send_disp.end(),
+                             _send_sizes.begin());
+    if (!_send_sizes.empty())
+      _send_sizes.front() = _send_disp[1];
+    _recv_sizes.resize(_recv_disp.size() - 1);
+    std::adjacent_difference(std::next(_recv_disp.begin()), _recv_disp.end(),
+                             _recv_sizes.begin());
+    if (!_recv_sizes.empty())
+      _recv_sizes.front() = _recv_disp[1];
+    _send_sizes.reserve(1);
+    _recv_sizes.reserve(1);
+    _send_values.resize(_send_disp.back());
+    _recv_values.resize(_recv_disp.back());
+
+    // Count entries on each (owned) row of the transpose
+    const std::int64_t c0 = col_map.local_range()[0];
+    const std::vector<int>& dest = col_map.dest();
+    std::vector<std::int32_t> AT_row_ptr(nc + 1, 0);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+      for (std::int32_t j = row_ptr[i]; j < off_diag[i]; ++j)
+        ++AT_row_ptr[cols[j] + 1];
+    for (std::size_t p = 0; p < recv_idx.size(); p += 2)
+      ++AT_row_ptr[recv_idx[p] - c0 + 1];
+    std::partial_sum(AT_row_ptr.begin(), AT_row_ptr.end(),
+                     AT_row_ptr.begin());
+
+    // Insert entries (global column indices), keeping the insertion
+    // position of the local and received entries
+    std::vector<std::int64_t> AT_cols(AT_row_ptr.back());
+    std::vector<std::pair<std::int64_t, int>> ghost_owners;
+    std::vector<std::int32_t> pos(AT_row_ptr.begin(),
+                                  std::prev(AT_row_ptr.end()));
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      for (std::int32_t j = row_ptr[i]; j < off_diag[i]; ++j)
+      {
+        const std::int32_t p = pos[cols[j]]++;
+        AT_cols[p] = r0 + i;
+        _local_pos.push_back(p);
+      }
+    }
+    for (std::size_t q = 0; q < recv_disp.size() - 1; ++q)
+    {
+      for (int e = recv_disp[q] / 2; e < recv_disp[q + 1] / 2; ++e)
+      {
+        const std::int32_t p = pos[recv_idx[2 * e] - c0]++;
+        AT_cols[p] = recv_idx[2 * e + 1];
+        _recv_pos.push_back(p);
+        ghost_owners.push_back({recv_idx[2 * e + 1], dest[q]});
+      }
+    }
+
+    std::vector<std::int32_t> perm;
+    _AT = std::make_unique<MatrixCSR<T>>(impl::create_matrix<T>(
+        _maps[1], {bs[1], bs[0]}, r0, num_rows, AT_row_ptr, AT_cols,
+        ghost_owners, perm));
+    for (auto& p : _local_pos)
+      p = perm[p];
+    for (auto& p : _recv_pos)
+      p = perm[p];
+  }
+
+  /// @brief Compute the values of the transpose (numeric phase).
+  /// @note Collective MPI operation
+  /// @param[in] A The matrix. It must have the same index maps and
+  /// sparsity as the matrix used to create the transpose.
+  void compute(const MatrixCSR<T>& A)
+  {
+    if (A.index_maps() != _maps or A.cols().size() != _nnz)
+      throw std::runtime_error("Matrix differs from the symbolic transpose.");
+
+    const std::array<int, 2> bs = A.block_size();
+    const int nbs = bs[0] * bs[1];
+    const std::vector<T>& values = A.values();
+
+    // Transpose of block j of A
+    auto transpose_block = [&values, bs, nbs](std::int32_t j, T* out)
+    {
+      for (int k0 = 0; k0 < bs[0]; ++k0)
+        for (int k1 = 0; k1 < bs[1]; ++k1)
+          out[k1 * bs[0] + k0] = values[j * nbs + k0 * bs[1] + k1];
+    };
+
+    for (std::size_t p = 0; p < _send_entries.size(); ++p)
+      transpose_block(_send_entries[p], _send_values.data() + p * nbs);
+    MPI_Neighbor_alltoallv(_send_values.data(), _send_sizes.data(),
+                           _send_disp.data(), dolfinx::MPI::mpi_type<T>(),
+                           _recv_values.data(), _recv_sizes.data(),
+                           _recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
+                           _comm.comm());
+
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+    std::vector<T>& data = _AT->values();
+    std::size_t k = 0;
+    for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+      for (std::int32_t j = row_ptr[i]; j < off_diag[i]; ++j)
+        transpose_block(j, data.data() + _local_pos[k++] * nbs);
+    for (std::size_t e = 0; e < _recv_pos.size(); ++e)
+    {
+      std::copy_n(std::next(_recv_values.begin(), e * nbs), nbs,
+                  std::next(data.begin(), _recv_pos[e] * nbs));
+    }
+  }
+
+  /// The transpose
+  MatrixCSR<T>& matrix() { return *_AT; }
+
+  /// The transpose (const version)
+  const MatrixCSR<T>& matrix() const { return *_AT; }
+
+private:
+  // Index maps and number of entries of A at construction
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _maps;
+  std::size_t _nnz;
+
+  // Neighbourhood communicator (ranks that ghost columns -> owner)
+  dolfinx::MPI::Comm _comm;
+
+  // Entries of A in ghost columns, packed by destination, and the value
+  // counts and displacements
+  std::vector<std::int32_t> _send_entries;
+  std::vector<int> _send_sizes, _send_disp, _recv_sizes, _recv_disp;
+  std::vector<T> _send_values, _recv_values;
+
+  // Position in the transpose of each owned-column entry of A (in row
+  // order), and of each received entry
+  std::vector<std::int32_t> _local_pos, _recv_pos;
+
+  // The transpose
+  std::unique_ptr<MatrixCSR<T>> _AT;
+};
+
+/// @brief Compute the distributed sparse matrix-matrix product C = A B.
+///
+/// See MatrixProduct. Use MatrixProduct directly to re-use the symbolic
+/// phase for repeated products.
+///
+/// @note Collective MPI operation
+/// @param[in] A The left matrix
+/// @param[in] B The right matrix. The owned range of its row index map
+/// must be the same as the owned range of the column index map of `A`.
+/// @return The product, with block size `(bs(A)[0], bs(B)[1])`
+template <typename T>
+MatrixCSR<T> multiply(const MatrixCSR<T>& A, const MatrixCSR<T>& B)
+{
+  MatrixProduct<T> C(A, B);
+  C.compute(A, B);
+  return std::move(C.matrix());
+}
+
+/// @brief Compute the transpose of a distributed sparse matrix.
+///
+/// See MatrixTranspose. Use MatrixTranspose directly to re-use the
+/// symbolic phase for repeated transposes.
+///
+/// @note Collective MPI operation
+/// @param[in] A The matrix
+/// @return The transpose, with block size `(bs(A)[1], bs(A)[0])`
+template <typename T>
+MatrixCSR<T> transpose(const MatrixCSR<T>& A)
+{
+  MatrixTranspose<T> AT(A);
+  AT.compute(A);
+  return std::move(AT.matrix());
+}
+
+} // namespace dolfinx::la
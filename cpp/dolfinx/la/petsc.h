@@ -7,16 +7,22 @@
 
 #pragma once
 
+#include "MatrixCSR.h"
 #include "Vector.h"
 #include "utils.h"
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
+#include <dolfinx/common/IndexMap.h>
 #include <functional>
+#include <numeric>
 #include <petscksp.h>
 #include <petscmat.h>
 #include <petscoptions.h>
 #include <petscvec.h>
 #include <span>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::common
@@ -444,6 +450,182 @@ public:
   void set_from_options();
 };
 
+/// @brief A PETSc MATMPIAIJ matrix that shares the layout of a
+/// la::MatrixCSR.
+///
+/// The owned rows of the MatrixCSR are split at
+/// MatrixCSR::off_diag_offset into the diagonal and off-diagonal
+/// blocks used by PETSc, and the Mat is created with
+/// MatCreateMPIAIJWithSplitArrays on arrays held by this object. The
+/// index arrays are built once. After the MatrixCSR has been
+/// re-assembled, MatrixCSRWrapper::update copies the values in a single
+/// pass, with no calls to MatSetValues and no PETSc assembly.
+///
+/// @note The Mat uses memory owned by this object, and must not be used
+/// after this object has been destroyed.
+/// @tparam Allocator The allocator of the la::MatrixCSR
+template <class Allocator = std::allocator<PetscScalar>>
+class MatrixCSRWrapper
+{
+public:
+  /// @brief Create a PETSc Mat with the layout and values of a
+  /// la::MatrixCSR.
+  /// @note Collective
+  /// @param[in] A The matrix. It must have block size 1 and be
+  /// finalized (see MatrixCSR::finalize).
+  explicit MatrixCSRWrapper(const MatrixCSR<PetscScalar, Allocator>& A)
+  {
+    if (A.block_size()[0] != 1 or A.block_size()[1] != 1)
+    {
+      throw std::runtime_error(
+          "Wrapping a blocked MatrixCSR as a PETSc Mat is not supported.");
+    }
+
+    const common::IndexMap& map0 = *A.index_maps()[0];
+    const common::IndexMap& map1 = *A.index_maps()[1];
+    const std::int32_t num_rows = map0.size_local();
+    const std::int32_t num_cols = map1.size_local();
+    const std::vector<std::int64_t>& ghosts1 = map1.ghosts();
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& cols = A.cols();
+    const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+
+    // Diagonal block, with local (owned) column indices, which are
+    // sorted in each row of the MatrixCSR
+    _i.resize(num_rows + 1, 0);
+    _oi.resize(num_rows + 1, 0);
+    for (std::int32_t r = 0; r < num_rows; ++r)
+    {
+      _i[r + 1] = _i[r] + (off_diag[r] - row_ptr[r]);
+      _oi[r + 1] = _oi[r] + (row_ptr[r + 1] - off_diag[r]);
+    }
+    _j.reserve(_i.back());
+    for (std::int32_t r = 0; r < num_rows; ++r)
+      _j.insert(_j.end(), std::next(cols.begin(), row_ptr[r]),
+                std::next(cols.begin(), off_diag[r]));
+
+    // Off-diagonal block, with global column indices sorted in each
+    // row. _off_diag_pos records the position of each value in the
+    // MatrixCSR.
+    _oj.resize(_oi.back());
+    _off_diag_pos.resize(_oi.back());
+    for (std::int32_t r = 0; r < num_rows; ++r)
+    {
+      auto pos = std::next(_off_diag_pos.begin(), _oi[r]);
+      auto pos1 = std::next(_off_diag_pos.begin(), _oi[r + 1]);
+      std::iota(pos, pos1, off_diag[r]);
+      auto global = [&](std::int32_t k)
+      { return ghosts1[cols[k] - num_cols]; };
+      std::sort(pos, pos1,
+                [&](auto k0, auto k1) { return global(k0) < global(k1); });
+      std::transform(pos, pos1, std::next(_oj.begin(), _oi[r]), global);
+    }
+
+    _a.resize(_i.back());
+    _oa.resize(_oi.back());
+    copy_values(A, _a.data(), _oa.data());
+
+    PetscErrorCode ierr = MatCreateMPIAIJWithSplitArrays(
+        map0.comm(), num_rows, num_cols, map0.size_global(),
+        map1.size_global(), _i.data(), _j.data(), _a.data(), _oi.data(),
+        _oj.data(), _oa.data(), &_mat);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "MatCreateMPIAIJWithSplitArrays");
+  }
+
+  // Copy constructor (deleted)
+  MatrixCSRWrapper(const MatrixCSRWrapper& A) = delete;
+
+  /// Move constructor
+  MatrixCSRWrapper(MatrixCSRWrapper&& A)
+      : _i(std::move(A._i)), _j(std::move(A._j)), _oi(std::move(A._oi)),
+        _oj(std::move(A._oj)), _off_diag_pos(std::move(A._off_diag_pos)),
+        _a(std::move(A._a)), _oa(std::move(A._oa)),
+        _mat(std::exchange(A._mat, nullptr))
+  {
+  }
+
+  /// Destructor
+  ~MatrixCSRWrapper()
+  {
+    if (_mat)
+      MatDestroy(&_mat);
+  }
+
+  // Assignment operator (deleted)
+  MatrixCSRWrapper& operator=(const MatrixCSRWrapper& A) = delete;
+
+  // Move assignment operator (deleted)
+  MatrixCSRWrapper& operator=(MatrixCSRWrapper&& A) = delete;
+
+  /// @brief Copy the owned values of a MatrixCSR into the PETSc Mat.
+  /// @param[in] A The matrix. It must be the matrix used to create this
+  /// object, or have the same sparsity pattern, and be finalized.
+  void update(const MatrixCSR<PetscScalar, Allocator>& A)
+  {
+    Mat Ad, Ao;
+    const PetscInt* garray;
+    PetscErrorCode ierr = MatMPIAIJGetSeqAIJ(_mat, &Ad, &Ao, &garray);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "MatMPIAIJGetSeqAIJ");
+
+    // Get and restore the arrays (which are the arrays held by this
+    // object) so that PETSc registers the change of values
+    PetscScalar *a, *oa;
+    ierr = MatSeqAIJGetArray(Ad, &a);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "MatSeqAIJGetArray");
+    ierr = MatSeqAIJGetArray(Ao, &oa);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "MatSeqAIJGetArray");
+    copy_values(A, a, oa);
+    ierr = MatSeqAIJRestoreArray(Ao, &oa);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "MatSeqAIJRestoreArray");
+    ierr = MatSeqAIJRestoreArray(Ad, &a);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "MatSeqAIJRestoreArray");
+  }
+
+  /// Return PETSc Mat pointer
+  Mat mat() const { return _mat; }
+
+private:
+  // Copy the values of the owned rows of A into the diagonal (a) and
+  // off-diagonal (oa) block arrays
+  void copy_values(const MatrixCSR<PetscScalar, Allocator>& A,
+                   PetscScalar* a, PetscScalar* oa) const
+  {
+    const auto& values = A.values();
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+    for (std::size_t r = 0; r + 1 < _i.size(); ++r)
+    {
+      std::copy(std::next(values.begin(), row_ptr[r]),
+                std::next(values.begin(), off_diag[r]),
+                std::next(a, _i[r]));
+    }
+
+    for (std::size_t k = 0; k < _off_diag_pos.size(); ++k)
+      oa[k] = values[_off_diag_pos[k]];
+  }
+
+  // Diagonal block (CSR, local column indices)
+  std::vector<PetscInt> _i, _j;
+
+  // Off-diagonal block (CSR, global column indices)
+  std::vector<PetscInt> _oi, _oj;
+
+  // Position in the MatrixCSR values of each off-diagonal value
+  std::vector<std::int32_t> _off_diag_pos;
+
+  // Values of the diagonal and off-diagonal blocks
+  std::vector<PetscScalar> _a, _oa;
+
+  // PETSc Mat, which uses the above arrays
+  Mat _mat = nullptr;
+};
+
 /// This class implements Krylov methods for linear systems of the form
 /// Ax = b. It is a wrapper for the Krylov solvers of PETSc.
 class KrylovSolver
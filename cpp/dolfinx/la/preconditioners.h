@@ -0,0 +1,828 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/utils.h>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief Preconditioners for la::MatrixCSR.
+///
+/// The preconditioners are function objects with the signature
+/// `void(Vector<T>& x, Vector<T>& y)`, computing `y = M^{-1} x` for the
+/// owned entries, so they can be used with the la::solvers methods.
+/// Each also provides a `smooth(b, u, steps)` function that improves
+/// an approximate solution of `A u = b`, which is used for multigrid
+/// smoothing (see la::amg::SmoothedAggregation).
+///
+/// The preconditioners act on the owned rows of square matrices with
+/// the same owned rows and columns. Entries in ghost columns are only
+/// used through matrix-vector products. The matrix must outlive the
+/// preconditioner.
+namespace dolfinx::la::preconditioners
+{
+
+namespace impl
+{
+/// @brief Compute the pointwise inverse diagonal of the owned rows of
+/// a square matrix, and the Gershgorin bound on the spectral radius of
+/// `D^{-1} A`.
+/// @note Collective MPI operation
+template <typename T>
+std::pair<std::vector<T>, double> inverse_diagonal(const MatrixCSR<T>& A)
+{
+  const std::int32_t num_rows = A.num_owned_rows();
+  const int bs = A.block_size()[0];
+  const int nbs = bs * bs;
+  const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+  const std::vector<std::int32_t>& cols = A.cols();
+  const std::vector<T>& values = A.values();
+
+  std::vector<T> dinv(num_rows * bs, 0);
+  double rho_local = 0;
+  std::vector<double> row_sum(bs);
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    std::fill(row_sum.begin(), row_sum.end(), 0);
+    for (std::int32_t j = row_ptr[i]; j < row_ptr[i + 1]; ++j)
+    {
+      for (int k0 = 0; k0 < bs; ++k0)
+      {
+        for (int k1 = 0; k1 < bs; ++k1)
+          row_sum[k0] += std::abs(values[j * nbs + k0 * bs + k1]);
+      }
+
+      if (cols[j] == i)
+      {
+        for (int k = 0; k < bs; ++k)
+        {
+          if (T d = values[j * nbs + k * bs + k]; d != T(0))
+            dinv[i * bs + k] = T(1) / d;
+        }
+      }
+    }
+
+    for (int k = 0; k < bs; ++k)
+    {
+      rho_local
+          = std::max(rho_local, row_sum[k] * std::abs(dinv[i * bs + k]));
+    }
+  }
+
+  double rho;
+  MPI_Allreduce(&rho_local, &rho, 1, MPI_DOUBLE, MPI_MAX,
+                A.index_maps()[0]->comm());
+  return {std::move(dinv), rho};
+}
+
+/// @brief Invert a dense `n x n` matrix (row-major) in-place, using
+/// Gauss-Jordan elimination with partial pivoting.
+///
+/// Components whose row and column are zero, which arise for
+/// degrees-of-freedom that are not coupled (e.g. on coarse multigrid
+/// levels), have a zero inverse, as for the pointwise inverse
+/// diagonal.
+template <typename T>
+void invert(std::span<T> A, int n)
+{
+  std::vector<std::int8_t> uncoupled(n, true);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      if (A[i * n + j] != T(0))
+        uncoupled[i] = uncoupled[j] = false;
+    }
+  }
+  for (int i = 0; i < n; ++i)
+  {
+    if (uncoupled[i])
+      A[i * n + i] = 1;
+  }
+
+  std::vector<int> perm(n);
+  for (int k = 0; k < n; ++k)
+  {
+    // Find pivot and swap rows
+    int p = k;
+    for (int i = k + 1; i < n; ++i)
+    {
+      if (std::abs(A[i * n + k]) > std::abs(A[p * n + k]))
+        p = i;
+    }
+    if (A[p * n + k] == T(0))
+      throw std::runtime_error("Singular diagonal block.");
+    perm[k] = p;
+    if (p != k)
+    {
+      std::swap_ranges(std::next(A.begin(), k * n),
+                       std::next(A.begin(), (k + 1) * n),
+                       std::next(A.begin(), p * n));
+    }
+
+    const T d = T(1) / A[k * n + k];
+    A[k * n + k] = 1;
+    for (int j = 0; j < n; ++j)
+      A[k * n + j] *= d;
+    for (int i = 0; i < n; ++i)
+    {
+      if (i != k)
+      {
+        const T f = A[i * n + k];
+        A[i * n + k] = 0;
+        for (int j = 0; j < n; ++j)
+          A[i * n + j] -= f * A[k * n + j];
+      }
+    }
+  }
+
+  // Undo the row swaps by swapping columns in reverse order
+  for (int k = n - 1; k >= 0; --k)
+  {
+    if (perm[k] != k)
+    {
+      for (int i = 0; i < n; ++i)
+        std::swap(A[i * n + k], A[i * n + perm[k]]);
+    }
+  }
+
+  for (int i = 0; i < n; ++i)
+  {
+    if (uncoupled[i])
+      A[i * n + i] = 0;
+  }
+}
+
+/// @brief Compute the inverses of the diagonal blocks of the owned rows
+/// of a square matrix.
+/// @return The inverse blocks (row-major), stored contiguously for each
+/// row
+template <typename T>
+std::vector<T> inverse_block_diagonal(const MatrixCSR<T>& A)
+{
+  const std::array<int, 2> bs = A.block_size();
+  if (bs[0] != bs[1])
+    throw std::runtime_error("Matrix must have square blocks.");
+
+  const std::int32_t num_rows = A.num_owned_rows();
+  const int nbs = bs[0] * bs[1];
+  const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+  const std::vector<std::int32_t>& cols = A.cols();
+  const std::vector<T>& values = A.values();
+
+  std::vector<T> dinv(num_rows * nbs, 0);
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    for (std::int32_t j = row_ptr[i]; j < row_ptr[i + 1]; ++j)
+    {
+      if (cols[j] == i)
+      {
+        std::copy_n(std::next(values.begin(), j * nbs), nbs,
+                    std::next(dinv.begin(), i * nbs));
+      }
+    }
+    invert(std::span<T>(dinv.data() + i * nbs, nbs), bs[0]);
+  }
+
+  return dinv;
+}
+
+/// Compute `y <- y + a B x` for a dense `n x n` block `B` (row-major)
+template <typename T>
+void gemv(int n, T a, const T* B, const T* x, T* y)
+{
+  for (int k0 = 0; k0 < n; ++k0)
+  {
+    T v = 0;
+    for (int k1 = 0; k1 < n; ++k1)
+      v += B[k0 * n + k1] * x[k1];
+    y[k0] += a * v;
+  }
+}
+} // namespace impl
+
+/// @brief Weighted point-Jacobi preconditioner, `M^{-1} = w D^{-1}`.
+///
+/// Zero diagonal entries are skipped, i.e. the corresponding entries of
+/// `D^{-1}` are zero.
+template <typename T>
+class Jacobi
+{
+public:
+  /// @brief Create a Jacobi preconditioner.
+  /// @note Collective MPI operation
+  /// @param[in] A The matrix
+  /// @param[in] weight The damping weight `w`
+  /// @param[in] num_threads Number of threads used for applying the
+  /// preconditioner and for matrix-vector products
+  Jacobi(const MatrixCSR<T>& A, T weight = 1, int num_threads = 1)
+      : _A(&A), _weight(weight), _num_threads(num_threads),
+        _dinv(impl::inverse_diagonal(A).first),
+        _r(A.index_maps()[1], A.block_size()[1])
+  {
+  }
+
+  /// @brief Apply the preconditioner, `y = M^{-1} x`.
+  /// @param[in] x The input vector (owned entries are used)
+  /// @param[out] y The output vector (owned entries are set)
+  void operator()(Vector<T>& x, Vector<T>& y) const
+  {
+    std::span<const T> _x = x.array();
+    std::span<T> _y = y.mutable_array();
+    common::apply_blocks(_dinv.size(), _num_threads,
+                         [&](std::int32_t i0, std::int32_t i1)
+                         {
+                           for (std::int32_t i = i0; i < i1; ++i)
+                             _y[i] = _weight * _dinv[i] * _x[i];
+                         });
+  }
+
+  /// @brief Apply Jacobi sweeps, `u <- u + w D^{-1} (b - A u)`.
+  /// @param[in] b The right-hand side (owned entries are used)
+  /// @param[in,out] u The approximate solution. It must use the column
+  /// index map of `A`.
+  /// @param[in] steps The number of sweeps
+  void smooth(const Vector<T>& b, Vector<T>& u, int steps)
+  {
+    std::span<const T> _b = b.array();
+    std::span<T> _u = u.mutable_array();
+    std::span<const T> r = _r.array();
+    for (int s = 0; s < steps; ++s)
+    {
+      _A->mult(u, _r, _num_threads);
+      common::apply_blocks(_dinv.size(), _num_threads,
+                           [&](std::int32_t i0, std::int32_t i1)
+                           {
+                             for (std::int32_t i = i0; i < i1; ++i)
+                               _u[i] += _weight * _dinv[i] * (_b[i] - r[i]);
+                           });
+    }
+  }
+
+private:
+  // The matrix
+  const MatrixCSR<T>* _A;
+
+  // Damping weight
+  T _weight;
+
+  // Number of threads
+  int _num_threads;
+
+  // Inverse diagonal (owned rows)
+  std::vector<T> _dinv;
+
+  // Work vector
+  Vector<T> _r;
+};
+
+/// @brief Weighted block-Jacobi preconditioner, `M^{-1} = w D^{-1}`,
+/// where `D` is the block diagonal of the matrix with dense blocks of
+/// the matrix block size (e.g. the components of a vector-valued
+/// field at a node).
+///
+/// For a matrix with block size one this is the point-Jacobi
+/// preconditioner.
+template <typename T>
+class BlockJacobi
+{
+public:
+  /// @brief Create a block-Jacobi preconditioner.
+  /// @param[in] A The matrix. It must have square blocks.
+  /// @param[in] weight The damping weight `w`
+  /// @param[in] num_threads Number of threads used for applying the
+  /// preconditioner and for matrix-vector products
+  BlockJacobi(const MatrixCSR<T>& A, T weight = 1, int num_threads = 1)
+      : _A(&A), _weight(weight), _num_threads(num_threads),
+        _dinv(impl::inverse_block_diagonal(A)),
+        _r(A.index_maps()[1], A.block_size()[1])
+  {
+  }
+
+  /// @brief Apply the preconditioner, `y = M^{-1} x`.
+  /// @param[in] x The input vector (owned entries are used)
+  /// @param[out] y The output vector (owned entries are set)
+  void operator()(Vector<T>& x, Vector<T>& y) const
+  {
+    const int bs = _A->block_size()[0];
+    std::span<const T> _x = x.array();
+    std::span<T> _y = y.mutable_array();
+    common::apply_blocks(_A->num_owned_rows(), _num_threads,
+                         [&](std::int32_t i0, std::int32_t i1)
+                         {
+                           std::fill(std::next(_y.begin(), i0 * bs),
+                                     std::next(_y.begin(), i1 * bs), 0);
+                           for (std::int32_t i = i0; i < i1; ++i)
+                           {
+                             impl::gemv(bs, _weight, _dinv.data() + i * bs * bs,
+                                        _x.data() + i * bs, _y.data() + i * bs);
+                           }
+                         });
+  }
+
+  /// @brief Apply block-Jacobi sweeps, `u <- u + w D^{-1} (b - A u)`.
+  /// @param[in] b The right-hand side (owned entries are used)
+  /// @param[in,out] u The approximate solution. It must use the column
+  /// index map of `A`.
+  /// @param[in] steps The number of sweeps
+  void smooth(const Vector<T>& b, Vector<T>& u, int steps)
+  {
+    const int bs = _A->block_size()[0];
+    std::span<const T> _b = b.array();
+    std::span<T> _u = u.mutable_array();
+    std::span<T> r = _r.mutable_array();
+    for (int s = 0; s < steps; ++s)
+    {
+      _A->mult(u, _r, _num_threads);
+      common::apply_blocks(_A->num_owned_rows(), _num_threads,
+                           [&](std::int32_t i0, std::int32_t i1)
+                           {
+                             for (std::int32_t i = i0 * bs; i < i1 * bs; ++i)
+                               r[i] = _b[i] - r[i];
+                             for (std::int32_t i = i0; i < i1; ++i)
+                             {
+                               impl::gemv(bs, _weight,
+                                          _dinv.data() + i * bs * bs,
+                                          r.data() + i * bs,
+                                          _u.data() + i * bs);
+                             }
+                           });
+    }
+  }
+
+private:
+  // The matrix
+  const MatrixCSR<T>* _A;
+
+  // Damping weight
+  T _weight;
+
+  // Number of threads
+  int _num_threads;
+
+  // Inverse diagonal blocks (owned rows)
+  std::vector<T> _dinv;
+
+  // Work vector
+  Vector<T> _r;
+};
+
+/// @brief Processor-local incomplete LU factorisation with zero
+/// fill-in, ILU(0).
+///
+/// The factorisation is computed for the block of owned rows and
+/// columns, i.e. the entries of each row before
+/// MatrixCSR::off_diag_offset, so in parallel it is a block-Jacobi
+/// preconditioner with one ILU(0) block per rank. Blocked matrices are
+/// factorised with dense blocks (block ILU(0)).
+///
+/// With more than one thread the triangular solves use level
+/// scheduling: rows are grouped into levels that depend only on rows
+/// in earlier levels, and the rows of a level are solved in parallel.
+/// The factorisation itself is serial.
+template <typename T>
+class ILU0
+{
+public:
+  /// @brief Compute the factorisation.
+  /// @param[in] A The matrix. It must have square blocks, and an entry
+  /// on the diagonal of each owned row.
+  /// @param[in] num_threads Number of threads used for applying the
+  /// preconditioner and for matrix-vector products
+  ILU0(const MatrixCSR<T>& A, int num_threads = 1)
+      : _A(&A), _num_threads(std::max(num_threads, 1)),
+        _r(A.index_maps()[1], A.block_size()[1])
+  {
+    const std::array<int, 2> bs = A.block_size();
+    if (bs[0] != bs[1])
+      throw std::runtime_error("Matrix must have square blocks.");
+    const int nbs = bs[0] * bs[1];
+
+    // Copy the owned block, and find the diagonal entries
+    const std::int32_t num_rows = A.num_owned_rows();
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    const std::vector<std::int32_t>& off_diag = A.off_diag_offset();
+    const std::vector<std::int32_t>& cols = A.cols();
+    const std::vector<T>& values = A.values();
+    _row_ptr.resize(num_rows + 1, 0);
+    _diag.resize(num_rows, -1);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      _row_ptr[i + 1] = _row_ptr[i] + off_diag[i] - row_ptr[i];
+      _cols.insert(_cols.end(), std::next(cols.begin(), row_ptr[i]),
+                   std::next(cols.begin(), off_diag[i]));
+      _lu.insert(_lu.end(), std::next(values.begin(), row_ptr[i] * nbs),
+                 std::next(values.begin(), off_diag[i] * nbs));
+      auto c0 = std::next(_cols.begin(), _row_ptr[i]);
+      auto c1 = std::next(_cols.begin(), _row_ptr[i + 1]);
+      auto it = std::lower_bound(c0, c1, i);
+      if (it == c1 or *it != i)
+        throw std::runtime_error("Matrix has no diagonal entry.");
+      _diag[i] = std::distance(_cols.begin(), it);
+    }
+
+    // Factorise (IKJ variant), storing the inverse diagonal blocks of U
+    _dinv.resize(num_rows * nbs);
+    std::vector<std::int32_t> pos(num_rows, -1);
+    std::vector<T> L_ik(nbs);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      for (std::int32_t j = _row_ptr[i]; j < _row_ptr[i + 1]; ++j)
+        pos[_cols[j]] = j;
+
+      for (std::int32_t kk = _row_ptr[i]; kk < _diag[i]; ++kk)
+      {
+        // L_ik = A_ik U_kk^{-1}
+        const std::int32_t k = _cols[kk];
+        T* A_ik = _lu.data() + kk * nbs;
+        const T* Uinv_kk = _dinv.data() + k * nbs;
+        for (int k0 = 0; k0 < bs[0]; ++k0)
+        {
+          for (int k1 = 0; k1 < bs[0]; ++k1)
+          {
+            T v = 0;
+            for (int m = 0; m < bs[0]; ++m)
+              v += A_ik[k0 * bs[0] + m] * Uinv_kk[m * bs[0] + k1];
+            L_ik[k0 * bs[0] + k1] = v;
+          }
+        }
+        std::copy(L_ik.begin(), L_ik.end(), A_ik);
+
+        // A_ij <- A_ij - L_ik U_kj for j > k in the pattern of row i
+        for (std::int32_t jj = _diag[k] + 1; jj < _row_ptr[k + 1]; ++jj)
+        {
+          if (std::int32_t p = pos[_cols[jj]]; p >= 0)
+          {
+            const T* U_kj = _lu.data() + jj * nbs;
+            T* A_ij = _lu.data() + p * nbs;
+            for (int k0 = 0; k0 < bs[0]; ++k0)
+            {
+              for (int k1 = 0; k1 < bs[0]; ++k1)
+              {
+                T v = 0;
+                for (int m = 0; m < bs[0]; ++m)
+                  v += L_ik[k0 * bs[0] + m] * U_kj[m * bs[0] + k1];
+                A_ij[k0 * bs[0] + k1] -= v;
+              }
+            }
+          }
+        }
+      }
+
+      std::copy_n(std::next(_lu.begin(), _diag[i] * nbs), nbs,
+                  std::next(_dinv.begin(), i * nbs));
+      impl::invert(std::span<T>(_dinv.data() + i * nbs, nbs), bs[0]);
+
+      for (std::int32_t j = _row_ptr[i]; j < _row_ptr[i + 1]; ++j)
+        pos[_cols[j]] = -1;
+    }
+
+    // Level schedules for the lower and upper triangular solves
+    if (_num_threads > 1)
+    {
+      std::vector<std::int32_t> level(num_rows);
+      for (int s = 0; s < 2; ++s)
+      {
+        std::int32_t num_levels = 0;
+        for (std::int32_t n = 0; n < num_rows; ++n)
+        {
+          const std::int32_t i = s == 0 ? n : num_rows - 1 - n;
+          const std::int32_t j0 = s == 0 ? _row_ptr[i] : _diag[i] + 1;
+          const std::int32_t j1 = s == 0 ? _diag[i] : _row_ptr[i + 1];
+          level[i] = 0;
+          for (std::int32_t j = j0; j < j1; ++j)
+            level[i] = std::max(level[i], level[_cols[j]] + 1);
+          num_levels = std::max(num_levels, level[i] + 1);
+        }
+
+        std::vector<std::int32_t>& offsets = _level_offsets[s];
+        offsets.assign(num_levels + 1, 0);
+        for (std::int32_t l : level)
+          ++offsets[l + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::int32_t> p(offsets.begin(), std::prev(offsets.end()));
+        _level_rows[s].resize(num_rows);
+        for (std::int32_t i = 0; i < num_rows; ++i)
+          _level_rows[s][p[level[i]]++] = i;
+      }
+    }
+  }
+
+  /// @brief Apply the preconditioner, `y = (LU)^{-1} x`.
+  /// @param[in] x The input vector (owned entries are used)
+  /// @param[out] y The output vector (owned entries are set)
+  void operator()(Vector<T>& x, Vector<T>& y) const
+  {
+    const int bs = _A->block_size()[0];
+    const std::size_t n = bs * _A->num_owned_rows();
+    std::copy_n(x.array().begin(), n, y.mutable_array().begin());
+    solve(y.mutable_array().first(n));
+  }
+
+  /// @brief Apply ILU(0) sweeps, `u <- u + (LU)^{-1} (b - A u)`.
+  /// @param[in] b The right-hand side (owned entries are used)
+  /// @param[in,out] u The approximate solution. It must use the column
+  /// index map of `A`.
+  /// @param[in] steps The number of sweeps
+  void smooth(const Vector<T>& b, Vector<T>& u, int steps)
+  {
+    const std::size_t n = _A->block_size()[0] * _A->num_owned_rows();
+    std::span<const T> _b = b.array();
+    std::span<T> _u = u.mutable_array();
+    std::span<T> r = _r.mutable_array().first(n);
+    for (int s = 0; s < steps; ++s)
+    {
+      _A->mult(u, _r, _num_threads);
+      for (std::size_t i = 0; i < n; ++i)
+        r[i] = _b[i] - r[i];
+      solve(r);
+      for (std::size_t i = 0; i < n; ++i)
+        _u[i] += r[i];
+    }
+  }
+
+private:
+  // Solve L U y = y in-place
+  void solve(std::span<T> y) const
+  {
+    const int bs = _A->block_size()[0];
+    const int nbs = bs * bs;
+
+    // y_i <- y_i - sum_{k < i} L_ik y_k
+    auto lower = [&](std::int32_t i)
+    {
+      T* y_i = y.data() + i * bs;
+      for (std::int32_t j = _row_ptr[i]; j < _diag[i]; ++j)
+      {
+        impl::gemv(bs, T(-1), _lu.data() + j * nbs, y.data() + _cols[j] * bs,
+                   y_i);
+      }
+    };
+
+    // y_i <- U_ii^{-1} (y_i - sum_{j > i} U_ij y_j)
+    std::vector<T> w(_num_threads * bs);
+    auto upper = [&](std::int32_t i, T* w_i)
+    {
+      T* y_i = y.data() + i * bs;
+      for (std::int32_t j = _diag[i] + 1; j < _row_ptr[i + 1]; ++j)
+      {
+        impl::gemv(bs, T(-1), _lu.data() + j * nbs, y.data() + _cols[j] * bs,
+                   y_i);
+      }
+      std::copy_n(y_i, bs, w_i);
+      std::fill_n(y_i, bs, 0);
+      impl::gemv(bs, T(1), _dinv.data() + i * nbs, w_i, y_i);
+    };
+
+    const std::int32_t num_rows = _diag.size();
+    if (_num_threads == 1)
+    {
+      for (std::int32_t i = 0; i < num_rows; ++i)
+        lower(i);
+      for (std::int32_t i = num_rows - 1; i >= 0; --i)
+        upper(i, w.data());
+    }
+    else
+    {
+      std::barrier sync(_num_threads);
+      auto f = [&](int t)
+      {
+        for (int s = 0; s < 2; ++s)
+        {
+          const std::vector<std::int32_t>& rows = _level_rows[s];
+          const std::vector<std::int32_t>& offsets = _level_offsets[s];
+          for (std::size_t l = 0; l < offsets.size() - 1; ++l)
+          {
+            auto [i0, i1] = dolfinx::MPI::local_range(
+                t, offsets[l + 1] - offsets[l], _num_threads);
+            for (std::int32_t i = offsets[l] + i0; i < offsets[l] + i1; ++i)
+            {
+              if (s == 0)
+                lower(rows[i]);
+              else
+                upper(rows[i], w.data() + t * bs);
+            }
+            sync.arrive_and_wait();
+          }
+        }
+      };
+
+      std::vector<std::jthread> threads;
+      for (int t = 0; t < _num_threads; ++t)
+        threads.emplace_back(f, t);
+    }
+  }
+
+  // The matrix
+  const MatrixCSR<T>* _A;
+
+  // Number of threads
+  int _num_threads;
+
+  // Factors L (unit diagonal, not stored) and U of the owned block, in
+  // CSR format
+  std::vector<std::int32_t> _row_ptr, _cols;
+  std::vector<T> _lu;
+
+  // Position of the diagonal entry in each row
+  std::vector<std::int32_t> _diag;
+
+  // Inverse diagonal blocks of U
+  std::vector<T> _dinv;
+
+  // Rows grouped by level, and the offset of each level, for the lower
+  // (0) and upper (1) triangular solves
+  std::array<std::vector<std::int32_t>, 2> _level_rows, _level_offsets;
+
+  // Work vector
+  Vector<T> _r;
+};
+
+/// @brief Chebyshev polynomial preconditioner (smoother) with
+/// point-Jacobi scaling.
+///
+/// The Chebyshev iteration of a given degree is applied to `D^{-1} A`
+/// on the eigenvalue interval `[l_max / ratio, l_max]`, which damps the
+/// upper part of the spectrum. The largest eigenvalue `l_max` is
+/// estimated by power iteration, with a safety factor, or by the
+/// Gershgorin bound. The preconditioner is symmetric if `A` is
+/// Hermitian, so it can be used with la::solvers::CG.
+template <typename T>
+class Chebyshev
+{
+public:
+  /// @brief Create a Chebyshev preconditioner.
+  /// @note Collective MPI operation
+  /// @param[in] A The matrix
+  /// @param[in] degree The polynomial degree, i.e. the number of
+  /// matrix-vector products per application
+  /// @param[in] ratio Ratio between the upper and lower ends of the
+  /// eigenvalue interval
+  /// @param[in] num_eig_its Number of power iterations used to estimate
+  /// the largest eigenvalue of `D^{-1} A`. If zero, the Gershgorin
+  /// bound is used.
+  /// @param[in] num_threads Number of threads used for applying the
+  /// preconditioner and for matrix-vector products
+  Chebyshev(const MatrixCSR<T>& A, int degree = 2, double ratio = 30.0,
+            int num_eig_its = 10, int num_threads = 1)
+      : _A(&A), _degree(degree), _ratio(ratio), _num_threads(num_threads),
+        _r(A.index_maps()[1], A.block_size()[1]),
+        _d(A.index_maps()[1], A.block_size()[1]),
+        _t(A.index_maps()[1], A.block_size()[1])
+  {
+    auto [dinv, rho] = impl::inverse_diagonal(A);
+    _dinv = std::move(dinv);
+    _eig_max = rho;
+
+    if (num_eig_its > 0)
+    {
+      // Power iteration for D^{-1} A, starting from a vector with
+      // pseudo-random entries
+      const std::size_t n = _dinv.size();
+      const std::int64_t offset
+          = A.block_size()[1] * A.index_maps()[1]->local_range()[0];
+      std::span<T> d = _d.mutable_array();
+      std::span<T> t = _t.mutable_array();
+      for (std::size_t i = 0; i < n; ++i)
+        d[i] = std::sin(double(offset + i + 1));
+
+      double lambda = 0;
+      for (int k = 0; k < num_eig_its; ++k)
+      {
+        const double d_norm = la::norm(_d);
+        if (d_norm == 0)
+          break;
+        _A->mult(_d, _t, _num_threads);
+        for (std::size_t i = 0; i < n; ++i)
+          d[i] = _dinv[i] * t[i] / T(d_norm);
+        lambda = la::norm(_d);
+      }
+      _eig_max = 1.1 * lambda;
+    }
+  }
+
+  /// @brief Apply the preconditioner, `y = p(D^{-1} A) D^{-1} x`, i.e.
+  /// the Chebyshev iteration with a zero initial guess.
+  /// @param[in] x The input vector (owned entries are used)
+  /// @param[out] y The output vector (owned entries are set). It must
+  /// use the column index map of `A`.
+  void operator()(Vector<T>& x, Vector<T>& y) const
+  {
+    y.set(0);
+    iterate(x, y);
+  }
+
+  /// @brief Apply Chebyshev iterations to `A u = b`.
+  /// @param[in] b The right-hand side (owned entries are used)
+  /// @param[in,out] u The approximate solution. It must use the column
+  /// index map of `A`.
+  /// @param[in] steps The number of iterations, each of the polynomial
+  /// degree
+  void smooth(const Vector<T>& b, Vector<T>& u, int steps)
+  {
+    for (int s = 0; s < steps; ++s)
+      iterate(b, u);
+  }
+
+  /// The upper end of the eigenvalue interval
+  double max_eigenvalue() const { return _eig_max; }
+
+private:
+  // Apply one Chebyshev iteration to A u = b
+  void iterate(const Vector<T>& b, Vector<T>& u) const
+  {
+    std::span<const T> _b = b.array();
+    std::span<T> _u = u.mutable_array();
+    std::span<T> r = _r.mutable_array();
+    std::span<T> d = _d.mutable_array();
+    std::span<const T> t = _t.array();
+    const std::int32_t n = _dinv.size();
+
+    // Chebyshev iteration for D^{-1} A on [l_max / ratio, l_max]
+    const double upper = _eig_max;
+    const double lower = upper / _ratio;
+    const double theta = 0.5 * (upper + lower);
+    const double delta = 0.5 * (upper - lower);
+    const double sigma = theta / delta;
+    double rho = 1.0 / sigma;
+
+    _A->mult(u, _t, _num_threads);
+    common::apply_blocks(n, _num_threads,
+                         [&](std::int32_t i0, std::int32_t i1)
+                         {
+                           for (std::int32_t i = i0; i < i1; ++i)
+                           {
+                             r[i] = _dinv[i] * (_b[i] - t[i]);
+                             d[i] = r[i] / T(theta);
+                           }
+                         });
+
+    for (int s = 0; s < _degree; ++s)
+    {
+      common::apply_blocks(n, _num_threads,
+                           [&](std::int32_t i0, std::int32_t i1)
+                           {
+                             for (std::int32_t i = i0; i < i1; ++i)
+                               _u[i] += d[i];
+                           });
+      if (s == _degree - 1)
+        break;
+
+      _A->mult(_d, _t, _num_threads);
+      const double rho_new = 1.0 / (2.0 * sigma - rho);
+      common::apply_blocks(n, _num_threads,
+                           [&](std::int32_t i0, std::int32_t i1)
+                           {
+                             for (std::int32_t i = i0; i < i1; ++i)
+                             {
+                               r[i] -= _dinv[i] * t[i];
+                               d[i] = T(rho_new * rho) * d[i]
+                                      + T(2.0 * rho_new / delta) * r[i];
+                             }
+                           });
+      rho = rho_new;
+    }
+  }
+
+  // The matrix
+  const MatrixCSR<T>* _A;
+
+  // Polynomial degree
+  int _degree;
+
+  // Ratio between the upper and lower ends of the eigenvalue interval
+  double _ratio;
+
+  // Number of threads
+  int _num_threads;
+
+  // Inverse diagonal (owned rows)
+  std::vector<T> _dinv;
+
+  // Estimate of the largest eigenvalue of D^{-1} A
+  double _eig_max;
+
+  // Work vectors: residual, update and temporary. They are modified
+  // by the (const) application of the preconditioner.
+  mutable Vector<T> _r, _d, _t;
+};
+
+} // namespace dolfinx::la::preconditioners
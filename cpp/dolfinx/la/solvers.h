@@ -0,0 +1,671 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/// @brief Iterative (Krylov) solvers for la::Vector.
+///
+/// The solvers operate on any linear operator and preconditioner
+/// provided as function objects with the signature `void(V& x, V& y)`,
+/// computing `y = A x` (or `y = M^{-1} x` for a preconditioner). The
+/// input vector `x` is passed as non-const so that the operator can
+/// update its ghost values, e.g. using la::MatrixCSR::mult.
+///
+/// Work vectors are allocated when a solver is created and reused for
+/// all subsequent solves, so no memory is allocated during iterations.
+/// Only the owned entries of vectors are used by the solvers.
+namespace dolfinx::la::solvers
+{
+
+namespace impl
+{
+/// Owned part of a vector
+template <typename V>
+std::span<typename V::value_type> owned(V& x)
+{
+  return x.mutable_array().first(x.bs() * x.map()->size_local());
+}
+
+/// Owned part of a vector (const version)
+template <typename V>
+std::span<const typename V::value_type> owned(const V& x)
+{
+  return x.array().first(x.bs() * x.map()->size_local());
+}
+
+/// Identity preconditioner, y = x
+struct Identity
+{
+  /// Apply the identity
+  template <typename V>
+  void operator()(V& x, V& y) const
+  {
+    std::span<const typename V::value_type> _x = owned(x);
+    std::copy(_x.begin(), _x.end(), owned(y).begin());
+  }
+};
+} // namespace impl
+
+/// @brief Preconditioned conjugate gradient method for Hermitian
+/// positive definite operators.
+/// @tparam V The vector type, e.g. la::Vector<double>
+template <typename V>
+class CG
+{
+public:
+  /// Scalar type
+  using T = typename V::value_type;
+
+  /// @brief Create a solver.
+  /// @param[in] x A vector with the parallel layout of the solution.
+  /// Work vectors are created with the same layout.
+  /// @param[in] rtol Relative tolerance on the residual norm
+  /// @param[in] atol Absolute tolerance on the residual norm
+  /// @param[in] max_it Maximum number of iterations
+  CG(const V& x, double rtol = 1e-8, double atol = 0, int max_it = 1000)
+      : rtol(rtol), atol(atol), max_it(max_it), _r(x), _z(x), _p(x), _y(x)
+  {
+  }
+
+  /// Relative tolerance on the residual norm
+  double rtol;
+
+  /// Absolute tolerance on the residual norm
+  double atol;
+
+  /// Maximum number of iterations
+  int max_it;
+
+  /// @brief Solve A x = b.
+  /// @param[in] A The operator, computing `y = A x` for `A(x, y)`
+  /// @param[in,out] x The initial guess, overwritten by the solution.
+  /// Ghost values are updated on return.
+  /// @param[in] b The right-hand side
+  /// @param[in] M The preconditioner, computing `y = M^{-1} x` for
+  /// `M(x, y)`
+  /// @return Number of iterations. If the tolerance is not reached,
+  /// `max_it` is returned.
+  template <typename Op, typename Pc = impl::Identity>
+  int solve(Op&& A, V& x, const V& b, Pc&& M = Pc())
+  {
+    // r = b - A x, z = M r, p = z
+    A(x, _r);
+    la::waxpby(_r, T(1), b, T(-1), _r);
+    M(_r, _z);
+    la::waxpby(_p, T(1), _z, T(0), _z);
+
+    T rz = la::inner_product(_r, _z);
+    const double rnorm0 = la::norm(_r);
+    const double tol = std::max(rtol * rnorm0, atol);
+    if (rnorm0 <= tol)
+    {
+      x.scatter_fwd();
+      return 0;
+    }
+
+    int k = 0;
+    while (k < max_it)
+    {
+      ++k;
+
+      // y = A p
+      A(_p, _y);
+
+      // x <- x + alpha p, r <- r - alpha y, with the residual norm
+      // computed in the same pass over r
+      const T alpha = rz / la::inner_product(_p, _y);
+      la::axpy(x, alpha, _p);
+      const T rr = la::axpy_dot(_r, -alpha, _y, _r);
+      if (std::sqrt(std::real(rr)) <= tol)
+        break;
+
+      // p <- z + beta p
+      M(_r, _z);
+      const T rz_new = la::inner_product(_r, _z);
+      const T beta = rz_new / rz;
+      rz = rz_new;
+      la::waxpby(_p, T(1), _z, beta, _p);
+    }
+
+    x.scatter_fwd();
+    return k;
+  }
+
+private:
+  // Work vectors
+  V _r, _z, _p, _y;
+};
+
+/// @brief Pipelined preconditioned conjugate gradient method for
+/// Hermitian positive definite operators.
+///
+/// The variant of Ghysels and Vanroose (Parallel Computing 40, 2014)
+/// needs a single global reduction per iteration, which is overlapped
+/// with the application of the preconditioner and the operator. It is
+/// mathematically equivalent to CG, but needs more work vectors and
+/// vector updates. It is faster than CG when the latency of global
+/// reductions dominates, e.g. at large process counts. The
+/// convergence check is delayed by one operator application.
+/// @tparam V The vector type, e.g. la::Vector<double>
+template <typename V>
+class PipelinedCG
+{
+public:
+  /// Scalar type
+  using T = typename V::value_type;
+
+  /// @brief Create a solver.
+  /// @param[in] x A vector with the parallel layout of the solution.
+  /// Work vectors are created with the same layout.
+  /// @param[in] rtol Relative tolerance on the residual norm
+  /// @param[in] atol Absolute tolerance on the residual norm
+  /// @param[in] max_it Maximum number of iterations
+  PipelinedCG(const V& x, double rtol = 1e-8, double atol = 0,
+              int max_it = 1000)
+      : rtol(rtol), atol(atol), max_it(max_it), _r(x), _u(x), _w(x), _m(x),
+        _n(x), _z(x), _q(x), _s(x), _p(x)
+  {
+  }
+
+  /// Relative tolerance on the residual norm
+  double rtol;
+
+  /// Absolute tolerance on the residual norm
+  double atol;
+
+  /// Maximum number of iterations
+  int max_it;
+
+  /// @brief Solve A x = b.
+  /// @param[in] A The operator, computing `y = A x` for `A(x, y)`
+  /// @param[in,out] x The initial guess, overwritten by the solution.
+  /// Ghost values are updated on return.
+  /// @param[in] b The right-hand side
+  /// @param[in] M The preconditioner, computing `y = M^{-1} x` for
+  /// `M(x, y)`
+  /// @return Number of iterations. If the tolerance is not reached,
+  /// `max_it` is returned.
+  template <typename Op, typename Pc = impl::Identity>
+  int solve(Op&& A, V& x, const V& b, Pc&& M = Pc())
+  {
+    // r = b - A x, u = M r, w = A u
+    A(x, _r);
+    la::waxpby(_r, T(1), b, T(-1), _r);
+    M(_r, _u);
+    A(_u, _w);
+
+    const std::array<std::array<const V*, 2>, 3> pairs
+        = {{{&_r, &_u}, {&_u, &_w}, {&_r, &_r}}};
+    std::array<T, 3> dots;
+    double tol = 0;
+    T gamma_old = 0, alpha = 0;
+    int k = 0;
+    for (;; ++k)
+    {
+      // Start reduction for gamma = (r, u), delta = (u, w) and (r, r),
+      // and overlap with m = M w, n = A m
+      MPI_Request request = la::inner_product_begin(
+          std::span<const std::array<const V*, 2>>(pairs), std::span<T>(dots));
+      M(_w, _m);
+      A(_m, _n);
+      la::inner_product_end(request);
+
+      const auto [gamma, delta, rr] = dots;
+      const double rnorm = std::sqrt(std::real(rr));
+      if (k == 0)
+        tol = std::max(rtol * rnorm, atol);
+      if (rnorm <= tol or k == max_it)
+        break;
+
+      T beta = 0;
+      if (k == 0)
+        alpha = gamma / delta;
+      else
+      {
+        beta = gamma / gamma_old;
+        alpha = gamma / (delta - beta * gamma / alpha);
+      }
+      gamma_old = gamma;
+
+      // z <- n + beta z, q <- m + beta q, s <- w + beta s, p <- u + beta
+      // p
+      la::waxpby(_z, T(1), _n, beta, _z);
+      la::waxpby(_q, T(1), _m, beta, _q);
+      la::waxpby(_s, T(1), _w, beta, _s);
+      la::waxpby(_p, T(1), _u, beta, _p);
+
+      // x <- x + alpha p, r <- r - alpha s, u <- u - alpha q, w <- w -
+      // alpha z
+      la::axpy(x, alpha, _p);
+      la::axpy(_r, -alpha, _s);
+      la::axpy(_u, -alpha, _q);
+      la::axpy(_w, -alpha, _z);
+    }
+
+    x.scatter_fwd();
+    return k;
+  }
+
+private:
+  // Work vectors
+  V _r, _u, _w, _m, _n, _z, _q, _s, _p;
+};
+
+/// @brief Flexible GMRES method with restarts.
+///
+/// The method is right-preconditioned, and the preconditioner may
+/// change between iterations (e.g. an inner iterative solver).
+/// @tparam V The vector type, e.g. la::Vector<double>
+template <typename V>
+class FGMRES
+{
+public:
+  /// Scalar type
+  using T = typename V::value_type;
+
+  /// @brief Create a solver.
+  /// @param[in] x A vector with the parallel layout of the solution.
+  /// Work vectors are created with the same layout.
+  /// @param[in] restart Number of iterations before a restart
+  /// @param[in] rtol Relative tolerance on the residual norm
+  /// @param[in] atol Absolute tolerance on the residual norm
+  /// @param[in] max_it Maximum number of iterations
+  FGMRES(const V& x, int restart = 30, double rtol = 1e-8, double atol = 0,
+         int max_it = 1000)
+      : rtol(rtol), atol(atol), max_it(max_it), _restart(restart),
+        _H((restart + 1) * restart), _g(restart + 1), _c(restart),
+        _s(restart), _y(restart)
+  {
+    _v.reserve(restart + 1);
+    _z.reserve(restart);
+    for (int i = 0; i < restart + 1; ++i)
+      _v.emplace_back(x);
+    for (int i = 0; i < restart; ++i)
+      _z.emplace_back(x);
+  }
+
+  /// Relative tolerance on the residual norm
+  double rtol;
+
+  /// Absolute tolerance on the residual norm
+  double atol;
+
+  /// Maximum number of iterations
+  int max_it;
+
+  /// @brief Solve A x = b.
+  /// @param[in] A The operator, computing `y = A x` for `A(x, y)`
+  /// @param[in,out] x The initial guess, overwritten by the solution.
+  /// Ghost values are updated on return.
+  /// @param[in] b The right-hand side
+  /// @param[in] M The preconditioner, computing `y = M^{-1} x` for
+  /// `M(x, y)`
+  /// @return Number of iterations. If the tolerance is not reached,
+  /// `max_it` is returned.
+  template <typename Op, typename Pc = impl::Identity>
+  int solve(Op&& A, V& x, const V& b, Pc&& M = Pc())
+  {
+    const int m = _restart;
+    double tol = -1;
+    int k = 0;
+    while (true)
+    {
+      // r = b - A x
+      A(x, _v[0]);
+      la::waxpby(_v[0], T(1), b, T(-1), _v[0]);
+      const double beta = la::norm(_v[0]);
+      if (tol < 0)
+        tol = std::max(rtol * beta, atol);
+      if (beta <= tol or k >= max_it)
+        break;
+
+      // v_0 = r / beta
+      la::waxpby(_v[0], T(1.0 / beta), _v[0], T(0), _v[0]);
+      std::fill(_g.begin(), _g.end(), 0);
+      _g[0] = beta;
+
+      // Arnoldi process
+      int j = 0;
+      for (; j < m and k < max_it; ++j)
+      {
+        ++k;
+
+        // z_j = M v_j, w = A z_j
+        M(_v[j], _z[j]);
+        V& w = _v[j + 1];
+        A(_z[j], w);
+
+        // Modified Gram-Schmidt
+        for (int i = 0; i <= j; ++i)
+        {
+          H(i, j) = la::inner_product(_v[i], w);
+          la::axpy(w, -H(i, j), _v[i]);
+        }
+        const double h = la::norm(w);
+        H(j + 1, j) = h;
+        if (h > 0)
+          la::waxpby(w, T(1.0 / h), w, T(0), w);
+
+        // Apply previous Givens rotations to column j
+        for (int i = 0; i < j; ++i)
+        {
+          const T t = _c[i] * H(i, j) + _s[i] * H(i + 1, j);
+          H(i + 1, j)
+              = -la::impl::conj(_s[i]) * H(i, j) + _c[i] * H(i + 1, j);
+          H(i, j) = t;
+        }
+
+        // Compute and apply rotation that eliminates H(j + 1, j)
+        const double a = std::abs(H(j, j));
+        const double r = std::sqrt(a * a + h * h);
+        if (a == 0)
+        {
+          _c[j] = 0;
+          _s[j] = 1;
+        }
+        else
+        {
+          _c[j] = a / r;
+          _s[j] = (H(j, j) / a) * T(h / r);
+        }
+        H(j, j) = _c[j] * H(j, j) + _s[j] * H(j + 1, j);
+        H(j + 1, j) = 0;
+        _g[j + 1] = -la::impl::conj(_s[j]) * _g[j];
+        _g[j] = _c[j] * _g[j];
+
+        if (std::abs(_g[j + 1]) <= tol)
+        {
+          ++j;
+          break;
+        }
+      }
+
+      // Solve upper triangular system H y = g and update x <- x + Z y
+      for (int i = j - 1; i >= 0; --i)
+      {
+        T yi = _g[i];
+        for (int l = i + 1; l < j; ++l)
+          yi -= H(i, l) * _y[l];
+        _y[i] = yi / H(i, i);
+      }
+      for (int i = 0; i < j; ++i)
+        la::axpy(x, _y[i], _z[i]);
+    }
+
+    x.scatter_fwd();
+    return k;
+  }
+
+private:
+  // Access the Hessenberg matrix (column-major)
+  T& H(int i, int j) { return _H[j * (_restart + 1) + i]; }
+
+  // Restart length
+  int _restart;
+
+  // Hessenberg matrix, rotated right-hand side, Givens rotations and
+  // solution of the least-squares problem
+  std::vector<T> _H, _g, _c, _s, _y;
+
+  // Krylov basis and preconditioned basis
+  std::vector<V> _v, _z;
+};
+
+/// @brief Right-preconditioned BiCGStab method for non-symmetric
+/// operators.
+/// @tparam V The vector type, e.g. la::Vector<double>
+template <typename V>
+class BiCGStab
+{
+public:
+  /// Scalar type
+  using T = typename V::value_type;
+
+  /// @brief Create a solver.
+  /// @param[in] x A vector with the parallel layout of the solution.
+  /// Work vectors are created with the same layout.
+  /// @param[in] rtol Relative tolerance on the residual norm
+  /// @param[in] atol Absolute tolerance on the residual norm
+  /// @param[in] max_it Maximum number of iterations
+  BiCGStab(const V& x, double rtol = 1e-8, double atol = 0, int max_it = 1000)
+      : rtol(rtol), atol(atol), max_it(max_it), _r(x), _r0(x), _p(x),
+        _v(x), _t(x), _ph(x), _sh(x)
+  {
+  }
+
+  /// Relative tolerance on the residual norm
+  double rtol;
+
+  /// Absolute tolerance on the residual norm
+  double atol;
+
+  /// Maximum number of iterations
+  int max_it;
+
+  /// @brief Solve A x = b.
+  /// @param[in] A The operator, computing `y = A x` for `A(x, y)`
+  /// @param[in,out] x The initial guess, overwritten by the solution.
+  /// Ghost values are updated on return.
+  /// @param[in] b The right-hand side
+  /// @param[in] M The preconditioner, computing `y = M^{-1} x` for
+  /// `M(x, y)`
+  /// @return Number of iterations. If the tolerance is not reached,
+  /// `max_it` is returned.
+  template <typename Op, typename Pc = impl::Identity>
+  int solve(Op&& A, V& x, const V& b, Pc&& M = Pc())
+  {
+    // r = b - A x, r0 = r
+    A(x, _r);
+    la::waxpby(_r, T(1), b, T(-1), _r);
+    la::waxpby(_r0, T(1), _r, T(0), _r);
+
+    const double rnorm0 = la::norm(_r);
+    const double tol = std::max(rtol * rnorm0, atol);
+    if (rnorm0 <= tol)
+    {
+      x.scatter_fwd();
+      return 0;
+    }
+
+    T rho = 1, alpha = 1, omega = 1;
+    int k = 0;
+    while (k < max_it)
+    {
+      ++k;
+      const T rho_new = la::inner_product(_r0, _r);
+      if (rho_new == T(0))
+        throw std::runtime_error("BiCGStab breakdown (rho = 0).");
+
+      // p <- r + beta (p - omega v)
+      if (k == 1)
+        la::waxpby(_p, T(1), _r, T(0), _r);
+      else
+      {
+        const T beta = (rho_new / rho) * (alpha / omega);
+        la::axpy(_p, -omega, _v);
+        la::waxpby(_p, T(1), _r, beta, _p);
+      }
+      rho = rho_new;
+
+      // v = A M^{-1} p
+      M(_p, _ph);
+      A(_ph, _v);
+      alpha = rho / la::inner_product(_r0, _v);
+
+      // s = r - alpha v (stored in r)
+      la::axpy(_r, -alpha, _v);
+      if (la::norm(_r) <= tol)
+      {
+        la::axpy(x, alpha, _ph);
+        break;
+      }
+
+      // t = A M^{-1} s
+      M(_r, _sh);
+      A(_sh, _t);
+      omega = la::inner_product(_t, _r) / la::inner_product(_t, _t);
+
+      // x <- x + alpha ph + omega sh, r <- s - omega t
+      la::axpy(x, alpha, _ph);
+      la::axpy(x, omega, _sh);
+      la::axpy(_r, -omega, _t);
+      if (la::norm(_r) <= tol)
+        break;
+      if (omega == T(0))
+        throw std::runtime_error("BiCGStab breakdown (omega = 0).");
+    }
+
+    x.scatter_fwd();
+    return k;
+  }
+
+private:
+  // Work vectors
+  V _r, _r0, _p, _v, _t, _ph, _sh;
+};
+
+/// @brief Preconditioned MINRES method for Hermitian (possibly
+/// indefinite) operators.
+///
+/// The preconditioner must be Hermitian positive definite. The
+/// convergence test uses the preconditioned residual norm
+/// \f$\|r\|_{M^{-1}}\f$, which is estimated by the recurrence.
+/// @tparam V The vector type, e.g. la::Vector<double>
+template <typename V>
+class MINRES
+{
+public:
+  /// Scalar type
+  using T = typename V::value_type;
+
+  /// @brief Create a solver.
+  /// @param[in] x A vector with the parallel layout of the solution.
+  /// Work vectors are created with the same layout.
+  /// @param[in] rtol Relative tolerance on the (preconditioned)
+  /// residual norm
+  /// @param[in] atol Absolute tolerance on the (preconditioned)
+  /// residual norm
+  /// @param[in] max_it Maximum number of iterations
+  MINRES(const V& x, double rtol = 1e-8, double atol = 0, int max_it = 1000)
+      : rtol(rtol), atol(atol), max_it(max_it), _r1(x), _r2(x), _y(x),
+        _v(x), _w(x), _w1(x), _w2(x)
+  {
+  }
+
+  /// Relative tolerance on the (preconditioned) residual norm
+  double rtol;
+
+  /// Absolute tolerance on the (preconditioned) residual norm
+  double atol;
+
+  /// Maximum number of iterations
+  int max_it;
+
+  /// @brief Solve A x = b.
+  /// @param[in] A The operator, computing `y = A x` for `A(x, y)`
+  /// @param[in,out] x The initial guess, overwritten by the solution.
+  /// Ghost values are updated on return.
+  /// @param[in] b The right-hand side
+  /// @param[in] M The preconditioner, computing `y = M^{-1} x` for
+  /// `M(x, y)`
+  /// @return Number of iterations. If the tolerance is not reached,
+  /// `max_it` is returned.
+  template <typename Op, typename Pc = impl::Identity>
+  int solve(Op&& A, V& x, const V& b, Pc&& M = Pc())
+  {
+    // r1 = b - A x, y = M r1
+    A(x, _r1);
+    la::waxpby(_r1, T(1), b, T(-1), _r1);
+    M(_r1, _y);
+    const double beta1 = preconditioned_norm(_r1, _y);
+    const double tol = std::max(rtol * beta1, atol);
+    if (beta1 <= tol)
+    {
+      x.scatter_fwd();
+      return 0;
+    }
+
+    la::waxpby(_r2, T(1), _r1, T(0), _r1);
+    _w.set(0);
+    _w2.set(0);
+
+    double oldb = 0, beta = beta1, dbar = 0, epsln = 0, phibar = beta1;
+    double cs = -1, sn = 0;
+    int k = 0;
+    while (k < max_it)
+    {
+      ++k;
+
+      // Lanczos step
+      la::waxpby(_v, T(1.0 / beta), _y, T(0), _y);
+      A(_v, _y);
+      if (k >= 2)
+        la::axpy(_y, T(-beta / oldb), _r1);
+      const double alpha = std::real(la::inner_product(_v, _y));
+      la::axpy(_y, T(-alpha / beta), _r2);
+      std::swap(_r1, _r2);
+      la::waxpby(_r2, T(1), _y, T(0), _y);
+      M(_r2, _y);
+      oldb = beta;
+      beta = preconditioned_norm(_r2, _y);
+
+      // Apply previous rotation and compute the next one
+      const double oldeps = epsln;
+      const double delta = cs * dbar + sn * alpha;
+      const double gbar = sn * dbar - cs * alpha;
+      epsln = sn * beta;
+      dbar = -cs * beta;
+      const double gamma = std::max(std::hypot(gbar, beta),
+                                    std::numeric_limits<double>::epsilon());
+      cs = gbar / gamma;
+      sn = beta / gamma;
+      const double phi = cs * phibar;
+      phibar = sn * phibar;
+
+      // w <- (v - oldeps w1 - delta w2) / gamma, x <- x + phi w
+      std::swap(_w1, _w2);
+      std::swap(_w2, _w);
+      la::waxpby(_w, T(1.0 / gamma), _v, T(0), _v);
+      la::axpy(_w, T(-oldeps / gamma), _w1);
+      la::axpy(_w, T(-delta / gamma), _w2);
+      la::axpy(x, T(phi), _w);
+
+      if (phibar <= tol)
+        break;
+    }
+
+    x.scatter_fwd();
+    return k;
+  }
+
+private:
+  // Compute sqrt(r^H M^{-1} r), given y = M^{-1} r
+  static double preconditioned_norm(const V& r, const V& y)
+  {
+    const double rMr = std::real(la::inner_product(r, y));
+    if (rMr < 0)
+    {
+      throw std::runtime_error(
+          "MINRES preconditioner is not positive definite.");
+    }
+    return std::sqrt(rMr);
+  }
+
+  // Work vectors
+  V _r1, _r2, _y, _v, _w, _w1, _w2;
+};
+
+} // namespace dolfinx::la::solvers
@@ -19,6 +19,7 @@
 #include <dolfinx/graph/ordering.h>
 #include <dolfinx/graph/partition.h>
 #include <memory>
+#include <numeric>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xsort.hpp>
 #include <xtensor/xview.hpp>
@@ -36,6 +37,19 @@ reorder_list(const graph::AdjacencyList<T>& list,
 {
   // Copy existing data to keep ghost values (not reordered)
   std::vector<T> data(list.array());
+
+  // Constant degree lists keep their storage without offsets
+  if (const int degree = list.degree(); degree >= 0)
+  {
+    for (std::size_t n = 0; n < nodemap.size(); ++n)
+    {
+      auto links_old = list.links(n);
+      std::copy(links_old.begin(), links_old.end(),
+                std::next(data.begin(), nodemap[n] * degree));
+    }
+    return graph::AdjacencyList<T>(std::move(data), degree, list.num_nodes());
+  }
+
   std::vector<std::int32_t> offsets(list.offsets().size());
 
   // Compute new offsets (owned and ghost)
@@ -76,6 +90,18 @@ Mesh mesh::create_mesh(MPI_Comm comm,
                        const xt::xtensor<double, 2>& x,
                        mesh::GhostMode ghost_mode,
                        const mesh::CellPartitionFunction& cell_partitioner)
+{
+  return create_mesh(comm, cells, element, x, ghost_mode, cell_partitioner,
+                     graph::reorder_gps);
+}
+//-----------------------------------------------------------------------------
+Mesh mesh::create_mesh(
+    MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
+    const fem::CoordinateElement& element, const xt::xtensor<double, 2>& x,
+    mesh::GhostMode ghost_mode,
+    const mesh::CellPartitionFunction& cell_partitioner,
+    const std::function<std::vector<std::int32_t>(
+        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
 {
   if (ghost_mode == GhostMode::shared_vertex)
     throw std::runtime_error("Ghost mode via vertex currently disabled.");
@@ -84,7 +110,8 @@ Mesh mesh::create_mesh(MPI_Comm comm,
 
   // Function top build geometry. Used to scope memory operations.
   auto build_topology = [](auto comm, auto& element, auto& dof_layout,
-                           auto& cells, auto ghost_mode, auto& cell_partitioner)
+                           auto& cells, auto ghost_mode, auto& cell_partitioner,
+                           auto& reorder_fn)
   {
     // -- Partition topology
 
@@ -130,14 +157,19 @@ Mesh mesh::create_mesh(MPI_Comm comm,
     // Build local dual graph for owned cells to apply re-ordering to
     const std::int32_t num_owned_cells
         = cells_extracted.num_nodes() - ghost_owners.size();
-    const std::vector<int> remap
-        = graph::reorder_gps(std::get<0>(build_local_dual_graph(
-            std::span<const std::int64_t>(
-                cells_extracted.array().data(),
-                cells_extracted.offsets()[num_owned_cells]),
-            std::span<const std::int32_t>(cells_extracted.offsets().data(),
-                                          num_owned_cells + 1),
-            tdim)));
+    std::vector<int> remap(num_owned_cells);
+    if (reorder_fn)
+    {
+      remap = reorder_fn(std::get<0>(build_local_dual_graph(
+          std::span<const std::int64_t>(
+              cells_extracted.array().data(),
+              cells_extracted.offsets()[num_owned_cells]),
+          std::span<const std::int32_t>(cells_extracted.offsets().data(),
+                                        num_owned_cells + 1),
+          tdim)));
+    }
+    else
+      std::iota(remap.begin(), remap.end(), 0);
 
     // Create re-ordered cell lists (leaves ghosts unchanged)
     std::vector<std::int64_t> original_cell_index(original_cell_index0.size());
@@ -160,8 +192,9 @@ Mesh mesh::create_mesh(MPI_Comm comm,
                      std::move(cell_nodes)};
   };
 
-  auto [topology, cell_nodes] = build_topology(comm, element, dof_layout, cells,
-                                               ghost_mode, cell_partitioner);
+  auto [topology, cell_nodes]
+      = build_topology(comm, element, dof_layout, cells, ghost_mode,
+                       cell_partitioner, reorder_fn);
 
   // Create connectivity required to compute the Geometry (extra
   // connectivities for higher-order geometries)
@@ -190,8 +223,21 @@ Mesh mesh::create_mesh(MPI_Comm comm,
                     + topology.index_map(tdim)->num_ghosts();
 
     // Remove ghost cells from geometry data, if not required
-    cell_nodes.offsets().resize(num_cells + 1);
-    cell_nodes.array().resize(cell_nodes.offsets().back());
+    if (cell_nodes.degree() < 0)
+    {
+      std::vector<std::int32_t> offsets(
+          cell_nodes.offsets().begin(),
+          std::next(cell_nodes.offsets().begin(), num_cells + 1));
+      cell_nodes.array().resize(offsets.back());
+      cell_nodes = graph::AdjacencyList<std::int64_t>(
+          std::move(cell_nodes.array()), std::move(offsets));
+    }
+    else
+    {
+      cell_nodes.array().resize(num_cells * cell_nodes.degree());
+      cell_nodes = graph::AdjacencyList<std::int64_t>(
+          std::move(cell_nodes.array()), cell_nodes.degree(), num_cells);
+    }
 
     if (element.needs_dof_permutations())
       topology.create_entity_permutations();
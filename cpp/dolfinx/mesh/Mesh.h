@@ -10,6 +10,7 @@
 #include "Topology.h"
 #include "utils.h"
 #include <dolfinx/common/MPI.h>
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -135,6 +136,28 @@ Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
                  const xt::xtensor<double, 2>& x, GhostMode ghost_mode,
                  const CellPartitionFunction& cell_partitioner);
 
+/// @brief Create a mesh using a provided mesh partitioning function
+/// and cell re-ordering function.
+///
+/// @param[in] comm The MPI communicator to build the mesh on
+/// @param[in] cells The cells on the this MPI rank (see create_mesh)
+/// @param[in] element The coordinate element that describes the
+/// geometric mapping for cells
+/// @param[in] x The coordinates of mesh nodes
+/// @param[in] ghost_mode The requested type of cell ghosting/overlap
+/// @param[in] cell_partitioner The cell partitioning function
+/// @param[in] reorder_fn Graph re-ordering function that is applied to
+/// the (local) dual graph of the owned cells, e.g. graph::reorder_gps
+/// (the default for the other create_mesh functions) or
+/// graph::reorder_rcm. If `nullptr`, cells are not re-ordered.
+/// @return A distributed Mesh.
+Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
+                 const fem::CoordinateElement& element,
+                 const xt::xtensor<double, 2>& x, GhostMode ghost_mode,
+                 const CellPartitionFunction& cell_partitioner,
+                 const std::function<std::vector<std::int32_t>(
+                     const graph::AdjacencyList<std::int32_t>&)>& reorder_fn);
+
 /// Create a new mesh consisting of a subset of entities in a mesh.
 /// @param[in] mesh The mesh
 /// @param[in] dim Entity dimension
@@ -350,10 +350,14 @@ vertex_ownerhip_groups(const graph::AdjacencyList<std::int64_t>& cells,
   common::Timer timer("Topology: determine vertex ownership groups (owned, "
                       "undetermined, unowned)");
 
+  // Position of the first ghost cell vertex
+  const std::size_t ghost_offset
+      = cells.degree() < 0 ? cells.offsets()[num_local_cells]
+                           : std::size_t(num_local_cells) * cells.degree();
+
   // Build set of 'local' cell vertices (attached to an owned cell)
   std::vector<std::int64_t> local_vertex_set(
-      cells.array().begin(),
-      std::next(cells.array().begin(), cells.offsets()[num_local_cells]));
+      cells.array().begin(), std::next(cells.array().begin(), ghost_offset));
   dolfinx::radix_sort(std::span(local_vertex_set));
   local_vertex_set.erase(
       std::unique(local_vertex_set.begin(), local_vertex_set.end()),
@@ -361,8 +365,7 @@ vertex_ownerhip_groups(const graph::AdjacencyList<std::int64_t>& cells,
 
   // Build set of ghost cell vertices (attached to a ghost cell)
   std::vector<std::int64_t> ghost_vertex_set(
-      std::next(cells.array().begin(), cells.offsets()[num_local_cells]),
-      cells.array().end());
+      std::next(cells.array().begin(), ghost_offset), cells.array().end());
   dolfinx::radix_sort(std::span(ghost_vertex_set));
   ghost_vertex_set.erase(
       std::unique(ghost_vertex_set.begin(), ghost_vertex_set.end()),
@@ -740,10 +743,16 @@ graph::AdjacencyList<std::int32_t> convert_to_local_indexing(
     const std::span<const std::pair<std::int64_t, std::int32_t>>&
         global_to_local)
 {
-  std::vector<std::int32_t> offsets(
-      g.offsets().begin(), std::next(g.offsets().begin(), num_local_nodes + 1));
+  // Keep constant degree storage (no offsets) if possible
+  std::vector<std::int32_t> offsets;
+  if (g.degree() < 0)
+  {
+    offsets.assign(g.offsets().begin(),
+                   std::next(g.offsets().begin(), num_local_nodes + 1));
+  }
 
-  std::vector<std::int32_t> data(offsets.back());
+  std::vector<std::int32_t> data(
+      g.degree() < 0 ? offsets.back() : num_local_nodes * g.degree());
   std::transform(g.array().begin(), std::next(g.array().begin(), data.size()),
                  data.begin(),
                  [&global_to_local](auto i)
@@ -757,8 +766,16 @@ graph::AdjacencyList<std::int32_t> convert_to_local_indexing(
                    return it->second;
                  });
 
-  return graph::AdjacencyList<std::int32_t>(std::move(data),
-                                            std::move(offsets));
+  if (g.degree() < 0)
+  {
+    return graph::AdjacencyList<std::int32_t>(std::move(data),
+                                              std::move(offsets));
+  }
+  else
+  {
+    return graph::AdjacencyList<std::int32_t>(std::move(data), g.degree(),
+                                              num_local_nodes);
+  }
 }
 } // namespace
 
@@ -860,6 +877,13 @@ void Topology::create_entity_permutations()
       = compute_entity_permutations(*this);
   _facet_permutations = std::move(facet_permutations);
   _cell_permutations = std::move(cell_permutations);
+
+  _cell_permutation_signatures = _cell_permutations;
+  dolfinx::radix_sort(std::span(_cell_permutation_signatures));
+  _cell_permutation_signatures.erase(
+      std::unique(_cell_permutation_signatures.begin(),
+                  _cell_permutation_signatures.end()),
+      _cell_permutation_signatures.end());
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
@@ -893,6 +917,14 @@ const std::vector<std::uint32_t>& Topology::get_cell_permutation_info() const
   return _cell_permutations;
 }
 //-----------------------------------------------------------------------------
+const std::vector<std::uint32_t>&
+Topology::get_cell_permutation_signatures() const
+{
+  // Signatures are computed together with the permutation information
+  get_cell_permutation_info();
+  return _cell_permutation_signatures;
+}
+//-----------------------------------------------------------------------------
 const std::vector<std::uint8_t>& Topology::get_facet_permutations() const
 {
   if (auto i_map = this->index_map(this->dim() - 1);
@@ -98,6 +98,15 @@ public:
   /// Returns the permutation information
   const std::vector<std::uint32_t>& get_cell_permutation_info() const;
 
+  /// @brief Get the distinct values of the cell permutation
+  /// information, in increasing order.
+  ///
+  /// Elements that precompute DOF transformations for each signature
+  /// use this to avoid searching the information for each cell.
+  /// @note An exception is raised if the permutations have not been
+  /// computed
+  const std::vector<std::uint32_t>& get_cell_permutation_signatures() const;
+
   /// @brief Get the permutation number to apply to a facet.
   ///
   /// The permutations are numbered so that:
@@ -160,6 +169,9 @@ private:
   // Cell permutation info. See the documentation for
   // get_cell_permutation_info for documentation of how this is encoded.
   std::vector<std::uint32_t> _cell_permutations;
+
+  // Distinct values of _cell_permutations (sorted)
+  std::vector<std::uint32_t> _cell_permutation_signatures;
 };
 
 /// @brief Create a distributed mesh topology.
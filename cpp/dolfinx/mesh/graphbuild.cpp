@@ -337,8 +337,8 @@ graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
 
   // Count number of adjacency list edges
   std::vector<std::int32_t> num_edges(local_graph.num_nodes(), 0);
-  std::adjacent_difference(std::next(local_graph.offsets().begin()),
-                           local_graph.offsets().end(), num_edges.begin());
+  for (std::size_t i = 0; i < num_edges.size(); ++i)
+    num_edges[i] = local_graph.num_links(i);
   for (std::size_t i = 0; i < recv_buffer1.size(); ++i)
   {
     if (recv_buffer1[i] >= 0)
@@ -542,9 +542,9 @@ mesh::build_dual_graph(const MPI_Comm comm,
   graph::AdjacencyList<std::int64_t> graph
       = compute_nonlocal_dual_graph(comm, facets, shape1, fcells, local_graph);
 
-  LOG(INFO) << "Graph edges (local: " << local_graph.offsets().back()
+  LOG(INFO) << "Graph edges (local: " << local_graph.array().size()
             << ", non-local: "
-            << graph.offsets().back() - local_graph.offsets().back() << ")";
+            << graph.array().size() - local_graph.array().size() << ")";
 
   return graph;
 }
@@ -706,7 +706,9 @@ compute_from_map(const graph::AdjacencyList<std::int32_t>& c_d0_0,
   // AdjacencyList will have same offset pattern
   std::vector<std::int32_t> connections;
   connections.reserve(c_d0_0.array().size());
-  std::vector<std::int32_t> offsets(c_d0_0.offsets());
+  std::vector<std::int32_t> offsets(c_d0_0.num_nodes() + 1, 0);
+  for (std::int32_t c = 0; c < c_d0_0.num_nodes(); ++c)
+    offsets[c + 1] = offsets[c] + c_d0_0.num_links(c);
 
   // Search for edges of facet in map, and recover index
   const auto tri_vertices_ref
@@ -10,13 +10,15 @@
 #include <dolfinx/common/Scatterer.h>
 #include <numeric>
 #include <set>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 using namespace dolfinx;
 
 namespace
 {
-void test_scatter_fwd(int n)
+void test_scatter_fwd(int n, common::Scatterer::type type, bool shared_memory)
 {
   const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
   const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
@@ -33,7 +35,7 @@ void test_scatter_fwd(int n)
   // Create an IndexMap
   const common::IndexMap idx_map(MPI_COMM_WORLD, size_local, ghosts,
                                  global_ghost_owner);
-  common::Scatterer sct(idx_map, n);
+  common::Scatterer sct(idx_map, n, type, shared_memory);
 
   // Create some data to scatter
   const std::int64_t val = 11;
@@ -47,12 +49,30 @@ void test_scatter_fwd(int n)
   CHECK(std::all_of(data_ghost.begin(), data_ghost.end(),
                     [=](auto i)
                     { return i == val * ((mpi_rank + 1) % mpi_size); }));
+
+  // Autotuned backend must be the same on all ranks
+  const int best = static_cast<int>(common::Scatterer::autotune(idx_map, n));
+  int best_min = -1;
+  MPI_Allreduce(&best, &best_min, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  CHECK(best == best_min);
+
+  // Packing (by contiguous runs if detected) must match indexed access
+  std::iota(data_local.begin(), data_local.end(), 0);
+  const std::vector<std::int32_t>& local_inds = sct.local_indices();
+  std::vector<std::int64_t> buffer(sct.local_buffer_size());
+  sct.pack_local(std::span<const std::int64_t>(data_local),
+                 std::span<std::int64_t>(buffer));
+  for (std::size_t i = 0; i < buffer.size(); ++i)
+    CHECK(buffer[i] == data_local[local_inds[i]]);
 }
 
 void test_scatter_rev()
 {
-  // Block size
+  // Block size and communication backend
   auto n = GENERATE(1, 5, 10);
+  auto type = GENERATE(common::Scatterer::type::neighbor,
+                       common::Scatterer::type::p2p,
+                       common::Scatterer::type::rma);
 
   const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
   const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
@@ -69,7 +89,7 @@ void test_scatter_rev()
   // Create an IndexMap
   const common::IndexMap idx_map(MPI_COMM_WORLD, size_local, ghosts,
                                  global_ghost_owner);
-  common::Scatterer sct(idx_map, n);
+  common::Scatterer sct(idx_map, n, type);
 
   // Create some data, setting ghost values
   std::int64_t value = 15;
@@ -127,12 +147,83 @@ void test_consensus_exchange()
 
   CHECK(dest_ranks0 == dest_ranks1);
 }
+
+void test_global_to_local()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 100;
+
+  // Create some ghost entries (in reverse order) on next process
+  const int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + num_ghosts - 1 - i;
+  std::vector<int> global_ghost_owner(ghosts.size(), (mpi_rank + 1) % mpi_size);
+  const common::IndexMap idx_map(MPI_COMM_WORLD, size_local, ghosts,
+                                 global_ghost_owner);
+
+  // Round trip of all local indices
+  std::vector<std::int32_t> local(size_local + num_ghosts);
+  std::iota(local.begin(), local.end(), 0);
+  std::vector<std::int64_t> global(local.size());
+  idx_map.local_to_global(local, global);
+
+  // Concurrent calls, including the first call on the map
+  std::vector<std::vector<std::int32_t>> local1(
+      4, std::vector<std::int32_t>(local.size(), -2));
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < local1.size(); ++i)
+    {
+      threads.emplace_back([&, i]()
+                           { idx_map.global_to_local(global, local1[i]); });
+    }
+  }
+  for (auto& l : local1)
+    CHECK(l == local);
+
+  // Indices that are not on this process
+  if (mpi_size > 1)
+  {
+    const std::int64_t last_ghost = (mpi_rank + 1) % mpi_size * size_local
+                                    + size_local - 1;
+    std::vector<std::int64_t> missing = {last_ghost, idx_map.size_global()};
+    std::vector<std::int32_t> missing_local(missing.size());
+    idx_map.global_to_local(missing, missing_local);
+    CHECK(missing_local[0] == -1);
+    CHECK(missing_local[1] == -1);
+  }
+
+  // Moved maps keep the ghost lookup, and moved-from maps have no
+  // ghosts
+  common::IndexMap idx_map0(MPI_COMM_WORLD, size_local, ghosts,
+                            global_ghost_owner);
+  idx_map0.global_to_local(global, local1[0]);
+  common::IndexMap idx_map1(std::move(idx_map0));
+  idx_map1.global_to_local(global, local1[0]);
+  CHECK(local1[0] == local);
+  CHECK(idx_map0.num_ghosts() == 0);
+}
+
+void test_shared_indices_src()
+{
+  // The src ranks must be the owners of the ghosts
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const common::IndexMap idx_map(MPI_COMM_WORLD, 10, {{{mpi_rank}, {}}}, {},
+                                 {});
+  CHECK_THROWS_AS(idx_map.shared_indices(), std::runtime_error);
+}
 } // namespace
 
 TEST_CASE("Scatter forward using IndexMap", "[index_map_scatter_fwd]")
 {
   auto n = GENERATE(1, 5, 10);
-  CHECK_NOTHROW(test_scatter_fwd(n));
+  auto type = GENERATE(common::Scatterer::type::neighbor,
+                       common::Scatterer::type::p2p,
+                       common::Scatterer::type::rma);
+  auto shared_memory = GENERATE(false, true);
+  CHECK_NOTHROW(test_scatter_fwd(n, type, shared_memory));
 }
 
 TEST_CASE("Scatter reverse using IndexMap", "[index_map_scatter_rev]")
@@ -145,3 +236,13 @@ TEST_CASE("Communication graph edges via consensus exchange",
 {
   CHECK_NOTHROW(test_consensus_exchange());
 }
+
+TEST_CASE("Global to local index map", "[index_map_global_to_local]")
+{
+  CHECK_NOTHROW(test_global_to_local());
+}
+
+TEST_CASE("Shared indices of IndexMap", "[index_map_shared_indices]")
+{
+  CHECK_NOTHROW(test_shared_indices_src());
+}
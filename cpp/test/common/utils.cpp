@@ -0,0 +1,54 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the thread block helpers
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <dolfinx/common/utils.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Thread block helpers", "[apply_blocks]")
+{
+  auto num_threads = GENERATE(1, 3);
+  const std::int64_t n = 100;
+
+  // Each entry is visited once
+  std::vector<int> count(n, 0);
+  common::apply_blocks(n, num_threads,
+                       [&count](std::int64_t i0, std::int64_t i1)
+                       {
+                         for (std::int64_t i = i0; i < i1; ++i)
+                           ++count[i];
+                       });
+  CHECK(count == std::vector<int>(n, 1));
+
+  const std::int64_t sum = common::reduce_blocks<std::int64_t>(
+      n, num_threads,
+      [](std::int64_t i0, std::int64_t i1)
+      {
+        std::int64_t s = 0;
+        for (std::int64_t i = i0; i < i1; ++i)
+          s += i;
+        return s;
+      });
+  CHECK(sum == n * (n - 1) / 2);
+
+  // An exception thrown in a block is passed to the caller
+  auto f = [n](std::int64_t i0, std::int64_t i1)
+  {
+    if (i0 <= n - 1 and n - 1 < i1)
+      throw std::runtime_error("Error in last block");
+    return std::int64_t(0);
+  };
+  CHECK_THROWS_AS(common::apply_blocks(n, num_threads, f),
+                  std::runtime_error);
+  CHECK_THROWS_AS(common::reduce_blocks<std::int64_t>(n, num_threads, f),
+                  std::runtime_error);
+}
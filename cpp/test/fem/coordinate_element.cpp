@@ -0,0 +1,61 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for fem::CoordinateElement
+
+#include <catch2/catch.hpp>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xview.hpp>
+
+using namespace dolfinx;
+
+TEST_CASE("Batched non-affine pull back", "[coordinate_element]")
+{
+  fem::CoordinateElement cmap(mesh::CellType::triangle, 2);
+
+  // Two P2 triangles with a curved edge
+  const std::size_t gdim = 2;
+  const std::vector<double> geometry
+      = {0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.6, 0.6,  0.0, 0.5, 0.5, 0.0,
+         1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.6, 1.1, 0.4, 0.6, 1.05, 0.5};
+  const std::size_t num_nodes = cmap.dim();
+
+  // Reference points and the cell that each point belongs to
+  const xt::xtensor<double, 2> X0
+      = {{0.1, 0.1}, {0.2, 0.7}, {0.45, 0.45}, {0.3, 0.2}, {0.05, 0.9}};
+  const std::vector<std::int32_t> cells = {0, 1, 0, 1, 1};
+
+  // Push forward reference points to physical points
+  const xt::xtensor<double, 4> phi = cmap.tabulate(0, X0);
+  std::vector<double> x(X0.shape(0) * gdim, 0.0);
+  for (std::size_t p = 0; p < X0.shape(0); ++p)
+    for (std::size_t n = 0; n < num_nodes; ++n)
+      for (std::size_t j = 0; j < gdim; ++j)
+        x[p * gdim + j] += phi(0, p, n, 0)
+                           * geometry[(cells[p] * num_nodes + n) * gdim + j];
+
+  // Batched pull back
+  std::vector<double> X(X0.size());
+  cmap.pull_back_nonaffine(X, x, geometry, cells, gdim);
+  for (std::size_t i = 0; i < X.size(); ++i)
+    CHECK(X[i] == Approx(X0.data()[i]).margin(1.0e-10));
+
+  // Compare to point-wise pull back
+  for (std::size_t p = 0; p < X0.shape(0); ++p)
+  {
+    xt::xtensor<double, 2> g({num_nodes, gdim});
+    std::copy_n(std::next(geometry.begin(), cells[p] * num_nodes * gdim),
+                g.size(), g.begin());
+    xt::xtensor<double, 2> xp({1, gdim});
+    std::copy_n(std::next(x.begin(), p * gdim), gdim, xp.begin());
+    xt::xtensor<double, 2> Xp({1, gdim});
+    cmap.pull_back_nonaffine(Xp, xp, g);
+    for (std::size_t j = 0; j < gdim; ++j)
+      CHECK(X[p * gdim + j] == Approx(Xp(0, j)).margin(1.0e-10));
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the discrete operators
+
+#include <basix/finite-element.h>
+#include <catch2/catch.hpp>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/discreteoperators.h>
+#include <dolfinx/fem/sparsitybuild.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/generation.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Create a matrix for an operator from V0 to V1 with the sparsity
+// pattern of the cell dofmaps
+la::MatrixCSR<double> create_matrix(const fem::FunctionSpace& V0,
+                                    const fem::FunctionSpace& V1)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = V1.mesh();
+  la::SparsityPattern sp(
+      mesh->comm(), {V1.dofmap()->index_map, V0.dofmap()->index_map},
+      {V1.dofmap()->index_map_bs(), V0.dofmap()->index_map_bs()});
+  fem::sparsitybuild::cells(sp, mesh->topology(),
+                            {*V1.dofmap(), *V0.dofmap()});
+  sp.assemble();
+  return la::MatrixCSR<double>(sp);
+}
+
+// Check that the owned rows of two matrices have the same non-zero
+// entries (compared by global column index)
+void check_equal(const la::MatrixCSR<double>& A0,
+                 const la::MatrixCSR<double>& A1)
+{
+  REQUIRE(A0.num_owned_rows() == A1.num_owned_rows());
+  auto row = [](const la::MatrixCSR<double>& A, std::int32_t r)
+  {
+    const std::vector<std::int32_t>& row_ptr = A.row_ptr();
+    std::vector<std::int32_t> cols(
+        std::next(A.cols().begin(), row_ptr[r]),
+        std::next(A.cols().begin(), row_ptr[r + 1]));
+    std::vector<std::int64_t> global(cols.size());
+    A.index_maps()[1]->local_to_global(cols, global);
+
+    std::vector<std::pair<std::int64_t, double>> entries;
+    for (std::size_t j = 0; j < cols.size(); ++j)
+    {
+      if (double v = A.values()[row_ptr[r] + j]; v != 0.0)
+        entries.emplace_back(global[j], v);
+    }
+    std::sort(entries.begin(), entries.end());
+    return entries;
+  };
+
+  for (std::int32_t r = 0; r < A0.num_owned_rows(); ++r)
+  {
+    auto row0 = row(A0, r);
+    auto row1 = row(A1, r);
+    REQUIRE(row0.size() == row1.size());
+    for (std::size_t j = 0; j < row0.size(); ++j)
+    {
+      CHECK(row0[j].first == row1[j].first);
+      CHECK(row0[j].second == Approx(row1[j].second));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Discrete operators as MatrixCSR", "[discrete_operators]")
+{
+  auto num_threads = GENERATE(1, 3);
+
+  auto mesh = std::make_shared<mesh::Mesh>(mesh::create_box(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {3, 3, 3},
+      mesh::CellType::tetrahedron, mesh::GhostMode::none));
+  auto create_space = [mesh](basix::element::family family, int degree,
+                             basix::element::lagrange_variant variant)
+  {
+    return fem::create_functionspace(
+        mesh,
+        basix::create_element(family, basix::cell::type::tetrahedron, degree,
+                              variant, false),
+        1);
+  };
+  const fem::FunctionSpace P1
+      = create_space(basix::element::family::P, 1,
+                     basix::element::lagrange_variant::equispaced);
+  const fem::FunctionSpace N1
+      = create_space(basix::element::family::N1E, 1,
+                     basix::element::lagrange_variant::legendre);
+  const fem::FunctionSpace N2
+      = create_space(basix::element::family::N1E, 2,
+                     basix::element::lagrange_variant::legendre);
+
+  // Ghost rows are not finalized, so that only the values set by the
+  // owned cells are compared
+
+  // Discrete gradient
+  {
+    la::MatrixCSR<double> A0 = create_matrix(P1, N1);
+    fem::discrete_gradient<double>(P1, N1, A0.mat_set_values());
+    la::MatrixCSR<double> A1
+        = fem::create_discrete_gradient<double>(P1, N1, num_threads);
+    check_equal(A0, A1);
+  }
+
+  // Interpolation between Nédélec spaces
+  {
+    la::MatrixCSR<double> A0 = create_matrix(N1, N2);
+    fem::interpolation_matrix<double>(N1, N2, A0.mat_set_values());
+    la::MatrixCSR<double> A1
+        = fem::create_interpolation_matrix<double>(N1, N2, num_threads);
+    check_equal(A0, A1);
+  }
+
+  // Invalid spaces are reported on the calling thread
+  CHECK_THROWS_AS(fem::create_discrete_gradient<double>(N1, P1, num_threads),
+                  std::runtime_error);
+}
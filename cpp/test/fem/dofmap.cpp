@@ -0,0 +1,66 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for fem::DofMap construction
+
+#include <basix/finite-element.h>
+#include <catch2/catch.hpp>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/ElementDofLayout.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/graph/ordering.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Interface dofs numbered last", "[dofmap]")
+{
+  auto reorder = GENERATE(false, true);
+
+  auto mesh = std::make_shared<mesh::Mesh>(mesh::create_box(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+      mesh::CellType::tetrahedron, mesh::GhostMode::none));
+
+  const basix::FiniteElement e = basix::create_element(
+      basix::element::family::P, basix::cell::type::tetrahedron, 2,
+      basix::element::lagrange_variant::equispaced, false);
+  const fem::FiniteElement element(e, 1);
+  const fem::ElementDofLayout layout(1, e.entity_dofs(),
+                                     e.entity_closure_dofs(), {}, {});
+
+  std::function<std::vector<int>(const graph::AdjacencyList<std::int32_t>&)>
+      reorder_fn = nullptr;
+  if (reorder)
+    reorder_fn = graph::reorder_rcm;
+  const fem::DofMap dofmap = fem::create_dofmap(
+      mesh->comm(), layout, mesh->topology(), reorder_fn, element, true);
+
+  // The owned dofs that are ghosts on other processes (the interface
+  // dofs) fill the end of the owned range
+  std::vector<std::int32_t> shared = dofmap.index_map->shared_indices();
+  std::sort(shared.begin(), shared.end());
+  shared.erase(std::unique(shared.begin(), shared.end()), shared.end());
+  const std::int32_t size_local = dofmap.index_map->size_local();
+  std::vector<std::int32_t> last(shared.size());
+  std::iota(last.begin(), last.end(), size_local - (int)shared.size());
+  CHECK(shared == last);
+
+  // All owned dofs are referenced by the cells
+  std::vector<std::int8_t> marker(size_local, false);
+  for (std::int32_t dof : dofmap.list().array())
+  {
+    if (dof < size_local)
+      marker[dof] = true;
+  }
+  CHECK(std::all_of(marker.begin(), marker.end(), [](auto m) { return m; }));
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for fem::FiniteElement
+
+#include <basix/finite-element.h>
+#include <catch2/catch.hpp>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <random>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// All cell permutation signatures of a simplex cell: a reflection bit
+// and two rotation bits for each face, followed by a reflection bit for
+// each edge
+std::vector<std::uint32_t> cell_signatures(mesh::CellType cell)
+{
+  const int tdim = mesh::cell_dim(cell);
+  const int num_faces = tdim == 3 ? mesh::cell_num_entities(cell, 2) : 0;
+  const int num_edges = mesh::cell_num_entities(cell, 1);
+
+  std::vector<std::uint32_t> faces = {0};
+  for (int f = 0; f < num_faces; ++f)
+  {
+    std::vector<std::uint32_t> next;
+    for (std::uint32_t s : faces)
+      for (std::uint32_t ref = 0; ref < 2; ++ref)
+        for (std::uint32_t rots = 0; rots < 3; ++rots)
+          next.push_back(s | ((ref | rots << 1) << (3 * f)));
+    faces = std::move(next);
+  }
+
+  std::vector<std::uint32_t> signatures;
+  for (std::uint32_t s : faces)
+    for (std::uint32_t e = 0; e < (1u << num_edges); ++e)
+      signatures.push_back(s | e << (3 * num_faces));
+  return signatures;
+}
+} // namespace
+
+TEST_CASE("Precomputed DOF transformations", "[dof_transformation]")
+{
+  auto family = GENERATE(basix::element::family::N1E,
+                         basix::element::family::RT);
+  auto cell = GENERATE(mesh::CellType::triangle, mesh::CellType::tetrahedron);
+
+  const fem::FiniteElement element(
+      basix::create_element(family, mesh::cell_type_to_basix_type(cell), 2,
+                            basix::element::lagrange_variant::legendre,
+                            false),
+      1);
+  REQUIRE(element.needs_dof_transformations());
+
+  // The cell permutation info of a 'mesh' with one cell for each
+  // signature
+  const std::vector<std::uint32_t> cell_info = cell_signatures(cell);
+
+  const int ndofs = element.space_dimension();
+  const int bs = 2;
+  std::mt19937 engine;
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  std::vector<double> data0(ndofs * bs), data1(ndofs * bs);
+
+  // (inverse, transpose, to_transpose)
+  const std::vector<std::array<bool, 3>> cases
+      = {{false, false, false}, {true, true, false}, {false, false, true}};
+  for (auto [inverse, transpose, to_transpose] : cases)
+  {
+    auto apply0
+        = to_transpose
+              ? element.get_dof_transformation_to_transpose_function<double>(
+                  inverse, transpose)
+              : element.get_dof_transformation_function<double>(inverse,
+                                                                transpose);
+    auto apply1 = element.get_precomputed_dof_transformation_function<double>(
+        cell_info, inverse, transpose, to_transpose);
+    for (std::size_t c = 0; c < cell_info.size(); ++c)
+    {
+      std::generate(data0.begin(), data0.end(),
+                    [&]() { return distribution(engine); });
+      data1 = data0;
+      apply0(data0, cell_info, c, bs);
+      apply1(data1, cell_info, c, bs);
+      for (std::size_t i = 0; i < data0.size(); ++i)
+        CHECK(data1[i] == Approx(data0[i]).margin(1e-12));
+    }
+  }
+}
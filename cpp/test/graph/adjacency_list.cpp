@@ -0,0 +1,107 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for graph::AdjacencyList
+
+#include <catch2/catch.hpp>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <thread>
+#include <vector>
+
+using namespace dolfinx;
+
+TEMPLATE_TEST_CASE("Constant degree AdjacencyList", "[adjacency_list]",
+                   std::int32_t, std::int64_t)
+{
+  const std::vector<TestType> data = {0, 1, 2, 3, 4, 5};
+  const graph::AdjacencyList<TestType> a
+      = graph::regular_adjacency_list(std::vector<TestType>(data), 3);
+  const graph::AdjacencyList<TestType> b(std::vector<TestType>(data),
+                                         std::vector<std::int32_t>{0, 3, 6});
+
+  CHECK(a.num_nodes() == 2);
+  CHECK(a.degree() == 3);
+  CHECK(b.degree() == -1);
+  for (std::int32_t i = 0; i < a.num_nodes(); ++i)
+  {
+    CHECK(a.num_links(i) == 3);
+    auto links_a = a.links(i);
+    auto links_b = b.links(i);
+    CHECK(std::equal(links_a.begin(), links_a.end(), links_b.begin(),
+                     links_b.end()));
+  }
+
+  // Constant and variable degree storage of the same list
+  CHECK(a == b);
+  CHECK(b == a);
+  const graph::AdjacencyList<TestType> c(std::vector<TestType>(data),
+                                         std::vector<std::int32_t>{0, 2, 6});
+  CHECK(!(a == c));
+  CHECK(!(c == a));
+  CHECK(!(a == graph::regular_adjacency_list(std::vector<TestType>(data), 2)));
+
+  // Offsets computed concurrently
+  std::vector<const std::vector<std::int32_t>*> offsets(4);
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < offsets.size(); ++i)
+      threads.emplace_back([&, i]() { offsets[i] = &a.offsets(); });
+  }
+  for (auto o : offsets)
+    CHECK(*o == b.offsets());
+
+  // Copies are equal and compute their own offsets
+  graph::AdjacencyList<TestType> d(a);
+  CHECK(d == a);
+  CHECK(d.offsets() == b.offsets());
+  CHECK(&d.offsets() != &a.offsets());
+  d = b;
+  CHECK(d.degree() == -1);
+  CHECK(d.offsets() == b.offsets());
+
+  // Moved lists keep their (computed) offsets, and moved-from lists are
+  // empty
+  graph::AdjacencyList<TestType> e(a);
+  CHECK(e.offsets() == b.offsets());
+  graph::AdjacencyList<TestType> f(std::move(e));
+  CHECK(f == a);
+  CHECK(f.offsets() == b.offsets());
+  CHECK(e.num_nodes() == 0);
+  CHECK(e.offsets() == std::vector<std::int32_t>{0});
+  e = std::move(f);
+  CHECK(e == a);
+  CHECK(e.offsets() == b.offsets());
+  CHECK(f.num_nodes() == 0);
+  CHECK(f.offsets() == std::vector<std::int32_t>{0});
+}
+
+TEMPLATE_TEST_CASE("Degree zero AdjacencyList", "[adjacency_list]",
+                   std::int32_t, std::int64_t)
+{
+  const graph::AdjacencyList<TestType> a
+      = graph::regular_adjacency_list(std::vector<TestType>(), 0, 4);
+  CHECK(a.num_nodes() == 4);
+  CHECK(a.degree() == 0);
+  for (std::int32_t i = 0; i < a.num_nodes(); ++i)
+  {
+    CHECK(a.num_links(i) == 0);
+    CHECK(a.links(i).empty());
+  }
+  CHECK(a.offsets() == std::vector<std::int32_t>(5, 0));
+
+  const graph::AdjacencyList<TestType> b(std::vector<TestType>(),
+                                         std::vector<std::int32_t>(5, 0));
+  CHECK(a == b);
+  CHECK(b == a);
+
+  // Different number of nodes
+  const graph::AdjacencyList<TestType> c
+      = graph::regular_adjacency_list(std::vector<TestType>(), 0);
+  CHECK(c.num_nodes() == 0);
+  CHECK(!(a == c));
+
+  CHECK_THROWS(graph::regular_adjacency_list(std::vector<TestType>(3), 1, 2));
+}
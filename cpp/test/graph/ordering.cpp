@@ -0,0 +1,126 @@
+// Copyright (C) 2022 DOLFINx contributors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for graph re-ordering
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/ordering.h>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Graph of an n x n grid, with the nodes numbered in a scrambled
+// order, followed by an isolated node and a path of three nodes
+graph::AdjacencyList<std::int32_t> create_graph(int n)
+{
+  const int N = n * n;
+  std::vector<std::int32_t> p(N);
+  for (int i = 0; i < N; ++i)
+    p[i] = (i * 37) % N;
+
+  std::vector<std::vector<std::int32_t>> edges(N + 4);
+  auto add_edge = [&edges](std::int32_t a, std::int32_t b)
+  {
+    edges[a].push_back(b);
+    edges[b].push_back(a);
+  };
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      if (i + 1 < n)
+        add_edge(p[i * n + j], p[(i + 1) * n + j]);
+      if (j + 1 < n)
+        add_edge(p[i * n + j], p[i * n + j + 1]);
+    }
+  }
+  add_edge(N + 1, N + 3);
+  add_edge(N + 3, N + 2);
+
+  return graph::AdjacencyList<std::int32_t>(edges);
+}
+
+// Largest difference between the indices of connected nodes
+std::int32_t bandwidth(const graph::AdjacencyList<std::int32_t>& graph,
+                       const std::vector<std::int32_t>& map)
+{
+  std::int32_t bw = 0;
+  for (std::int32_t i = 0; i < graph.num_nodes(); ++i)
+    for (std::int32_t j : graph.links(i))
+      bw = std::max(bw, std::abs(map[i] - map[j]));
+  return bw;
+}
+} // namespace
+
+TEST_CASE("Reverse Cuthill-McKee re-ordering", "[graph_ordering]")
+{
+  const int n = 20;
+  const graph::AdjacencyList<std::int32_t> graph = create_graph(n);
+  const std::vector<std::int32_t> map = graph::reorder_rcm(graph);
+
+  // The map is a permutation
+  REQUIRE((int)map.size() == graph.num_nodes());
+  std::vector<std::int32_t> sorted(map);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::int32_t> range(map.size());
+  std::iota(range.begin(), range.end(), 0);
+  CHECK(sorted == range);
+
+  // The bandwidth is reduced to (about) the width of the grid
+  std::vector<std::int32_t> identity(range);
+  CHECK(bandwidth(graph, identity) > 10 * n);
+  CHECK(bandwidth(graph, map) <= n + 1);
+}
+
+TEST_CASE("Hilbert curve re-ordering", "[graph_ordering]")
+{
+  // n^gdim grid of points, with n a power of two, numbered in a
+  // scrambled order
+  for (int gdim : {2, 3})
+  {
+    const int n = 8;
+    const int N = gdim == 2 ? n * n : n * n * n;
+    const double h = 1.0 / (n - 1);
+    std::vector<double> x(N * gdim);
+    for (int i = 0; i < N; ++i)
+    {
+      const int p = (i * 37) % N;
+      x[p * gdim + 0] = h * (i % n);
+      x[p * gdim + 1] = h * ((i / n) % n);
+      if (gdim == 3)
+        x[p * gdim + 2] = h * (i / (n * n));
+    }
+
+    const std::vector<std::int32_t> map = graph::reorder_hilbert(x, gdim);
+
+    // The map is a permutation
+    REQUIRE((int)map.size() == N);
+    std::vector<std::int32_t> order(N, -1);
+    for (int i = 0; i < N; ++i)
+      order[map[i]] = i;
+    CHECK(std::find(order.begin(), order.end(), -1) == order.end());
+
+    // Consecutive points along the curve are grid neighbours
+    for (int k = 1; k < N; ++k)
+    {
+      double d = 0;
+      for (int j = 0; j < gdim; ++j)
+      {
+        d += std::abs(x[order[k] * gdim + j]
+                      - x[order[k - 1] * gdim + j]);
+      }
+      CHECK(d == Approx(h));
+    }
+  }
+
+  CHECK_THROWS(graph::reorder_hilbert(std::vector<double>(8), 4));
+}
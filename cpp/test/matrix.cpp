@@ -8,11 +8,21 @@
 
 #include "poisson.h"
 #include <catch2/catch.hpp>
+#include <cmath>
+#include <complex>
 #include <dolfinx.h>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/MatrixSELL.h>
+#include <dolfinx/la/amg.h>
+#include <dolfinx/la/matrix_ops.h>
+#include <dolfinx/la/petsc.h>
+#include <dolfinx/la/preconditioners.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/la/Vector.h>
+#include <dolfinx/la/solvers.h>
+#include <limits>
+#include <numeric>
 #include <xtensor/xio.hpp>
 #include <xtensor/xtensor.hpp>
 
@@ -102,6 +112,29 @@ void spmv(la::MatrixCSR<T>& A, la::Vector<T>& x, la::Vector<T>& y)
   spmv_impl<T>(values, off_diag_offset, row_end, cols, _x, _y);
 }
 
+/// Create an index map with n owned indices on each rank that ghosts
+/// the neighbouring indices (in a chain) owned by the previous and next
+/// ranks
+std::shared_ptr<common::IndexMap> create_chain_map(MPI_Comm comm,
+                                                   std::int32_t n)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  if (rank > 0)
+  {
+    ghosts.push_back(std::int64_t(rank) * n - 1);
+    owners.push_back(rank - 1);
+  }
+  if (rank < size - 1)
+  {
+    ghosts.push_back(std::int64_t(rank + 1) * n);
+    owners.push_back(rank + 1);
+  }
+  return std::make_shared<common::IndexMap>(comm, n, ghosts, owners);
+}
+
 void test_matrix_apply()
 {
   MPI_Comm comm = MPI_COMM_WORLD;
@@ -149,6 +182,106 @@ void test_matrix_apply()
 
   std::for_each(y.array().begin(), y.array().end(),
                 [](auto a) { REQUIRE(std::abs(a) < 1e-13); });
+
+  // Compare MatrixCSR::mult with the reference product for a
+  // non-constant vector
+  const std::int64_t offset = maps[1]->local_range()[0];
+  for (std::int32_t i = 0; i < maps[1]->size_local(); ++i)
+    x.mutable_array()[i] = std::sin(double(offset + i));
+  y.set(0.0);
+  spmv(A, x, y);
+  for (int num_threads : {1, 3})
+  {
+    la::Vector<double> z(maps[0], 1);
+    A.mult(x, z, num_threads);
+    for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+      REQUIRE(z.array()[i] == Approx(y.array()[i]).margin(1e-12));
+
+    la::MatrixSELL<double> S(A);
+    z.set(0.0);
+    S.mult(x, z, num_threads);
+    for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+      REQUIRE(z.array()[i] == Approx(y.array()[i]).margin(1e-12));
+  }
+}
+
+void test_sparsity_cache()
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  auto mesh = std::make_shared<mesh::Mesh>(
+      mesh::create_box(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+                       mesh::CellType::tetrahedron, mesh::GhostMode::none));
+  auto V = std::make_shared<fem::FunctionSpace>(
+      fem::create_functionspace(functionspace_form_poisson_a, "u", mesh));
+  auto kappa = std::make_shared<fem::Constant<double>>(2.0);
+  fem::Form<double> a0 = fem::create_form<double>(
+      *form_poisson_a, {V, V}, {}, {{"kappa", kappa}}, {});
+  fem::Form<double> a1 = fem::create_form<double>(
+      *form_poisson_a, {V, V}, {}, {{"kappa", kappa}}, {});
+
+  la::SparsityPattern sp = fem::create_sparsity_pattern(a0);
+  sp.assemble();
+
+  // Cached patterns are shared by forms with the same spaces and
+  // integration domains
+  fem::SparsityPatternCache cache;
+  std::shared_ptr<const la::SparsityPattern> sp0 = cache.get(a0);
+  CHECK(cache.get(a1) == sp0);
+  CHECK(cache.size() == 1);
+  CHECK(sp0->graph().array() == sp.graph().array());
+
+  // A form on another space (with a different DofMap) gets a new
+  // pattern, which is removed once the space is destroyed
+  {
+    auto V2 = std::make_shared<fem::FunctionSpace>(
+        fem::create_functionspace(functionspace_form_poisson_a, "u", mesh));
+    fem::Form<double> a2 = fem::create_form<double>(
+        *form_poisson_a, {V2, V2}, {}, {{"kappa", kappa}}, {});
+    std::shared_ptr<const la::SparsityPattern> sp2 = cache.get(a2);
+    CHECK(sp2 != sp0);
+    CHECK(cache.size() == 2);
+  }
+  CHECK(cache.get(a0) == sp0);
+  CHECK(cache.size() == 1);
+
+  // Patterns in use remain valid after the cache is cleared
+  cache.clear();
+  CHECK(cache.size() == 0);
+  CHECK(sp0->graph().array() == sp.graph().array());
+  CHECK(cache.get(a0) != sp0);
+}
+
+void test_matrix_sell_padding()
+{
+  // Rows of different lengths, including an empty row, in one chunk
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 4);
+  la::SparsityPattern p(MPI_COMM_SELF, {map, map}, {1, 1});
+  p.insert(std::vector{0}, std::vector{0, 1, 2, 3});
+  p.insert(std::vector{1}, std::vector{1});
+  p.insert(std::vector{3}, std::vector{1, 3});
+  p.assemble();
+  la::MatrixCSR<double> A(p);
+  std::iota(A.values().begin(), A.values().end(), 1.0);
+  A.finalize();
+  const la::MatrixSELL<double> S(A);
+
+  // Only row 0 uses the non-finite entries of x, so the other rows
+  // must be finite
+  la::Vector<double> x(map, 1), y(map, 1), z(map, 1);
+  x.mutable_array()[0] = std::numeric_limits<double>::infinity();
+  x.mutable_array()[1] = 1.0;
+  x.mutable_array()[2] = std::numeric_limits<double>::quiet_NaN();
+  x.mutable_array()[3] = 2.0;
+  z.set(std::numeric_limits<double>::quiet_NaN());
+  A.mult(x, y);
+  S.mult(x, z);
+  CHECK(!std::isfinite(z.array()[0]));
+  for (int i = 1; i < 4; ++i)
+  {
+    CHECK(std::isfinite(z.array()[i]));
+    CHECK(z.array()[i] == y.array()[i]);
+  }
+  CHECK(z.array()[2] == 0.0);
 }
 
 void test_matrix()
@@ -178,10 +311,944 @@ void test_matrix()
   CHECK((Adense != Aref));
 }
 
+void test_sparsity_two_pass()
+{
+  auto map0 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 8);
+  auto insert = [](la::SparsityPattern& p)
+  {
+    p.insert(std::vector{0, 3}, std::vector{3, 0});
+    p.insert(std::vector{3, 7}, std::vector{7, 3, 0});
+    p.insert_diagonal(std::vector{5});
+  };
+
+  la::SparsityPattern p0(MPI_COMM_SELF, {map0, map0}, {1, 1});
+  insert(p0);
+  p0.assemble();
+
+  // Two-pass build, with repeated insertions in the second pass
+  la::SparsityPattern p1(MPI_COMM_SELF, {map0, map0}, {1, 1});
+  p1.count_begin();
+  insert(p1);
+  p1.count_end();
+  insert(p1);
+  p1.assemble();
+  CHECK(p1.graph().array() == p0.graph().array());
+  CHECK(p1.graph().offsets() == p0.graph().offsets());
+
+  // Insertions in the two passes must match
+  la::SparsityPattern p2(MPI_COMM_SELF, {map0, map0}, {1, 1});
+  p2.count_begin();
+  insert(p2);
+  p2.count_end();
+  CHECK_THROWS(p2.assemble());
+}
+
+void test_sparsity_form_diagonal()
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  auto mesh = std::make_shared<mesh::Mesh>(
+      mesh::create_box(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+                       mesh::CellType::tetrahedron, mesh::GhostMode::none));
+  auto V = std::make_shared<fem::FunctionSpace>(
+      fem::create_functionspace(functionspace_form_poisson_a, "u", mesh));
+  auto kappa = std::make_shared<fem::Constant<double>>(2.0);
+  fem::Form<double> a = fem::create_form<double>(
+      *form_poisson_a, {V, V}, {}, {{"kappa", kappa}}, {});
+
+  // Entries can be inserted after the pattern is created from a form
+  std::vector<std::int32_t> rows(V->dofmap()->index_map->size_local());
+  std::iota(rows.begin(), rows.end(), 0);
+  la::SparsityPattern sp0 = fem::create_sparsity_pattern(a);
+  sp0.insert_diagonal(rows);
+  sp0.assemble();
+  for (std::int32_t row : rows)
+  {
+    auto cols = sp0.graph().links(row);
+    CHECK(std::find(cols.begin(), cols.end(), row) != cols.end());
+  }
+
+  // The opt-in two-pass build gives the same pattern
+  la::SparsityPattern sp1 = fem::create_sparsity_pattern(a, true, 2);
+  sp1.assemble();
+  CHECK(sp1.graph().array() == sp0.graph().array());
+}
+
+void test_matrix_petsc_wrapper()
+{
+  // Non-symmetric tridiagonal matrix over a chain, with the couplings
+  // to the neighbouring ranks in ghost columns
+  const std::int32_t n = 10;
+  std::shared_ptr<common::IndexMap> map = create_chain_map(MPI_COMM_WORLD, n);
+  const std::int64_t offset = map->local_range()[0];
+  const std::int64_t N = map->size_global();
+  std::vector<std::int64_t> global(n + map->num_ghosts());
+  std::iota(global.begin(), std::next(global.begin(), n), offset);
+  std::copy(map->ghosts().begin(), map->ghosts().end(),
+            std::next(global.begin(), n));
+  std::vector<std::int32_t> local;
+  auto links = [&](std::int32_t i)
+  {
+    local.clear();
+    const std::int64_t gi = offset + i;
+    for (std::int32_t j = 0; j < (std::int32_t)global.size(); ++j)
+    {
+      if (std::abs(global[j] - gi) <= 1)
+        local.push_back(j);
+    }
+    return std::span<const std::int32_t>(local);
+  };
+
+  la::SparsityPattern p(MPI_COMM_WORLD, {map, map}, {1, 1});
+  for (std::int32_t i = 0; i < n; ++i)
+    p.insert(std::vector{i}, links(i));
+  p.assemble();
+
+  la::MatrixCSR<PetscScalar> A(p);
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    std::span<const std::int32_t> cols = links(i);
+    std::vector<PetscScalar> Ae;
+    for (std::int32_t j : cols)
+    {
+      Ae.push_back(global[j] == offset + i ? 2.0
+                                           : -1.0 - 0.01 * (offset + i));
+    }
+    A.set(Ae, std::vector{i}, cols);
+  }
+  A.finalize();
+
+  la::Vector<PetscScalar> x(map, 1), y0(map, 1), y1(map, 1);
+  for (std::int32_t i = 0; i < n; ++i)
+    x.mutable_array()[i] = std::sin(double(offset + i) / N);
+  Vec _x = la::petsc::create_vector_wrap(x);
+  Vec _y = la::petsc::create_vector_wrap(y1);
+
+  // Compare MatMult with MatrixCSR::mult
+  auto check = [&](const la::petsc::MatrixCSRWrapper<>& W)
+  {
+    y0.set(0.0);
+    A.mult(x, y0);
+    y1.set(0.0);
+    MatMult(W.mat(), _x, _y);
+    for (std::int32_t i = 0; i < n; ++i)
+      CHECK(std::abs(y1.array()[i] - y0.array()[i]) < 1.0e-12);
+  };
+
+  la::petsc::MatrixCSRWrapper W(A);
+  check(W);
+
+  // Changed values are seen by the Mat after an update
+  std::vector<PetscScalar>& values = A.values();
+  for (std::size_t k = 0; k < values.size(); ++k)
+    values[k] *= 1.0 + 0.1 * k;
+  W.update(A);
+  check(W);
+
+  VecDestroy(&_x);
+  VecDestroy(&_y);
+}
+
+void test_matrix_blocked()
+{
+  auto map0 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 4);
+  la::SparsityPattern p(MPI_COMM_SELF, {map0, map0}, {2, 3});
+  p.insert(std::vector{0, 2}, std::vector{0, 2});
+  p.insert(std::vector{3}, std::vector{1});
+  p.assemble();
+
+  // Add a 4 x 6 block to block rows {0, 2} and block columns {0, 2}
+  la::MatrixCSR<double> A(p);
+  std::vector<double> Ae(24);
+  std::iota(Ae.begin(), Ae.end(), 1.0);
+  A.add(Ae, std::vector{0, 2}, std::vector{0, 2});
+  A.set(std::vector<double>(6, -1.0), std::vector{3}, std::vector{1});
+
+  xt::xtensor<double, 2> Aref = xt::zeros<double>({8, 12});
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 2; ++j)
+      for (int k0 = 0; k0 < 2; ++k0)
+        for (int k1 = 0; k1 < 3; ++k1)
+          Aref(4 * i + k0, 6 * j + k1) = Ae[(2 * i + k0) * 6 + 3 * j + k1];
+  for (int k0 = 0; k0 < 2; ++k0)
+    for (int k1 = 0; k1 < 3; ++k1)
+      Aref(6 + k0, 3 + k1) = -1.0;
+
+  const std::vector Adense0 = A.to_dense();
+  auto Adense = xt::adapt(Adense0, {8, 12});
+  CHECK((Adense == Aref));
+
+  // Block matrix-vector product
+  la::Vector<double> x(map0, 3);
+  la::Vector<double> y(map0, 2);
+  std::iota(x.mutable_array().begin(), x.mutable_array().end(), 0.0);
+  A.mult(x, y);
+  for (int i = 0; i < 8; ++i)
+  {
+    double yi = 0;
+    for (int j = 0; j < 12; ++j)
+      yi += Aref(i, j) * x.array()[j];
+    CHECK(y.array()[i] == Approx(yi));
+  }
+
+  // Block matrix-multivector product, with columns (x, 2x)
+  la::MultiVector<double> X(map0, 3, 2);
+  la::MultiVector<double> Y(map0, 2, 2);
+  X.set_column(0, x);
+  std::transform(x.array().begin(), x.array().end(),
+                 x.mutable_array().begin(), [](auto v) { return 2 * v; });
+  X.set_column(1, x);
+  A.mult(X, Y);
+  for (int i = 0; i < 8; ++i)
+  {
+    CHECK(Y.array()[2 * i] == Approx(y.array()[i]));
+    CHECK(Y.array()[2 * i + 1] == Approx(2 * y.array()[i]));
+  }
+}
+
+void test_matrix_blocked_distributed()
+{
+  // Block 'elements' (k, k + 1) over a chain of block rows, with the
+  // element that couples neighbouring ranks assembled into a ghost row
+  // by the rank that owns k
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const std::int32_t n = 5;
+  const std::array<int, 2> bs = {2, 3};
+  std::shared_ptr<common::IndexMap> map = create_chain_map(comm, n);
+  const std::int64_t offset = map->local_range()[0];
+  const std::int64_t N = map->size_global();
+  std::vector<std::int64_t> global(n + map->num_ghosts());
+  std::iota(global.begin(), std::next(global.begin(), n), offset);
+  std::copy(map->ghosts().begin(), map->ghosts().end(),
+            std::next(global.begin(), n));
+
+  // Local index of global index g, assuming that g is on this rank
+  auto local = [&global](std::int64_t g) -> std::int32_t
+  {
+    return std::distance(global.begin(),
+                         std::find(global.begin(), global.end(), g));
+  };
+
+  // Entry (k0, k1) of block (a, b) of each element matrix
+  auto Ae = [](int a, int b, int k0, int k1)
+  { return 1.0 + a + 2.0 * b + 0.1 * k0 + 0.01 * k1; };
+  std::vector<double> element(4 * bs[0] * bs[1]);
+  for (int a = 0; a < 2; ++a)
+    for (int b = 0; b < 2; ++b)
+      for (int k0 = 0; k0 < bs[0]; ++k0)
+        for (int k1 = 0; k1 < bs[1]; ++k1)
+          element[(a * bs[0] + k0) * 2 * bs[1] + b * bs[1] + k1]
+              = Ae(a, b, k0, k1);
+
+  std::vector<std::vector<std::int32_t>> elements;
+  for (std::int64_t k = offset; k < offset + n and k + 1 < N; ++k)
+    elements.push_back({local(k), local(k + 1)});
+
+  la::SparsityPattern p(comm, {map, map}, {bs[0], bs[1]});
+  for (auto& e : elements)
+    p.insert(e, e);
+  p.assemble();
+  la::MatrixCSR<double> A(p);
+  for (auto& e : elements)
+    A.add(element, e, e);
+  A.finalize();
+  REQUIRE(A.num_owned_rows() == n);
+
+  // Block (I, J) of the global matrix
+  auto Aref = [&Ae, N](std::int64_t I, std::int64_t J, int k0, int k1)
+  {
+    double v = 0;
+    if (J == I and I > 0)
+      v += Ae(1, 1, k0, k1);
+    if (J == I and I + 1 < N)
+      v += Ae(0, 0, k0, k1);
+    if (J == I + 1)
+      v += Ae(0, 1, k0, k1);
+    if (J == I - 1)
+      v += Ae(1, 0, k0, k1);
+    return v;
+  };
+
+  const std::vector Adense = A.to_dense();
+  const std::size_t ncols = global.size() * bs[1];
+  for (std::int32_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < global.size(); ++j)
+      for (int k0 = 0; k0 < bs[0]; ++k0)
+        for (int k1 = 0; k1 < bs[1]; ++k1)
+        {
+          CHECK(Adense[(i * bs[0] + k0) * ncols + j * bs[1] + k1]
+                == Approx(Aref(offset + i, global[j], k0, k1)));
+        }
+
+  // Block matrix-vector product, with ghost values of x from the
+  // neighbouring ranks
+  la::Vector<double> x(map, bs[1]);
+  la::Vector<double> y(map, bs[0]);
+  for (std::int32_t i = 0; i < n * bs[1]; ++i)
+    x.mutable_array()[i] = std::sin(double(offset * bs[1] + i));
+  A.mult(x, y);
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    const std::int64_t I = offset + i;
+    for (int k0 = 0; k0 < bs[0]; ++k0)
+    {
+      double yi = 0;
+      for (std::int64_t J = std::max<std::int64_t>(I - 1, 0);
+           J <= std::min(I + 1, N - 1); ++J)
+      {
+        for (int k1 = 0; k1 < bs[1]; ++k1)
+          yi += Aref(I, J, k0, k1) * std::sin(double(J * bs[1] + k1));
+      }
+      CHECK(y.array()[i * bs[0] + k0] == Approx(yi));
+    }
+  }
+}
+
+void test_matrix_product()
+{
+  // A (4 x 3, block size (1, 2)) and B (3 x 2, block size (2, 1))
+  auto map0 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 4);
+  auto map1 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 3);
+  auto map2 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 2);
+  la::SparsityPattern pA(MPI_COMM_SELF, {map0, map1}, {1, 2});
+  pA.insert(std::vector{0, 1}, std::vector{0, 2});
+  pA.insert(std::vector{3}, std::vector{1});
+  pA.assemble();
+  la::SparsityPattern pB(MPI_COMM_SELF, {map1, map2}, {2, 1});
+  pB.insert(std::vector{0, 1}, std::vector{1});
+  pB.insert(std::vector{2}, std::vector{0, 1});
+  pB.assemble();
+
+  la::MatrixCSR<double> A(pA);
+  std::iota(A.values().begin(), A.values().end(), 1.0);
+  la::MatrixCSR<double> B(pB);
+  std::iota(B.values().begin(), B.values().end(), -3.0);
+
+  const std::vector A0 = A.to_dense();
+  const std::vector B0 = B.to_dense();
+  auto Ad = xt::adapt(A0, {4, 6});
+  auto Bd = xt::adapt(B0, {6, 2});
+
+  la::MatrixCSR<double> C = la::multiply(A, B);
+  CHECK(C.block_size() == std::array{1, 1});
+  const std::vector C0 = C.to_dense();
+  auto Cd = xt::adapt(C0, {4, 2});
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      double cij = 0;
+      for (int k = 0; k < 6; ++k)
+        cij += Ad(i, k) * Bd(k, j);
+      CHECK(Cd(i, j) == Approx(cij));
+    }
+  }
+
+  la::MatrixCSR<double> AT = la::transpose(A);
+  CHECK(AT.block_size() == std::array{2, 1});
+  const std::vector AT0 = AT.to_dense();
+  auto ATd = xt::adapt(AT0, {6, 4});
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 6; ++j)
+      CHECK(ATd(j, i) == Ad(i, j));
+
+  // Re-use the symbolic phase with new values
+  la::MatrixProduct<double> product(A, B);
+  la::MatrixTranspose<double> transpose(A);
+  for (auto& a : A.values())
+    a *= 2.0;
+  for (auto& b : B.values())
+    b *= -0.5;
+  product.compute(A, B);
+  transpose.compute(A);
+  const std::vector C1 = product.matrix().to_dense();
+  for (std::size_t i = 0; i < C0.size(); ++i)
+    CHECK(C1[i] == Approx(-C0[i]));
+  const std::vector AT1 = transpose.matrix().to_dense();
+  for (std::size_t i = 0; i < AT0.size(); ++i)
+    CHECK(AT1[i] == 2.0 * AT0[i]);
+}
+
+void test_matrix_product_distributed()
+{
+  // Block tridiagonal matrices over a chain of block rows, so that
+  // products and transposes need rows and entries from the
+  // neighbouring ranks
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const std::int32_t n = 4;
+  std::shared_ptr<common::IndexMap> map = create_chain_map(comm, n);
+  const std::int64_t offset = map->local_range()[0];
+  const std::int64_t N = map->size_global();
+  const std::vector<std::int64_t> global = map->global_indices();
+
+  // Entry (i, j) (global scalar indices) of a block tridiagonal matrix
+  // with block size bs and values f
+  auto entry = [](auto f, std::array<int, 2> bs, std::int64_t i,
+                  std::int64_t j)
+  { return std::abs(i / bs[0] - j / bs[1]) <= 1 ? f(i, j) : 0.0; };
+
+  auto create = [&](auto f, std::array<int, 2> bs)
+  {
+    std::vector<std::vector<std::int32_t>> links(n);
+    for (std::int32_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < global.size(); ++j)
+        if (std::abs(global[j] - (offset + i)) <= 1)
+          links[i].push_back(j);
+
+    la::SparsityPattern p(comm, {map, map}, bs);
+    for (std::int32_t i = 0; i < n; ++i)
+      p.insert(std::vector{i}, links[i]);
+    p.assemble();
+    la::MatrixCSR<double> A(p);
+    for (std::int32_t i = 0; i < n; ++i)
+    {
+      for (std::int32_t j : links[i])
+      {
+        std::vector<double> Ae;
+        for (int k0 = 0; k0 < bs[0]; ++k0)
+          for (int k1 = 0; k1 < bs[1]; ++k1)
+            Ae.push_back(f((offset + i) * bs[0] + k0, global[j] * bs[1] + k1));
+        A.set(Ae, std::vector{i}, std::vector{j});
+      }
+    }
+    A.finalize();
+    return A;
+  };
+
+  // Owned rows of a matrix as dense rows with global columns
+  auto dense_rows = [](const la::MatrixCSR<double>& A)
+  {
+    const std::array<int, 2> bs = A.block_size();
+    const std::vector<std::int64_t> cols = A.index_maps()[1]->global_indices();
+    const std::size_t ncols = A.index_maps()[1]->size_global() * bs[1];
+    const std::size_t ncols_local = cols.size() * bs[1];
+    const std::vector<double> A0 = A.to_dense();
+    std::vector<double> rows(A.num_owned_rows() * bs[0] * ncols, 0);
+    for (std::int32_t r = 0; r < A.num_owned_rows() * bs[0]; ++r)
+      for (std::size_t j = 0; j < cols.size(); ++j)
+        for (int k = 0; k < bs[1]; ++k)
+          rows[r * ncols + cols[j] * bs[1] + k]
+              = A0[r * ncols_local + j * bs[1] + k];
+    return rows;
+  };
+
+  auto fA = [](std::int64_t i, std::int64_t j) { return 1.0 + i + 0.5 * j; };
+  auto fB = [](std::int64_t i, std::int64_t j)
+  { return 2.0 - 0.1 * i + 0.3 * j; };
+  const std::array bsA = {1, 2}, bsB = {2, 1};
+  la::MatrixCSR<double> A = create(fA, bsA);
+  const la::MatrixCSR<double> B = create(fB, bsB);
+
+  // Product
+  la::MatrixProduct<double> product(A, B);
+  product.compute(A, B);
+  const std::vector C0 = dense_rows(product.matrix());
+  REQUIRE(C0.size() == std::size_t(n * N));
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    for (std::int64_t j = 0; j < N; ++j)
+    {
+      double cij = 0;
+      for (std::int64_t k = 0; k < 2 * N; ++k)
+        cij += entry(fA, bsA, offset + i, k) * entry(fB, bsB, k, j);
+      CHECK(C0[i * N + j] == Approx(cij));
+    }
+  }
+
+  // Transpose
+  const std::vector AT0 = dense_rows(la::transpose(A));
+  REQUIRE(AT0.size() == std::size_t(2 * n * N));
+  for (std::int32_t i = 0; i < 2 * n; ++i)
+    for (std::int64_t j = 0; j < N; ++j)
+      CHECK(AT0[i * N + j] == entry(fA, bsA, j, 2 * offset + i));
+
+  // Re-use the symbolic phase with new values
+  for (auto& a : A.values())
+    a *= 2.0;
+  product.compute(A, B);
+  const std::vector C1 = dense_rows(product.matrix());
+  for (std::size_t i = 0; i < C0.size(); ++i)
+    CHECK(C1[i] == Approx(2.0 * C0[i]));
+}
+
+// Shifted 1D Laplacian (Hermitian positive definite), assembled from
+// 2 x 2 element matrices. For complex T, the off-diagonal entries are
+// complex.
+template <typename T>
+la::MatrixCSR<T>
+create_laplacian_1d(std::shared_ptr<const common::IndexMap> map)
+{
+  const int n = map->size_local();
+  la::SparsityPattern p(MPI_COMM_SELF, {map, map}, {1, 1});
+  for (int i = 0; i < n - 1; ++i)
+    p.insert(std::vector{i, i + 1}, std::vector{i, i + 1});
+  p.assemble();
+
+  T a = -1.0;
+  if constexpr (!std::is_floating_point_v<T>)
+    a = T(-1.0, 0.5);
+  la::MatrixCSR<T> A(p);
+  for (int i = 0; i < n - 1; ++i)
+  {
+    A.add(std::vector<T>{1.2, a, la::impl::conj(a), 1.2},
+          std::vector{i, i + 1}, std::vector{i, i + 1});
+  }
+  A.finalize();
+  return A;
+}
+
+// Right-hand side for the 1D Laplacian
+template <typename T>
+la::Vector<T> create_rhs_1d(std::shared_ptr<const common::IndexMap> map)
+{
+  la::Vector<T> b(map, 1);
+  for (int i = 0; i < map->size_local(); ++i)
+  {
+    b.mutable_array()[i] = std::sin(double(i));
+    if constexpr (!std::is_floating_point_v<T>)
+      b.mutable_array()[i] += T(0, std::cos(double(i)));
+  }
+  return b;
+}
+
+// Check that || b - A x || is small
+template <typename T>
+void check_solution(const la::MatrixCSR<T>& A, la::Vector<T>& x,
+                    const la::Vector<T>& b)
+{
+  la::Vector<T> r(b.map(), b.bs());
+  A.mult(x, r);
+  for (std::size_t i = 0; i < r.array().size(); ++i)
+    REQUIRE(std::abs(r.array()[i] - b.array()[i]) < 1e-8);
+}
+
+// Diagonal preconditioner for the 1D Laplacian
+template <typename T>
+void jacobi_1d(la::Vector<T>& x, la::Vector<T>& y)
+{
+  std::transform(x.array().begin(), x.array().end(),
+                 y.mutable_array().begin(), [](auto v) { return v / 2.4; });
+}
+
+template <typename T>
+void test_solver_cg()
+{
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<T> A = create_laplacian_1d<T>(map);
+  const la::Vector<T> b = create_rhs_1d<T>(map);
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+
+  la::Vector<T> x(map, 1);
+  la::solvers::CG<la::Vector<T>> cg(b, 1e-12);
+  CHECK(cg.solve(op, x, b, jacobi_1d<T>) < cg.max_it);
+  check_solution(A, x, b);
+}
+
+template <typename T>
+void test_solver_pipelined_cg()
+{
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<T> A = create_laplacian_1d<T>(map);
+  const la::Vector<T> b = create_rhs_1d<T>(map);
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+
+  la::Vector<T> x(map, 1);
+  la::solvers::PipelinedCG<la::Vector<T>> cg(b, 1e-12);
+  CHECK(cg.solve(op, x, b, jacobi_1d<T>) < cg.max_it);
+  check_solution(A, x, b);
+}
+
+template <typename T>
+void test_solver_fgmres()
+{
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<T> A = create_laplacian_1d<T>(map);
+  const la::Vector<T> b = create_rhs_1d<T>(map);
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+
+  la::Vector<T> x(map, 1);
+  la::solvers::FGMRES<la::Vector<T>> gmres(b, 20, 1e-12);
+  CHECK(gmres.solve(op, x, b, jacobi_1d<T>) < gmres.max_it);
+  check_solution(A, x, b);
+}
+
+template <typename T>
+void test_solver_bicgstab()
+{
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<T> A = create_laplacian_1d<T>(map);
+  const la::Vector<T> b = create_rhs_1d<T>(map);
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+
+  la::Vector<T> x(map, 1);
+  la::solvers::BiCGStab<la::Vector<T>> bicgstab(b, 1e-12);
+  CHECK(bicgstab.solve(op, x, b) < bicgstab.max_it);
+  check_solution(A, x, b);
+}
+
+template <typename T>
+void test_solver_minres()
+{
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<T> A = create_laplacian_1d<T>(map);
+  const la::Vector<T> b = create_rhs_1d<T>(map);
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+
+  la::Vector<T> x(map, 1);
+  la::solvers::MINRES<la::Vector<T>> minres(b, 1e-12);
+  CHECK(minres.solve(op, x, b, jacobi_1d<T>) < minres.max_it);
+  check_solution(A, x, b);
+}
+
+void test_preconditioners()
+{
+  using V = la::Vector<double>;
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<double> A = create_laplacian_1d<double>(map);
+  const V b = create_rhs_1d<double>(map);
+  auto op = [&A](V& x, V& y) { A.mult(x, y); };
+
+  // || b - A x ||
+  auto residual = [&](V& x)
+  {
+    V r(map, 1);
+    A.mult(x, r);
+    for (std::size_t i = 0; i < r.array().size(); ++i)
+      r.mutable_array()[i] = b.array()[i] - r.array()[i];
+    return la::norm(r);
+  };
+
+  // Native preconditioners, with serial and threaded application
+  V x(map, 1);
+  la::solvers::CG<V> cg(b, 1e-12);
+  la::solvers::FGMRES<V> gmres(b, 20, 1e-12);
+  for (int num_threads : {1, 3})
+  {
+    la::preconditioners::Jacobi<double> pc_jacobi(A, 1.0, num_threads);
+    x.set(0.0);
+    CHECK(cg.solve(op, x, b, pc_jacobi) < cg.max_it);
+    check_solution(A, x, b);
+
+    la::preconditioners::BlockJacobi<double> pc_bjacobi(A, 1.0, num_threads);
+    x.set(0.0);
+    CHECK(cg.solve(op, x, b, pc_bjacobi) < cg.max_it);
+    check_solution(A, x, b);
+
+    la::preconditioners::Chebyshev<double> pc_cheb(A, 3, 30.0, 10,
+                                                   num_threads);
+    x.set(0.0);
+    CHECK(cg.solve(op, x, b, pc_cheb) < cg.max_it);
+    check_solution(A, x, b);
+
+    // ILU(0) is exact for a tridiagonal matrix
+    la::preconditioners::ILU0<double> pc_ilu(A, num_threads);
+    x.set(0.0);
+    CHECK(gmres.solve(op, x, b, pc_ilu) <= 1);
+    check_solution(A, x, b);
+
+    // Further smoothing steps reduce the residual
+    x.set(0.0);
+    pc_cheb.smooth(b, x, 1);
+    const double r1 = residual(x);
+    pc_cheb.smooth(b, x, 3);
+    CHECK(residual(x) < r1);
+  }
+}
+
+void test_preconditioners_blocked()
+{
+  // Block tridiagonal matrices (block size 2) with dense, non-symmetric
+  // diagonal blocks, and off-diagonal blocks c I
+  using V = la::Vector<double>;
+  const int n = 50;
+  const int bs = 2;
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, n);
+  la::SparsityPattern pb(MPI_COMM_SELF, {map, map}, {bs, bs});
+  for (int i = 0; i < n - 1; ++i)
+    pb.insert(std::vector{i, i + 1}, std::vector{i, i + 1});
+  pb.assemble();
+  auto create_blocked = [&pb, n](double c)
+  {
+    la::MatrixCSR<double> A(pb);
+    for (int i = 0; i < n; ++i)
+    {
+      A.set(std::vector{2.6, 0.5, 0.5 + 0.01 * i, 2.6}, std::vector{i},
+            std::vector{i});
+    }
+    for (int i = 0; i < n - 1; ++i)
+    {
+      A.set(std::vector{c, 0.0, 0.0, c}, std::vector{i}, std::vector{i + 1});
+      A.set(std::vector{c, 0.0, 0.0, c}, std::vector{i + 1}, std::vector{i});
+    }
+    A.finalize();
+    return A;
+  };
+
+  V b(map, bs), x(map, bs);
+  for (int i = 0; i < bs * n; ++i)
+    b.mutable_array()[i] = std::sin(double(i));
+  la::solvers::FGMRES<V> gmres(b, 20, 1e-12);
+  for (double c : {0.0, -1.0})
+  {
+    const la::MatrixCSR<double> A = create_blocked(c);
+    auto op = [&A](V& x, V& y) { A.mult(x, y); };
+    for (int num_threads : {1, 3})
+    {
+      // Block-Jacobi is exact for a block diagonal matrix
+      if (c == 0.0)
+      {
+        la::preconditioners::BlockJacobi<double> pc_bjacobi(A, 1.0,
+                                                            num_threads);
+        x.set(0.0);
+        CHECK(gmres.solve(op, x, b, pc_bjacobi) <= 1);
+        check_solution(A, x, b);
+      }
+
+      // Block ILU(0) is exact for a block tridiagonal matrix
+      la::preconditioners::ILU0<double> pc_ilu(A, num_threads);
+      x.set(0.0);
+      CHECK(gmres.solve(op, x, b, pc_ilu) <= 1);
+      check_solution(A, x, b);
+    }
+  }
+}
+
+void test_solver_amg()
+{
+  using V = la::Vector<double>;
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 50);
+  const la::MatrixCSR<double> A = create_laplacian_1d<double>(map);
+  const V b = create_rhs_1d<double>(map);
+  auto op = [&A](V& x, V& y) { A.mult(x, y); };
+
+  // Algebraic multigrid preconditioner with more than one level
+  la::amg::Parameters params;
+  params.coarse_size = 10;
+  la::amg::SmoothedAggregation<double> amg(A, {}, params);
+  CHECK(amg.num_levels() > 1);
+  V x(map, 1);
+  la::solvers::CG<V> cg(b, 1e-12);
+  CHECK(cg.solve(op, x, b, amg) < 20);
+  check_solution(A, x, b);
+
+  params.smoother = la::amg::Smoother::ilu;
+  la::amg::SmoothedAggregation<double> amg_ilu(A, {}, params);
+  x.set(0.0);
+  la::solvers::FGMRES<V> gmres(b, 20, 1e-12);
+  CHECK(gmres.solve(op, x, b, amg_ilu) < 20);
+  check_solution(A, x, b);
+}
+
+void test_matrix_amg_distributed()
+{
+  // Shifted 1D Laplacian assembled from elements (k, k + 1) over a
+  // chain of rows, with ghost rows and columns on each rank
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const std::int32_t n = 40;
+  std::shared_ptr<common::IndexMap> map = create_chain_map(comm, n);
+  const std::int64_t offset = map->local_range()[0];
+  const std::int64_t N = map->size_global();
+  std::vector<std::int64_t> global(n + map->num_ghosts());
+  std::iota(global.begin(), std::next(global.begin(), n), offset);
+  std::copy(map->ghosts().begin(), map->ghosts().end(),
+            std::next(global.begin(), n));
+  auto local = [&global](std::int64_t g) -> std::int32_t
+  {
+    return std::distance(global.begin(),
+                         std::find(global.begin(), global.end(), g));
+  };
+
+  std::vector<std::vector<std::int32_t>> elements;
+  for (std::int64_t k = offset; k < offset + n and k + 1 < N; ++k)
+    elements.push_back({local(k), local(k + 1)});
+
+  la::SparsityPattern p(comm, {map, map}, {1, 1});
+  for (auto& e : elements)
+    p.insert(e, e);
+  p.assemble();
+  la::MatrixCSR<double> A(p);
+  for (auto& e : elements)
+    A.add(std::vector{1.05, -1.0, -1.0, 1.05}, e, e);
+  A.finalize();
+
+  using V = la::Vector<double>;
+  auto op = [&A](V& x, V& y) { A.mult(x, y); };
+  V b(map, 1);
+  for (std::int32_t i = 0; i < n; ++i)
+    b.mutable_array()[i] = std::sin(double(offset + i));
+
+  // Check that || b - A x || is small on the owned rows
+  auto check = [&](V& x)
+  {
+    V r(map, 1);
+    A.mult(x, r);
+    for (std::int32_t i = 0; i < n; ++i)
+      REQUIRE(r.array()[i] == Approx(b.array()[i]).margin(1e-8));
+  };
+
+  la::amg::Parameters params;
+  params.coarse_size = 10;
+  for (auto smoother : {la::amg::Smoother::chebyshev, la::amg::Smoother::jacobi,
+                        la::amg::Smoother::block_jacobi})
+  {
+    params.smoother = smoother;
+    la::amg::SmoothedAggregation<double> amg(A, {}, params);
+    CHECK(amg.num_levels() > 1);
+    V x(map, 1);
+    la::solvers::CG<V> cg(b, 1e-12);
+    CHECK(cg.solve(op, x, b, amg) < 25);
+    check(x);
+  }
+
+  // ILU(0) smoothing on the owned block is not symmetric
+  params.smoother = la::amg::Smoother::ilu;
+  la::amg::SmoothedAggregation<double> amg(A, {}, params);
+  V x(map, 1);
+  la::solvers::FGMRES<V> gmres(b, 20, 1e-12);
+  CHECK(gmres.solve(op, x, b, amg) < 25);
+  check(x);
+}
+
+void test_matrix_amg_nullspace()
+{
+  // Shifted stiffness matrix of a 2D lattice of bars (horizontal,
+  // vertical and diagonal) with two displacement components per node
+  // (bs = 2). The rigid body modes (two translations and a rotation)
+  // are the near nullspace (k = 3). Each rank owns a strip of columns
+  // of nodes, with one column of ghosts on each side.
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  const std::int64_t nx = 8, ny = 8;
+  const std::int64_t x0 = rank * nx, x1 = x0 + nx;
+  auto node = [ny](std::int64_t ix, std::int64_t iy) { return ix * ny + iy; };
+
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  for (int r : {rank - 1, rank + 1})
+  {
+    if (r >= 0 and r < size)
+    {
+      const std::int64_t ix = r < rank ? x0 - 1 : x1;
+      for (std::int64_t iy = 0; iy < ny; ++iy)
+      {
+        ghosts.push_back(node(ix, iy));
+        owners.push_back(r);
+      }
+    }
+  }
+  auto map = std::make_shared<common::IndexMap>(comm, nx * ny, ghosts, owners);
+  auto local = [&map](std::int64_t g)
+  {
+    std::int32_t l = -1;
+    map->global_to_local(std::span(&g, 1), std::span(&l, 1));
+    return l;
+  };
+
+  // Bars (and their element matrices) from each owned node to the
+  // right and upwards
+  std::vector<std::vector<std::int32_t>> bars;
+  std::vector<std::vector<double>> Ke;
+  for (std::int64_t ix = x0; ix < x1; ++ix)
+  {
+    for (std::int64_t iy = 0; iy < ny; ++iy)
+    {
+      for (auto [dx, dy] : {std::array{1, 0}, std::array{0, 1},
+                            std::array{1, 1}, std::array{1, -1}})
+      {
+        if (ix + dx >= nx * size or iy + dy < 0 or iy + dy >= ny)
+          continue;
+        const double h = std::sqrt(double(dx * dx + dy * dy));
+        const std::array<double, 2> d = {dx / h, dy / h};
+        std::vector<double> K(16);
+        for (int i = 0; i < 2; ++i)
+          for (int a = 0; a < 2; ++a)
+            for (int j = 0; j < 2; ++j)
+              for (int b = 0; b < 2; ++b)
+                K[(2 * i + a) * 4 + 2 * j + b]
+                    = (i == j ? 1 : -1) * d[a] * d[b] / h;
+        bars.push_back({local(node(ix, iy)), local(node(ix + dx, iy + dy))});
+        Ke.push_back(std::move(K));
+      }
+    }
+  }
+
+  la::SparsityPattern p(comm, {map, map}, {2, 2});
+  for (auto& e : bars)
+    p.insert(e, e);
+  p.assemble();
+  la::MatrixCSR<double> A(p);
+  for (std::size_t e = 0; e < bars.size(); ++e)
+    A.add(Ke[e], bars[e], bars[e]);
+  for (std::int32_t i = 0; i < nx * ny; ++i)
+    A.add(std::vector{0.01, 0.0, 0.0, 0.01}, std::vector{i}, std::vector{i});
+  A.finalize();
+
+  // Rigid body modes
+  using V = la::Vector<double>;
+  std::vector<V> nullspace;
+  for (int m = 0; m < 3; ++m)
+    nullspace.emplace_back(map, 2);
+  for (std::int64_t ix = x0; ix < x1; ++ix)
+  {
+    for (std::int64_t iy = 0; iy < ny; ++iy)
+    {
+      const std::int32_t i = local(node(ix, iy));
+      nullspace[0].mutable_array()[2 * i] = 1;
+      nullspace[1].mutable_array()[2 * i + 1] = 1;
+      nullspace[2].mutable_array()[2 * i] = -double(iy);
+      nullspace[2].mutable_array()[2 * i + 1] = double(ix);
+    }
+  }
+
+  auto op = [&A](V& x, V& y) { A.mult(x, y); };
+  V b(map, 2);
+  for (std::int32_t i = 0; i < 2 * nx * ny; ++i)
+    b.mutable_array()[i] = std::sin(double(2 * rank * nx * ny + i));
+
+  la::amg::Parameters params;
+  params.coarse_size = 20;
+  la::amg::SmoothedAggregation<double> amg(
+      A, std::span<const V>(nullspace), params);
+  CHECK(amg.num_levels() > 1);
+  V x(map, 2);
+  la::solvers::CG<V> cg(b, 1e-10);
+  CHECK(cg.solve(op, x, b, amg) < 40);
+
+  // Check that || b - A x || is small on the owned rows
+  V r(map, 2);
+  A.mult(x, r);
+  for (std::int32_t i = 0; i < 2 * nx * ny; ++i)
+    REQUIRE(r.array()[i] == Approx(b.array()[i]).margin(1e-6));
+}
+
 } // namespace
 
 TEST_CASE("Linear Algebra CSR Matrix", "[la_matrix]")
 {
   CHECK_NOTHROW(test_matrix());
+  CHECK_NOTHROW(test_sparsity_two_pass());
+  CHECK_NOTHROW(test_sparsity_form_diagonal());
   CHECK_NOTHROW(test_matrix_apply());
+  CHECK_NOTHROW(test_sparsity_cache());
+  CHECK_NOTHROW(test_matrix_sell_padding());
+  CHECK_NOTHROW(test_matrix_blocked());
+  CHECK_NOTHROW(test_matrix_blocked_distributed());
+  CHECK_NOTHROW(test_matrix_petsc_wrapper());
+  CHECK_NOTHROW(test_matrix_product());
+  CHECK_NOTHROW(test_matrix_product_distributed());
+  CHECK_NOTHROW(test_solver_cg<double>());
+  CHECK_NOTHROW(test_solver_cg<std::complex<double>>());
+  CHECK_NOTHROW(test_solver_pipelined_cg<double>());
+  CHECK_NOTHROW(test_solver_pipelined_cg<std::complex<double>>());
+  CHECK_NOTHROW(test_solver_fgmres<double>());
+  CHECK_NOTHROW(test_solver_fgmres<std::complex<double>>());
+  CHECK_NOTHROW(test_solver_bicgstab<double>());
+  CHECK_NOTHROW(test_solver_bicgstab<std::complex<double>>());
+  CHECK_NOTHROW(test_solver_minres<double>());
+  CHECK_NOTHROW(test_solver_minres<std::complex<double>>());
+  CHECK_NOTHROW(test_preconditioners());
+  CHECK_NOTHROW(test_preconditioners_blocked());
+  CHECK_NOTHROW(test_solver_amg());
+  CHECK_NOTHROW(test_matrix_amg_distributed());
+  CHECK_NOTHROW(test_matrix_amg_nullspace());
 }
@@ -9,7 +9,9 @@
 #include <catch2/catch.hpp>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/la/MultiVector.h>
 #include <dolfinx/la/Vector.h>
+#include <numeric>
 #include <xtensor/xtensor.hpp>
 
 using namespace dolfinx;
@@ -51,6 +53,160 @@ void test_vector()
   CHECK(la::norm(v, la::Norm::l2) == std::sqrt(sumn2));
   CHECK(la::inner_product(v, v) == sumn2);
   CHECK(la::norm(v, la::Norm::linf) == static_cast<T>(mpi_size - 1));
+
+  // Non-blocking inner products
+  la::Vector<T> w(index_map, 1);
+  std::fill(w.mutable_array().begin(), w.mutable_array().end(), 1.0);
+  T vv;
+  MPI_Request request = la::inner_product_begin(v, v, vv);
+  la::inner_product_end(request);
+  CHECK(vv == sumn2);
+
+  const std::array<std::array<const la::Vector<T>*, 2>, 2> pairs
+      = {{{&v, &v}, {&v, &w}}};
+  std::array<T, 2> dots;
+  request = la::inner_product_begin(
+      std::span<const std::array<const la::Vector<T>*, 2>>(pairs),
+      std::span<T>(dots));
+  la::inner_product_end(request);
+  CHECK(dots[0] == sumn2);
+  CHECK(dots[1] == static_cast<T>(size_local * (mpi_size - 1) * mpi_size / 2));
+
+  // Multi-vector with columns (1, v): ghost update and block inner
+  // product
+  la::MultiVector<T> X(index_map, 1, 2);
+  X.set_column(0, w);
+  X.set_column(1, v);
+  X.scatter_fwd();
+  la::Vector<T> u(index_map, 1);
+  X.get_column(1, u);
+  const T ghost_owner = (mpi_rank + 1) % mpi_size;
+  for (int i = 0; i < num_ghosts; ++i)
+    CHECK(u.array()[size_local + i] == ghost_owner);
+
+  // Repeated ghost updates with persistent requests
+  u.set_persistent_requests(true);
+  for (int k = 1; k < 3; ++k)
+  {
+    std::fill(u.mutable_array().begin(), u.mutable_array().end(),
+              T(k * mpi_rank));
+    u.scatter_fwd();
+    for (int i = 0; i < num_ghosts; ++i)
+      CHECK(u.array()[size_local + i] == T(k) * ghost_owner);
+  }
+
+  const std::vector<T> G = la::inner_product(X, X);
+  CHECK(G.size() == 4);
+  CHECK(G[0] == static_cast<T>(mpi_size * size_local));
+  CHECK(G[1] == dots[1]);
+  CHECK(G[2] == dots[1]);
+  CHECK(G[3] == sumn2);
+
+  // Fused operations: u = 2 v - w, u += v, (u, u), combined norms
+  la::waxpby(u, T(2), v, T(-1), w);
+  for (int i = 0; i < size_local; ++i)
+    CHECK(u.array()[i] == static_cast<T>(2 * mpi_rank - 1));
+  la::axpy(u, T(1), w);
+  CHECK(la::inner_product(u, u) == static_cast<T>(4 * sumn2));
+  CHECK(la::axpy_dot(u, T(-1), v, u) == sumn2);
+  CHECK(la::axpy_dot(u, T(1), w, w)
+        == dots[1] + static_cast<T>(mpi_size * size_local));
+
+  const std::array<const la::Vector<T>*, 2> vectors = {&v, &w};
+  const std::array<T, 2> alpha = {T(-1), T(2)};
+  la::maxpy(u, std::span<const T>(alpha),
+            std::span<const la::Vector<T>* const>(vectors));
+  for (int i = 0; i < size_local; ++i)
+    CHECK(u.array()[i] == T(3));
+
+  const auto n = la::norms(std::span<const la::Vector<T>* const>(vectors));
+  CHECK(n[0] == Approx(std::sqrt(sumn2)));
+  CHECK(n[1] == Approx(std::sqrt(mpi_size * size_local)));
+  CHECK(la::norms({&v, &w}, la::Norm::l2) == n);
+  const std::vector<const la::Vector<T>*> vectors_list = {&v, &w};
+  CHECK(la::norms(vectors_list) == n);
+
+  // Orthonormalize the vectors (1, v, v^2), then a linearly dependent
+  // set
+  std::vector<la::Vector<T>> basis(3, la::Vector<T>(index_map, 1));
+  la::MultiVector<T> X3(index_map, 1, 3);
+  for (std::size_t i = 0; i < v.array().size(); ++i)
+  {
+    const T vi = v.array()[i];
+    basis[0].mutable_array()[i] = 1.0;
+    basis[1].mutable_array()[i] = vi + T(i % 3);
+    basis[2].mutable_array()[i] = vi * vi + T(i % 5);
+    for (int j = 0; j < 3; ++j)
+      X3.mutable_array()[3 * i + j] = basis[j].array()[i];
+  }
+  CHECK(!la::is_orthonormal(std::span<const la::Vector<T>>(basis)));
+  la::orthonormalize(std::span<la::Vector<T>>(basis));
+  CHECK(la::is_orthonormal(std::span<const la::Vector<T>>(basis)));
+
+  la::orthonormalize(X3);
+  const std::vector<T> G3 = la::inner_product(X3, X3);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      CHECK(std::abs(G3[3 * i + j] - T(i == j)) < 1e-10);
+
+  // A nearly dependent vector, with an orthogonal component that is
+  // above the tolerance but too small to be resolved by a Gram matrix
+  basis[2] = la::Vector<T>(basis[0]);
+  for (std::size_t i = 0; i < v.array().size(); ++i)
+  {
+    basis[2].mutable_array()[i] += T(1.0e-10 * (i % 7));
+    for (int j = 0; j < 3; ++j)
+      X3.mutable_array()[3 * i + j] = basis[j].array()[i];
+  }
+  CHECK_NOTHROW(la::orthonormalize(std::span<la::Vector<T>>(basis)));
+  CHECK(la::is_orthonormal(std::span<const la::Vector<T>>(basis)));
+  CHECK_NOTHROW(la::orthonormalize(X3));
+  const std::vector<T> G3n = la::inner_product(X3, X3);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      CHECK(std::abs(G3n[3 * i + j] - T(i == j)) < 1e-10);
+
+  basis[2] = la::Vector<T>(basis[0]);
+  CHECK_THROWS(la::orthonormalize(std::span<la::Vector<T>>(basis)));
+}
+
+
+// Overlapping ghost updates of a vector and its copy
+void test_scatter_copies(common::Scatterer::type type, bool shared_memory)
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 10;
+
+  // Ghost the first entries of the next process
+  const int num_ghosts = mpi_size > 1 ? 3 : 0;
+  const int owner = (mpi_rank + 1) % mpi_size;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  std::iota(ghosts.begin(), ghosts.end(), owner * size_local);
+  const std::vector<int> ghost_owners(num_ghosts, owner);
+  const auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, ghost_owners);
+
+  la::Vector<double> x(index_map, 1, type, shared_memory);
+  la::Vector<double> y(x);
+  std::fill(x.mutable_array().begin(), x.mutable_array().end(), mpi_rank);
+  std::fill(y.mutable_array().begin(), y.mutable_array().end(),
+            mpi_rank + mpi_size);
+
+  // Complete the scatters in the opposite order to which they were
+  // started
+  for (int k = 0; k < 2; ++k)
+  {
+    x.scatter_fwd_begin();
+    y.scatter_fwd_begin();
+    y.scatter_fwd_end();
+    x.scatter_fwd_end();
+    for (int i = 0; i < num_ghosts; ++i)
+    {
+      CHECK(x.array()[size_local + i] == owner);
+      CHECK(y.array()[size_local + i] == owner + mpi_size);
+    }
+  }
 }
 
 } // namespace
@@ -60,3 +216,12 @@ TEMPLATE_TEST_CASE("Linear Algebra Vector", "[la_vector]", double,
 {
   CHECK_NOTHROW(test_vector<TestType>());
 }
+
+TEST_CASE("Overlapping scatters of copied vectors", "[la_vector_copy]")
+{
+  auto type = GENERATE(common::Scatterer::type::neighbor,
+                       common::Scatterer::type::p2p,
+                       common::Scatterer::type::rma);
+  auto shared_memory = GENERATE(false, true);
+  CHECK_NOTHROW(test_scatter_copies(type, shared_memory));
+}
@@ -367,6 +367,65 @@ def _assemble_matrix_mat(A: PETSc.Mat, a: form_types, bcs: typing.List[Dirichlet
     return A
 
 
+class MatrixAssemblerCOO:
+    """Assembler of a bilinear form into a PETSc matrix using the COO
+    interface of PETSc.
+
+    The (row, column) indices of all element matrices are registered
+    with the matrix once. Each assembly then sets all values in a
+    single call, which is well-suited to repeated assembly, e.g. in a
+    Newton solver. The matrix does not need to be assembled
+    (``A.assemble()``) after assembly.
+
+    Note:
+        Requires PETSc 3.16 or later.
+
+    """
+
+    def __init__(self, A: PETSc.Mat, a: FormMetaClass):
+        """Register the COO pattern of a bilinear form with a matrix.
+
+        Args:
+            A: The matrix, e.g. created by :func:`create_matrix`. Its
+                non-zero structure is replaced by the pattern of ``a``.
+            a: The bilinear form
+
+        """
+        self._cpp_object = _cpp.fem.petsc.MatrixAssemblerCOO(A, a)
+
+    def assemble(self, A: PETSc.Mat, a: FormMetaClass, bcs: typing.List[DirichletBCMetaClass] = [],
+                 constants=None, coeffs=None,
+                 mode: PETSc.InsertMode = PETSc.InsertMode.INSERT_VALUES) -> PETSc.Mat:
+        """Assemble a bilinear form into the matrix.
+
+        Args:
+            A: The matrix passed to the constructor
+            a: The bilinear form passed to the constructor, or a form
+                with the same spaces and integration domains
+            bcs: Boundary conditions. For boundary condition dofs the
+                row and column are zeroed. The diagonal entry is not
+                set.
+            constants: Packed constants of ``a`` (packed if not given)
+            coeffs: Packed coefficients of ``a`` (packed if not given)
+            mode: ``INSERT_VALUES`` to replace the matrix values or
+                ``ADD_VALUES`` to add to them
+
+        Returns:
+            The matrix ``A``
+
+        """
+        constants = _pack_constants(a) if constants is None else constants
+        coeffs = _pack_coefficients(a) if coeffs is None else coeffs
+        self._cpp_object.assemble(A, a, constants, coeffs, bcs, mode)
+        return A
+
+    @property
+    def size(self) -> int:
+        """Number of COO entries, i.e. the total size of all element
+        matrices"""
+        return self._cpp_object.size
+
+
 # FIXME: Revise this interface
 @functools.singledispatch
 def assemble_matrix_nest(a: typing.Any,
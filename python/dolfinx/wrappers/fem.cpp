@@ -697,6 +697,35 @@ void petsc_module(py::module& m)
       },
       py::arg("A"), py::arg("V"), py::arg("bcs"), py::arg("diagonal"));
 
+  // COO assembly. The insert mode is a petsc4py PETSc.InsertMode value.
+  py::class_<dolfinx::fem::petsc::MatrixAssemblerCOO>(
+      m, "MatrixAssemblerCOO",
+      "Assembler of a bilinear form into a PETSc Mat using the COO "
+      "interface")
+      .def(py::init<Mat, const dolfinx::fem::Form<PetscScalar>&>(),
+           py::arg("A"), py::arg("a"))
+      .def(
+          "assemble",
+          [](dolfinx::fem::petsc::MatrixAssemblerCOO& self, Mat A,
+             const dolfinx::fem::Form<PetscScalar>& a,
+             const py::array_t<PetscScalar, py::array::c_style>& constants,
+             const std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                            py::array_t<PetscScalar, py::array::c_style>>&
+                 coefficients,
+             const std::vector<std::shared_ptr<
+                 const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+             int mode)
+          {
+            self.assemble(A, a, std::span(constants.data(), constants.size()),
+                          py_to_cpp_coeffs(coefficients), bcs,
+                          static_cast<InsertMode>(mode));
+          },
+          py::arg("A"), py::arg("a"), py::arg("constants"), py::arg("coeffs"),
+          py::arg("bcs"), py::arg("mode") = static_cast<int>(INSERT_VALUES),
+          "Assemble a bilinear form into the matrix")
+      .def_property_readonly("size",
+                             &dolfinx::fem::petsc::MatrixAssemblerCOO::size);
+
   m.def(
       "discrete_gradient",
       [](const dolfinx::fem::FunctionSpace& V0,
@@ -857,6 +886,10 @@ void declare_form(py::module& m, const std::string& type)
                              &dolfinx::fem::Form<T>::integral_types)
       .def_property_readonly("needs_facet_permutations",
                              &dolfinx::fem::Form<T>::needs_facet_permutations)
+      .def_property(
+          "precompute_dof_transformations",
+          &dolfinx::fem::Form<T>::precompute_dof_transformations,
+          &dolfinx::fem::Form<T>::set_precompute_dof_transformations)
       .def(
           "domains",
           [](const dolfinx::fem::Form<T>& self, dolfinx::fem::IntegralType type,
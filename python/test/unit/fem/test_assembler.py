@@ -201,6 +201,48 @@ def test_assembly_bcs(mode):
     assert (f - b_bc).norm() == pytest.approx(0.0, rel=1e-12, abs=1e-12)
 
 
+@pytest.mark.skipif(PETSc.Sys.getVersion() < (3, 16, 0), reason="COO assembly requires PETSc 3.16")
+@pytest.mark.parametrize("mode", [GhostMode.none, GhostMode.shared_facet])
+def test_assembly_coo(mode):
+    """Compare COO assembly with assembly using MatSetValuesLocal"""
+    mesh = create_unit_square(MPI.COMM_WORLD, 8, 8, ghost_mode=mode)
+    V = VectorFunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    k = Function(FunctionSpace(mesh, ("Lagrange", 1)))
+    k.interpolate(lambda x: 1.0 + x[0] * x[1])
+    a = k * inner(u, v) * dx + inner(u, v) * ds
+    if mode == GhostMode.shared_facet:
+        a += inner(ufl.avg(u), ufl.avg(v)) * ufl.dS
+    a = form(a)
+
+    bdofs = locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0.0))
+    bc = dirichletbc(np.array([1.0, 2.0], dtype=PETSc.ScalarType), bdofs, V)
+
+    A = fem.petsc.create_matrix(a)
+    assembler = fem.petsc.MatrixAssemblerCOO(A, a)
+    for bcs in ([bc], []):
+        # Reference matrix. The bc diagonal is not set by the COO
+        # assembler.
+        A0 = assemble_matrix(a, bcs=bcs, diagonal=0.0)
+        A0.assemble()
+
+        # The assembler can be used repeatedly. Inserted values replace
+        # the matrix values, and the matrix is assembled by the
+        # assembler.
+        for i in range(2):
+            assembler.assemble(A, a, bcs)
+            assert A.assembled
+            assert (A - A0).norm() == pytest.approx(0.0, abs=1.0e-10)
+        A0.destroy()
+
+    # Add to the matrix assembled without bcs
+    assembler.assemble(A, a, mode=PETSc.InsertMode.ADD)
+    assert A.assembled
+    A0 = assemble_matrix(a)
+    A0.assemble()
+    assert (A - 2 * A0).norm() == pytest.approx(0.0, abs=1.0e-10)
+
+
 @pytest.mark.skip_in_parallel
 def test_assemble_manifold():
     """Test assembly of poisson problem on a mesh with topological